@@ -668,6 +668,7 @@ function packNuGet(outputPath: string, platforms: string[], configurations: stri
   // Public headers
   for (const file of [
     "compat.h",
+    "FileScriptStore.h",
     "Readme.md",
     "ScriptStore.h",
     "v8_api.h",
@@ -688,21 +689,39 @@ function packNuGet(outputPath: string, platforms: string[], configurations: stri
   // JSI ABI headers + sources. Consumers compile JsiAbiRuntime.cpp locally;
   // v8_jsi_config.h and v8_node_api_attach.h are the public C-stable surfaces
   // for runtime configuration and the dual-API attach seam respectively.
+  // V8DirectRuntime.h declares the opt-in same-CRT fast path;
+  // IndexedHostObject.h is the header-only integer-keyed host object extension;
+  // PreparedCall.h is the header-only repeated-call helper;
+  // ScriptStoreRuntime.h evaluates scripts by URL from a ScriptStore;
+  // AsyncPrepareRuntime.h prepares scripts off the JS thread;
+  // AbiRuntimeArgs.h and AbiRuntimeInterfaces.h are internal glue
+  // JsiAbiRuntime.cpp shares with the direct runtime;
+  // StartupCompleteRuntime.h signals the end of app startup.
   for (const file of [
     "jsi_abi.h",
     "jsi_abi_helpers.h",
     "JsiAbiRuntime.h",
     "JsiAbiRuntime.cpp",
+    "AbiRuntimeArgs.h",
+    "AbiRuntimeInterfaces.h",
+    "AsyncPrepareRuntime.h",
+    "IndexedHostObject.h",
+    "PreparedCall.h",
+    "ScriptStoreRuntime.h",
+    "StartupCompleteRuntime.h",
+    "V8DirectRuntime.h",
     "v8_jsi_config.h",
     "v8_node_api_attach.h",
   ]) {
     copyFile(file, path.join(srcDir, "jsi_abi"), jsiAbiDir);
   }
 
-  // Public consumer-side TU. Holds makeV8Runtime + the V8ScriptCache and
-  // V8TaskRunner adapters. Compiled by the consumer via the .targets
+  // Public consumer-side TU. Holds makeV8Runtime + the V8ScriptCache,
+  // V8ScriptStore and V8TaskRunner adapters. Compiled by the consumer via the .targets
   // file's <ClCompile> include.
   copyFile("V8JsiRuntime.cpp", path.join(srcDir, "public"), jsiPublicDir);
+  // Optional file-backed MappedFileBuffer and FilePreparedScriptStore.
+  copyFile("FileScriptStore.cpp", path.join(srcDir, "public"), jsiPublicDir);
 
   // Node-API headers
   for (const file of [
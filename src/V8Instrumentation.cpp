@@ -8,7 +8,8 @@
 
 namespace v8runtime {
 
-V8Instrumentation::V8Instrumentation(v8::Isolate *isolate) : isolate_(isolate) {}
+V8Instrumentation::V8Instrumentation(v8::Isolate *isolate, HeapInfoExtension heapInfoExtension)
+    : isolate_(isolate), heapInfoExtension_(std::move(heapInfoExtension)) {}
 
 std::string V8Instrumentation::getRecordedGCStats() {
   v8::HeapStatistics heapStats;
@@ -54,6 +55,10 @@ std::unordered_map<std::string, int64_t> V8Instrumentation::getHeapInfo(bool /*i
   result["numberOfNativeContexts"] = heapStats.number_of_native_contexts();
   result["numberOfDetachedContexts"] = heapStats.number_of_detached_contexts();
 
+  if (heapInfoExtension_) {
+    heapInfoExtension_(result);
+  }
+
   return result;
 }
 
@@ -3,11 +3,16 @@
 #include <jsi/instrumentation.h>
 #include <v8.h>
 
+#include <functional>
+
 namespace v8runtime {
 
 class V8Instrumentation : public facebook::jsi::Instrumentation {
  public:
-  explicit V8Instrumentation(v8::Isolate *isolate);
+  // Lets the owning runtime add its own counters to getHeapInfo.
+  using HeapInfoExtension = std::function<void(std::unordered_map<std::string, int64_t> &)>;
+
+  explicit V8Instrumentation(v8::Isolate *isolate, HeapInfoExtension heapInfoExtension = nullptr);
 
   std::string getRecordedGCStats() override;
   std::unordered_map<std::string, int64_t> getHeapInfo(bool includeExpensive) override;
@@ -35,6 +40,7 @@ class V8Instrumentation : public facebook::jsi::Instrumentation {
 
  private:
   v8::Isolate *isolate_;
+  HeapInfoExtension heapInfoExtension_;
 };
 
 } // namespace v8runtime
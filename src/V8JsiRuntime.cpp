@@ -6,10 +6,12 @@
 #include "v8.h"
 
 #include "IsolateData.h"
-#include "MurmurHash.h"
+#include "jsi_abi/StringDataView.h"
 #include "node-api/js_native_api.h"
 #include "node-api/js_native_api_v8.h"
 #include "public/ScriptStore.h"
+#include "v8_source_hash.h"
+#include "v8_string.h"
 
 #include "node-api/util-inl.h"
 
@@ -25,6 +27,10 @@ using namespace facebook;
 
 namespace v8runtime {
 
+// Unqualified jsi:: in this file means facebook::jsi; ::jsi is the namespace of
+// the engine-agnostic ABI extensions (IndexedHostObject.h).
+namespace jsi = facebook::jsi;
+
 thread_local uint16_t V8Runtime::tls_isolate_usage_counter_ = 0;
 
 struct ContextEmbedderIndex {
@@ -39,11 +45,7 @@ struct ContextEmbedderIndex {
 
 // String utilities
 std::string JSStringToSTLString(v8::Isolate *isolate, v8::Local<v8::String> string) {
-  int utfLen = string->Utf8Length(isolate);
-  std::string result;
-  result.resize(utfLen);
-  string->WriteUtf8(isolate, &result[0], utfLen);
-  return result;
+  return v8rt::toUtf8String(isolate, string);
 }
 
 std::u16string JSStringToStlU16String(v8::Isolate *isolate, v8::Local<v8::String> string) {
@@ -65,12 +67,27 @@ const char *ToCString(const v8::String::Utf8Value &value) {
 /*static*/ void *const V8Runtime::RuntimeContextTagPtr =
     const_cast<void *>(static_cast<const void *>(&V8Runtime::RuntimeContextTag));
 
-void V8Runtime::AddHostObjectLifetimeTracker(std::shared_ptr<HostObjectLifetimeTracker> hostObjectLifetimeTracker) {
-  // Note that we are letting the list grow in definitely as of now.. The list
-  // gets cleaned up when the runtime is teared down.
-  // TODO :: We should remove entries from the list as the objects are garbage
-  // collected.
-  host_object_lifetime_tracker_list_.push_back(hostObjectLifetimeTracker);
+void V8Runtime::AddHostObjectLifetimeTracker(std::unique_ptr<HostObjectLifetimeTracker> hostObjectLifetimeTracker) {
+  HostObjectLifetimeTracker *tracker = hostObjectLifetimeTracker.release();
+  tracker->next_ = host_object_lifetime_tracker_head_;
+  if (host_object_lifetime_tracker_head_) {
+    host_object_lifetime_tracker_head_->prev_ = tracker;
+  }
+  host_object_lifetime_tracker_head_ = tracker;
+  ++host_object_lifetime_tracker_count_;
+}
+
+void V8Runtime::RemoveHostObjectLifetimeTracker(HostObjectLifetimeTracker *hostObjectLifetimeTracker) noexcept {
+  if (hostObjectLifetimeTracker->prev_) {
+    hostObjectLifetimeTracker->prev_->next_ = hostObjectLifetimeTracker->next_;
+  } else {
+    host_object_lifetime_tracker_head_ = hostObjectLifetimeTracker->next_;
+  }
+  if (hostObjectLifetimeTracker->next_) {
+    hostObjectLifetimeTracker->next_->prev_ = hostObjectLifetimeTracker->prev_;
+  }
+  --host_object_lifetime_tracker_count_;
+  delete hostObjectLifetimeTracker;
 }
 
 /*static */ void V8Runtime::OnMessage(v8::Local<v8::Message> message, v8::Local<v8::Value> error) {
@@ -330,9 +347,14 @@ void V8Runtime::createHostObjectConstructorPerContext() {
       HostObjectProxy::Get, HostObjectProxy::Set, nullptr, nullptr, HostObjectProxy::Enumerator));
 
   // V8 distinguishes between named properties (strings and symbols) and indexed properties (number)
-  // Note that we're not passing an Enumerator here, otherwise we'd be double-counting since JSI doesn't make the
-  // distinction
-  hostObjectTemplate->SetIndexedPropertyHandler(HostObjectProxy::GetIndexed, HostObjectProxy::SetIndexed);
+  // The indexed Enumerator only reports indices of IndexedHostObjects; plain host objects list their numeric keys
+  // through getPropertyNames, so reporting them here as well would double-count.
+  hostObjectTemplate->SetIndexedPropertyHandler(
+      HostObjectProxy::GetIndexed,
+      HostObjectProxy::SetIndexed,
+      nullptr,
+      nullptr,
+      HostObjectProxy::IndexedEnumerator);
   hostObjectTemplate->SetInternalFieldCount(1);
   host_object_constructor_.Reset(
       GetIsolate(), constructorForHostObjectTemplate->GetFunction(GetContextLocal()).ToLocalChecked());
@@ -395,7 +417,14 @@ V8Runtime::V8Runtime(V8RuntimeArgs &&args) : args_(std::move(args)) {
     CreateNewIsolate();
   }
 
-  instrumentation_ = std::make_unique<V8Instrumentation>(isolate_);
+  instrumentation_ = std::make_unique<V8Instrumentation>(
+      isolate_, [this](std::unordered_map<std::string, int64_t> &heapInfo) {
+        heapInfo["hostObjectTrackers"] = static_cast<int64_t>(host_object_lifetime_tracker_count_);
+        heapInfo["propNameCacheHits"] = static_cast<int64_t>(prop_name_intern_table_.hits());
+        heapInfo["propNameCacheMisses"] = static_cast<int64_t>(prop_name_intern_table_.misses());
+        heapInfo["externalMemoryBytes"] = external_memory_table_.totalBytes();
+        heapInfo["externalMemoryObjects"] = static_cast<int64_t>(external_memory_table_.trackedObjects());
+      });
 
   if (args_.flags.explicitMicrotaskPolicy) {
     isolate_->SetMicrotasksPolicy(v8::MicrotasksPolicy::kExplicit);
@@ -455,13 +484,21 @@ V8Runtime::~V8Runtime() {
 #endif
 
   host_object_constructor_.Reset();
+  prop_name_intern_table_.clear();
+  external_memory_table_.clear(isolate_);
+  for (TracedFunctionName &entry : traced_function_names_) {
+    entry.function.Reset();
+  }
   context_.Reset();
 
-  for (std::shared_ptr<HostObjectLifetimeTracker> hostObjectLifetimeTracker : host_object_lifetime_tracker_list_) {
-    hostObjectLifetimeTracker->ResetHostObject(false /*isGC*/);
+  // Only trackers for objects that are still alive remain; collected ones
+  // unlinked themselves from their weak callbacks.
+  while (HostObjectLifetimeTracker *tracker = host_object_lifetime_tracker_head_) {
+    host_object_lifetime_tracker_head_ = tracker->Next();
+    tracker->ResetHostObject(false /*isGC*/);
+    delete tracker;
   }
-
-  host_object_lifetime_tracker_list_.clear();
+  host_object_lifetime_tracker_count_ = 0;
 
   GetAndClearLastUnhandledPromiseRejection();
 
@@ -490,24 +527,32 @@ V8Runtime::~V8Runtime() {
 v8::Local<v8::String> V8Runtime::loadJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, std::uint64_t &hash) {
   v8::EscapableHandleScope handle_scope(GetIsolate());
 
-  bool isAscii = murmurhash(buffer->data(), buffer->size(), hash);
+  std::optional<bool> isAscii;
+  for (const HashedBuffer &hashed : hashed_buffers_) {
+    if (hashed.buffer.lock() == buffer) {
+      hash = hashed.hash;
+      isAscii = hashed.isAscii;
+      break;
+    }
+  }
+  if (!isAscii) {
+    isAscii = v8rt::hashSource(buffer->data(), buffer->size(), hash, V8PlatformHolder::platform());
+    hashed_buffers_[next_hashed_buffer_] = {buffer, hash, *isAscii};
+    next_hashed_buffer_ = (next_hashed_buffer_ + 1) % hashed_buffers_.size();
+  }
 
+  // ASCII sources are wrapped in place and keep the buffer alive until the string is collected; localized
+  // (non-ASCII) sources are transcoded once into an off-heap Latin-1 or UTF-16 external string.
   v8::Local<v8::String> sourceV8String;
-  if (isAscii) {
-    // This pointer is cleaned up by the platform
-    ExternalOwningOneByteStringResource *external_string_resource = new ExternalOwningOneByteStringResource(buffer);
-    if (!v8::String::NewExternalOneByte(GetIsolate(), external_string_resource).ToLocal(&sourceV8String)) {
-      std::abort();
-    }
-  } else {
-    if (!v8::String::NewFromUtf8(
-             GetIsolate(),
-             reinterpret_cast<const char *>(buffer->data()),
-             v8::NewStringType::kNormal,
-             static_cast<int>(buffer->size()))
-             .ToLocal(&sourceV8String)) {
-      std::abort();
-    }
+  if (!v8rt::newExternalSourceString(
+           GetIsolate(),
+           reinterpret_cast<const char *>(buffer->data()),
+           buffer->size(),
+           [](void *owner) { delete static_cast<std::shared_ptr<const jsi::Buffer> *>(owner); },
+           new std::shared_ptr<const jsi::Buffer>(buffer),
+           isAscii)
+           .ToLocal(&sourceV8String)) {
+    std::abort();
   }
 
   return handle_scope.Escape(sourceV8String);
@@ -910,6 +955,15 @@ jsi::Object V8Runtime::global() {
   return make<jsi::Object>(V8ObjectValue::make(GetIsolate(), GetContextLocal()->Global()));
 }
 
+#if JSI_VERSION >= 20
+jsi::ICast *V8Runtime::castInterface(const jsi::UUID &interfaceUUID) {
+  if (interfaceUUID == ::jsi::abi::IIndexedHostObjectFactory::uuid) {
+    return &indexed_host_object_factory_;
+  }
+  return Runtime::castInterface(interfaceUUID);
+}
+#endif
+
 std::string V8Runtime::description() {
   if (desc_.empty()) {
     desc_ = std::string("<V8Runtime>");
@@ -983,11 +1037,17 @@ std::string V8Runtime::symbolToString(const jsi::Symbol &sym) {
 jsi::PropNameID V8Runtime::createPropNameIDFromAscii(const char *str, size_t length) {
   IsolateLocker isolate_locker(this);
   v8::Local<v8::String> v8String;
-  if (!v8::String::NewFromOneByte(
-           GetIsolate(),
-           reinterpret_cast<uint8_t *>(const_cast<char *>(str)),
-           v8::NewStringType::kNormal,
-           static_cast<int>(length))
+  if (!prop_name_intern_table_
+           .get(
+               GetIsolate(),
+               std::string_view(str, length),
+               [](v8::Isolate *isolate, std::string_view name) {
+                 return v8::String::NewFromOneByte(
+                     isolate,
+                     reinterpret_cast<const uint8_t *>(name.data()),
+                     v8::NewStringType::kInternalized,
+                     static_cast<int>(name.size()));
+               })
            .ToLocal(&v8String)) {
     std::stringstream strstream;
     strstream << "Unable to create property id: " << str;
@@ -1001,11 +1061,13 @@ jsi::PropNameID V8Runtime::createPropNameIDFromAscii(const char *str, size_t len
 jsi::PropNameID V8Runtime::createPropNameIDFromUtf8(const uint8_t *utf8, size_t length) {
   IsolateLocker isolate_locker(this);
   v8::Local<v8::String> v8String;
-  if (!v8::String::NewFromUtf8(
-           GetIsolate(),
-           reinterpret_cast<const char *>(utf8),
-           v8::NewStringType::kInternalized,
-           static_cast<int>(length))
+  if (!prop_name_intern_table_
+           .get(
+               GetIsolate(),
+               std::string_view(reinterpret_cast<const char *>(utf8), length),
+               [](v8::Isolate *isolate, std::string_view name) {
+                 return v8rt::newStringFromUtf8(isolate, name.data(), name.size(), v8::NewStringType::kInternalized);
+               })
            .ToLocal(&v8String)) {
     std::stringstream strstream;
     strstream << "Unable to create property id: " << utf8;
@@ -1063,9 +1125,7 @@ jsi::String V8Runtime::createStringFromAscii(const char *str, size_t length) {
 jsi::String V8Runtime::createStringFromUtf8(const uint8_t *str, size_t length) {
   IsolateLocker isolate_locker(this);
   v8::Local<v8::String> v8string;
-  if (!v8::String::NewFromUtf8(
-           GetIsolate(), reinterpret_cast<const char *>(str), v8::NewStringType::kNormal, static_cast<int>(length))
-           .ToLocal(&v8string)) {
+  if (!v8rt::newStringFromUtf8(GetIsolate(), reinterpret_cast<const char *>(str), length).ToLocal(&v8string)) {
     throw jsi::JSError(*this, "V8 string creation failed.");
   }
 
@@ -1102,8 +1162,14 @@ jsi::Object V8Runtime::createObject() {
 }
 
 jsi::Object V8Runtime::createObject(std::shared_ptr<jsi::HostObject> hostobject) {
+  return createHostObject(std::move(hostobject), nullptr);
+}
+
+jsi::Object V8Runtime::createHostObject(
+    std::shared_ptr<jsi::HostObject> hostobject,
+    ::jsi::abi::IndexedHostObject *indexed) {
   IsolateLocker isolate_locker(this);
-  HostObjectProxy *hostObjectProxy = new HostObjectProxy(*this, hostobject);
+  HostObjectProxy *hostObjectProxy = new HostObjectProxy(*this, hostobject, indexed);
   v8::Local<v8::Object> newObject;
   if (!host_object_constructor_.Get(GetIsolate())->NewInstance(GetContextLocal()).ToLocal(&newObject)) {
     throw jsi::JSError(*this, "HostObject construction failed!!");
@@ -1112,7 +1178,7 @@ jsi::Object V8Runtime::createObject(std::shared_ptr<jsi::HostObject> hostobject)
   newObject->SetInternalField(
       0, v8::Local<v8::External>::New(GetIsolate(), v8::External::New(GetIsolate(), hostObjectProxy)));
 
-  AddHostObjectLifetimeTracker(std::make_shared<HostObjectLifetimeTracker>(*this, newObject, hostObjectProxy));
+  AddHostObjectLifetimeTracker(std::make_unique<HostObjectLifetimeTracker>(*this, newObject, hostObjectProxy));
 
   return make<jsi::Object>(V8ObjectValue::make(GetIsolate(), newObject));
 }
@@ -1214,9 +1280,9 @@ bool V8Runtime::isHostObject(const jsi::Object &obj) const {
 
   HostObjectProxy *hostObjectProxy = reinterpret_cast<HostObjectProxy *>(internalField->Value());
 
-  for (const std::shared_ptr<HostObjectLifetimeTracker> &hostObjectLifetimeTracker :
-       host_object_lifetime_tracker_list_) {
-    if (hostObjectLifetimeTracker->IsEqual(hostObjectProxy)) {
+  for (const HostObjectLifetimeTracker *tracker = host_object_lifetime_tracker_head_; tracker;
+       tracker = tracker->Next()) {
+    if (tracker->IsEqual(hostObjectProxy)) {
       return true;
     }
   }
@@ -1299,7 +1365,7 @@ jsi::Function V8Runtime::createFunctionFromHostFunction(
 
   newFunction->SetName(v8::Local<v8::String>::Cast(valueRef(name)));
 
-  AddHostObjectLifetimeTracker(std::make_shared<HostObjectLifetimeTracker>(*this, newFunction, hostFunctionProxy));
+  AddHostObjectLifetimeTracker(std::make_unique<HostObjectLifetimeTracker>(*this, newFunction, hostFunctionProxy));
 
   return make<jsi::Object>(V8ObjectValue::make(GetIsolate(), newFunction)).getFunction(*this);
 }
@@ -1346,16 +1412,58 @@ std::string getFunctionName(v8::Isolate *isolate, v8::Local<v8::Function> func)
 
   return functionNameStr;
 }
+
+// Argument array for calls into JS. Inline for up to kInlineArgs arguments, which covers nearly all calls.
+class LocalArgv {
+ public:
+  static constexpr size_t kInlineArgs = 8;
+
+  explicit LocalArgv(size_t count) {
+    if (count > kInlineArgs) {
+      heap_ = std::make_unique<v8::Local<v8::Value>[]>(count);
+      data_ = heap_.get();
+    }
+  }
+
+  LocalArgv(const LocalArgv &) = delete;
+  LocalArgv &operator=(const LocalArgv &) = delete;
+
+  v8::Local<v8::Value> &operator[](size_t index) {
+    return data_[index];
+  }
+
+  v8::Local<v8::Value> *data() {
+    return data_;
+  }
+
+ private:
+  v8::Local<v8::Value> inline_[kInlineArgs];
+  std::unique_ptr<v8::Local<v8::Value>[]> heap_;
+  v8::Local<v8::Value> *data_{inline_};
+};
 } // namespace
 
+const std::string &V8Runtime::GetTracedFunctionName(v8::Local<v8::Function> func) {
+  TracedFunctionName &entry = traced_function_names_[func->GetIdentityHash() % traced_function_names_.size()];
+  if (entry.function.IsEmpty() || entry.function != func) {
+    entry.name = getFunctionName(GetIsolate(), func);
+    entry.function.Reset(GetIsolate(), func);
+    entry.function.SetWeak();
+  }
+  return entry.name;
+}
+
 jsi::Value
 V8Runtime::call(const jsi::Function &jsiFunc, const jsi::Value &jsThis, const jsi::Value *args, size_t count) {
   IsolateLocker isolate_locker(this);
   v8::Local<v8::Function> func = v8::Local<v8::Function>::Cast(objectRef(jsiFunc));
 
-  // TODO: This may be a bit costly when there are large number of JS function
-  // calls from native. Evaluate !
-  std::string functionName = getFunctionName(GetIsolate(), func);
+  // Resolving the name takes several V8 lookups and a UTF-8 copy, so only do it for an active trace session.
+  // Copied because a nested call may reuse the cache slot.
+  std::string functionName;
+  if (TRACEV8RUNTIME_ENABLED()) {
+    functionName = GetTracedFunctionName(func);
+  }
 
   thread_local static uint8_t callCookie = 0;
   if (callCookie > 0) {
@@ -1369,9 +1477,9 @@ V8Runtime::call(const jsi::Function &jsiFunc, const jsi::Value &jsThis, const js
   TRACEV8RUNTIME_VERBOSE(
       "CallFunction", TraceLoggingString(functionName.c_str(), "name"), TraceLoggingString("start", "op"));
 
-  std::vector<v8::Local<v8::Value>> argv;
+  LocalArgv argv(count);
   for (size_t i = 0; i < count; i++) {
-    argv.push_back(valueReference(args[i]));
+    argv[i] = valueReference(args[i]);
   }
 
   v8::TryCatch trycatch(GetIsolate());
@@ -1399,15 +1507,16 @@ jsi::Value V8Runtime::callAsConstructor(const jsi::Function &jsiFunc, const jsi:
   IsolateLocker isolate_locker(this);
   v8::Local<v8::Function> func = v8::Local<v8::Function>::Cast(objectRef(jsiFunc));
 
-  // TODO: This may be a bit costly when there are large number of JS function
-  // calls from native. Evaluate !
-  std::string functionName = getFunctionName(GetIsolate(), func);
+  std::string functionName;
+  if (TRACEV8RUNTIME_ENABLED()) {
+    functionName = GetTracedFunctionName(func);
+  }
   TRACEV8RUNTIME_VERBOSE(
       "CallConstructor", TraceLoggingString(functionName.c_str(), "name"), TraceLoggingString("start", "op"));
 
-  std::vector<v8::Local<v8::Value>> argv;
+  LocalArgv argv(count);
   for (size_t i = 0; i < count; i++) {
-    argv.push_back(valueReference(args[i]));
+    argv[i] = valueReference(args[i]);
   }
 
   v8::TryCatch trycatch(GetIsolate());
@@ -1467,7 +1576,9 @@ jsi::Value V8Runtime::getPrototypeOf(const jsi::Object &object) {
 
 #if JSI_VERSION >= 11
 void V8Runtime::setExternalMemoryPressure(const jsi::Object &obj, size_t amount) {
-  // TODO: implement this
+  IsolateLocker isolate_locker(this);
+  if (!external_memory_table_.set(isolate_, GetContextLocal(), objectRef(obj), amount))
+    throw jsi::JSError(*this, "V8Runtime::setExternalMemoryPressure failed.");
 }
 #endif
 
@@ -1488,14 +1599,20 @@ void V8Runtime::getStringData(
     const jsi::String &str,
     void *ctx,
     void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
-  return Runtime::getStringData(str, ctx, cb);
+  IsolateLocker isolate_locker(this);
+  v8rt_internal::visitStringData(
+      GetIsolate(), stringRef(str), [&](bool ascii, const void *data, size_t num) { cb(ctx, ascii, data, num); });
 }
 
 void V8Runtime::getPropNameIdData(
     const jsi::PropNameID &sym,
     void *ctx,
     void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
-  return Runtime::getPropNameIdData(sym, ctx, cb);
+  IsolateLocker isolate_locker(this);
+  v8rt_internal::visitStringData(
+      GetIsolate(),
+      v8rt_internal::propNameString(GetIsolate(), valueRef(sym)),
+      [&](bool ascii, const void *data, size_t num) { cb(ctx, ascii, data, num); });
 }
 #endif
 
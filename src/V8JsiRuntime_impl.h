@@ -6,6 +6,9 @@
 #include "node-api/js_runtime_api.h"
 #include "public/V8JsiRuntime.h"
 #include "public/compat.h"
+#include "jsi_abi/IndexedHostObject.h"
+#include "jsi_abi/ExternalMemoryTable.h"
+#include "jsi_abi/PropNameInternTable.h"
 
 #include "V8Windows.h"
 #include "libplatform/libplatform.h"
@@ -16,6 +19,7 @@
 #include "inspector/inspector_agent.h"
 #endif
 
+#include <array>
 #include <atomic>
 #include <cstdlib>
 #include <iostream>
@@ -68,6 +72,11 @@ class V8PlatformHolder {
     platform_s_ = nullptr;
   }
 
+  static v8::Platform *platform() {
+    std::lock_guard<std::mutex> guard(mutex_s_);
+    return platform_s_.get();
+  }
+
   V8PlatformHolder() = delete;
   V8PlatformHolder(const V8PlatformHolder &) = delete;
   V8PlatformHolder &operator=(const V8PlatformHolder &) = delete;
@@ -193,11 +202,19 @@ class V8Runtime : public facebook::jsi::Runtime {
     return *instrumentation_;
   }
 
+#if JSI_VERSION >= 20
+  facebook::jsi::ICast *castInterface(const facebook::jsi::UUID &interfaceUUID) override;
+#endif
+
  private:
   struct IHostProxy {
     virtual void destroy() = 0;
   };
 
+  // Tracks one host object or host function until it is garbage collected.
+  // Trackers form an intrusive doubly linked list owned by the runtime, so the
+  // weak callback unlinks and frees its tracker in O(1) and the list only ever
+  // holds live objects.
   class HostObjectLifetimeTracker {
    public:
     void ResetHostObject(bool isGC /*whether the call is coming from GC*/) {
@@ -210,7 +227,7 @@ class V8Runtime : public facebook::jsi::Runtime {
     }
 
     HostObjectLifetimeTracker(V8Runtime &runtime, v8::Local<v8::Object> obj, IHostProxy *hostProxy)
-        : hostProxy_(hostProxy) {
+        : runtime_(runtime), hostProxy_(hostProxy) {
       objectTracker_.Reset(runtime.GetIsolate(), obj);
       objectTracker_.SetWeak(this, HostObjectLifetimeTracker::Destroyed, v8::WeakCallbackType::kParameter);
     }
@@ -224,14 +241,25 @@ class V8Runtime : public facebook::jsi::Runtime {
       return hostProxy_ == hostProxy;
     }
 
+    HostObjectLifetimeTracker *Next() const noexcept {
+      return next_;
+    }
+
    private:
+    friend class V8Runtime;
+
+    V8Runtime &runtime_;
     v8::Global<v8::Object> objectTracker_;
     std::atomic<bool> isReset_{false};
     IHostProxy *hostProxy_;
+    HostObjectLifetimeTracker *prev_{nullptr};
+    HostObjectLifetimeTracker *next_{nullptr};
 
     static void Destroyed(const v8::WeakCallbackInfo<HostObjectLifetimeTracker> &data) {
       v8::HandleScope handle_scope(v8::Isolate::GetCurrent());
-      data.GetParameter()->ResetHostObject(true /*isGC*/);
+      HostObjectLifetimeTracker *tracker = data.GetParameter();
+      tracker->ResetHostObject(true /*isGC*/);
+      tracker->runtime_.RemoveHostObjectLifetimeTracker(tracker);
     }
   };
 
@@ -342,9 +370,35 @@ class V8Runtime : public facebook::jsi::Runtime {
       }
     }
 
+    // Translates the in-flight exception of an indexed accessor into a JS exception.
+    static void RethrowIndexedException(V8Runtime &runtime, v8::Isolate *isolate) {
+      try {
+        throw;
+      } catch (const facebook::jsi::JSError &error) {
+        isolate->ThrowException(runtime.valueReference(error.value()));
+      } catch (const std::exception &ex) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, ex.what(), v8::NewStringType::kNormal).ToLocalChecked()));
+      } catch (...) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "<Unknown exception in host function callback>")));
+      }
+    }
+
     static void GetIndexed(uint32_t index, const v8::PropertyCallbackInfo<v8::Value> &info) {
+      HostObjectProxy *hostObjectProxy = GetHostObjectProxy(info);
+      V8Runtime &runtime = hostObjectProxy->runtime_;
+      if (hostObjectProxy->indexed_) {
+        try {
+          info.GetReturnValue().Set(runtime.valueReference(hostObjectProxy->indexed_->getIndex(runtime, index)));
+        } catch (...) {
+          info.GetReturnValue().Set(v8::Undefined(info.GetIsolate()));
+          RethrowIndexedException(runtime, info.GetIsolate());
+        }
+        return;
+      }
+
       std::string propName = std::to_string(index);
-      V8Runtime &runtime = GetHostObjectProxy(info)->runtime_;
       GetInternal(
           facebook::jsi::PropNameID::forString(runtime, facebook::jsi::String::createFromUtf8(runtime, propName)),
           info);
@@ -372,8 +426,18 @@ class V8Runtime : public facebook::jsi::Runtime {
 
     static void
     SetIndexed(uint32_t index, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<v8::Value> &info) {
+      HostObjectProxy *hostObjectProxy = GetHostObjectProxy(info);
+      V8Runtime &runtime = hostObjectProxy->runtime_;
+      if (hostObjectProxy->indexed_) {
+        try {
+          hostObjectProxy->indexed_->setIndex(runtime, index, runtime.createValue(value));
+        } catch (...) {
+          RethrowIndexedException(runtime, info.GetIsolate());
+        }
+        return;
+      }
+
       std::string propName = std::to_string(index);
-      V8Runtime &runtime = GetHostObjectProxy(info)->runtime_;
       SetInternal(
           facebook::jsi::PropNameID::forString(runtime, facebook::jsi::String::createFromUtf8(runtime, propName)),
           value,
@@ -406,8 +470,32 @@ class V8Runtime : public facebook::jsi::Runtime {
       }
     }
 
-    HostObjectProxy(V8Runtime &rt, const std::shared_ptr<facebook::jsi::HostObject> &hostObject)
-        : runtime_(rt), hostObject_(hostObject) {}
+    // Indices [0, length) of an indexed host object. Plain host objects report their numeric keys through the
+    // named Enumerator, so this returns nothing for them.
+    static void IndexedEnumerator(const v8::PropertyCallbackInfo<v8::Array> &info) {
+      v8::Local<v8::External> data = v8::Local<v8::External>::Cast(info.This()->GetInternalField(0).As<v8::Value>());
+      HostObjectProxy *hostObjectProxy = reinterpret_cast<HostObjectProxy *>(data->Value());
+      if (hostObjectProxy == nullptr || hostObjectProxy->indexed_ == nullptr) {
+        info.GetReturnValue().Set(v8::Array::New(info.GetIsolate()));
+        return;
+      }
+
+      uint32_t length = hostObjectProxy->indexed_->length(hostObjectProxy->runtime_);
+      v8::Local<v8::Array> result = v8::Array::New(info.GetIsolate(), static_cast<int>(length));
+      v8::Local<v8::Context> context = info.GetIsolate()->GetCurrentContext();
+      for (uint32_t i = 0; i < length; i++) {
+        if (!result->Set(context, i, v8::Integer::NewFromUnsigned(info.GetIsolate(), i)).FromJust()) {
+          std::terminate();
+        }
+      }
+      info.GetReturnValue().Set(result);
+    }
+
+    HostObjectProxy(
+        V8Runtime &rt,
+        const std::shared_ptr<facebook::jsi::HostObject> &hostObject,
+        ::jsi::abi::IndexedHostObject *indexed = nullptr)
+        : runtime_(rt), hostObject_(hostObject), indexed_(indexed) {}
     std::shared_ptr<facebook::jsi::HostObject> getHostObject() {
       return hostObject_;
     }
@@ -416,14 +504,35 @@ class V8Runtime : public facebook::jsi::Runtime {
     friend class HostObjectLifetimeTracker;
     void destroy() override {
       hostObject_.reset();
-
-      // TODO: remove this from host_object_lifetime_tracker_list_ (same for HostFunctionProxy)
+      indexed_ = nullptr;
     }
 
     V8Runtime &runtime_;
     std::shared_ptr<facebook::jsi::HostObject> hostObject_;
+    // Set for objects created through createIndexedHostObject.
+    ::jsi::abi::IndexedHostObject *indexed_;
   };
 
+#if JSI_VERSION >= 20
+  // castInterface target for ::jsi::abi::IIndexedHostObjectFactory.
+  class IndexedHostObjectFactory final : public ::jsi::abi::IIndexedHostObjectFactory {
+   public:
+    explicit IndexedHostObjectFactory(V8Runtime &runtime) : runtime_(runtime) {}
+
+    facebook::jsi::ICast *castInterface(const facebook::jsi::UUID &interfaceUUID) override {
+      return runtime_.castInterface(interfaceUUID);
+    }
+
+    facebook::jsi::Object createIndexedHostObject(std::shared_ptr<::jsi::abi::IndexedHostObject> ho) override {
+      ::jsi::abi::IndexedHostObject *indexed = ho.get();
+      return runtime_.createHostObject(std::move(ho), indexed);
+    }
+
+   private:
+    V8Runtime &runtime_;
+  };
+#endif
+
   class HostFunctionProxy : public IHostProxy {
    public:
     static void call(HostFunctionProxy &hostFunctionProxy, const v8::FunctionCallbackInfo<v8::Value> &callbackInfo) {
@@ -557,21 +666,6 @@ class V8Runtime : public facebook::jsi::Runtime {
     friend class V8Runtime;
   };
 
-  class ExternalOwningOneByteStringResource : public v8::String::ExternalOneByteStringResource {
-   public:
-    explicit ExternalOwningOneByteStringResource(const std::shared_ptr<const facebook::jsi::Buffer> &buffer)
-        : buffer_(buffer) /*create a copy of shared_ptr*/ {}
-    const char *data() const override {
-      return reinterpret_cast<const char *>(buffer_->data());
-    }
-    size_t length() const override {
-      return buffer_->size();
-    }
-
-   private:
-    std::shared_ptr<const facebook::jsi::Buffer> buffer_;
-  };
-
  private: // Implementation of JSI Runtime protected methods
   PointerValue *cloneSymbol(const PointerValue *pv) override;
 #if JSI_VERSION >= 6
@@ -709,7 +803,17 @@ class V8Runtime : public facebook::jsi::Runtime {
 #endif
 
  private:
-  void AddHostObjectLifetimeTracker(std::shared_ptr<HostObjectLifetimeTracker> hostObjectLifetimeTracker);
+  // Links a new tracker at the head of the list; the runtime owns it from here.
+  facebook::jsi::Object createHostObject(
+      std::shared_ptr<facebook::jsi::HostObject> ho,
+      ::jsi::abi::IndexedHostObject *indexed);
+
+  void AddHostObjectLifetimeTracker(std::unique_ptr<HostObjectLifetimeTracker> hostObjectLifetimeTracker);
+  // Unlinks and frees a tracker whose object was collected.
+  void RemoveHostObjectLifetimeTracker(HostObjectLifetimeTracker *hostObjectLifetimeTracker) noexcept;
+
+  // Name of func for call tracing. Cached per function, so only the first traced call resolves it.
+  const std::string &GetTracedFunctionName(v8::Local<v8::Function> func);
 
   static void OnMessage(v8::Local<v8::Message> message, v8::Local<v8::Value> error);
   static size_t NearHeapLimitCallback(void *raw_state, size_t current_heap_limit, size_t initial_heap_limit);
@@ -797,7 +901,33 @@ class V8Runtime : public facebook::jsi::Runtime {
 
   v8::Persistent<v8::Function> host_object_constructor_;
 
-  std::list<std::shared_ptr<HostObjectLifetimeTracker>> host_object_lifetime_tracker_list_;
+  // Intrusive list of trackers for live host objects and host functions.
+  HostObjectLifetimeTracker *host_object_lifetime_tracker_head_{nullptr};
+  size_t host_object_lifetime_tracker_count_{0};
+
+  // Internalized strings for recently created property names.
+  v8rt_internal::PropNameInternTable prop_name_intern_table_;
+
+  // External memory attached to objects through setExternalMemoryPressure.
+  v8rt_internal::ExternalMemoryTable external_memory_table_;
+
+  // Hashes of recently loaded sources, so evaluating a prepared script (or the same buffer again) does not hash the
+  // source again. A jsi::Buffer is immutable, so a buffer that is still alive still has the hash it had.
+  struct HashedBuffer {
+    std::weak_ptr<const facebook::jsi::Buffer> buffer;
+    std::uint64_t hash{0};
+    bool isAscii{false};
+  };
+  std::array<HashedBuffer, 4> hashed_buffers_;
+  size_t next_hashed_buffer_{0};
+
+  // Names of recently traced functions. The slot is picked by the function's identity hash; the function is held
+  // weakly, so a collected function just leaves an empty slot.
+  struct TracedFunctionName {
+    v8::Global<v8::Function> function;
+    std::string name;
+  };
+  std::array<TracedFunctionName, 64> traced_function_names_;
 
   std::string desc_;
 
@@ -809,5 +939,9 @@ class V8Runtime : public facebook::jsi::Runtime {
   static void JitCodeEventListener(const v8::JitCodeEvent *event);
 
   std::unique_ptr<facebook::jsi::Instrumentation> instrumentation_;
+
+#if JSI_VERSION >= 20
+  IndexedHostObjectFactory indexed_host_object_factory_{*this};
+#endif
 };
 } // namespace v8runtime
@@ -18,6 +18,9 @@ TRACELOGGING_DECLARE_PROVIDER(g_hV8JSIInspectorTraceLoggingProvider);
   TraceLoggingWrite(                           \
       g_hV8JSIRuntimeTraceLoggingProvider, eventName, TraceLoggingLevel(TRACE_LEVEL_VERBOSE), __VA_ARGS__);
 
+// True when a session listens to the runtime provider. Use it to skip building expensive event payloads.
+#define TRACEV8RUNTIME_ENABLED() TraceLoggingProviderEnabled(g_hV8JSIRuntimeTraceLoggingProvider, 0, 0)
+
 #define TRACEV8RUNTIME_WARNING(eventName, ...) \
   TraceLoggingWrite(                           \
       g_hV8JSIRuntimeTraceLoggingProvider, eventName, TraceLoggingLevel(TRACE_LEVEL_WARNING), __VA_ARGS__);
@@ -56,6 +59,7 @@ void globalInitializeTracing();
 #else // WIN32
 
 #define TRACEV8RUNTIME_VERBOSE(eventName, ...)
+#define TRACEV8RUNTIME_ENABLED() false
 #define TRACEV8RUNTIME_WARNING(eventName, ...)
 #define TRACEV8RUNTIME_CRITICAL(eventName, ...)
 #define TraceLoggingString(foo,bar)
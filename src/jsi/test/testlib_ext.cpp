@@ -570,6 +570,42 @@ TEST_P(JSITestExt, NativeExceptionDoesNotUseGlobalError) {
       test.call(rt).getString(rt).utf8(rt));
 }
 
+TEST_P(JSITestExt, HostFunctionRetainsBorrowedArguments) {
+  // Host function arguments are borrowed for the duration of the call; a
+  // host function that keeps one must copy it. Exercise both the inline
+  // argument buffer and the heap spill past eight arguments.
+  std::vector<Value> kept;
+  Function keep = Function::createFromHostFunction(
+      rt,
+      PropNameID::forAscii(rt, "keep"),
+      0,
+      [&kept](Runtime& rt, const Value& thisVal, const Value* args, size_t count)
+          -> Value {
+        EXPECT_TRUE(thisVal.isObject());
+        for (size_t i = 0; i < count; ++i) {
+          kept.emplace_back(rt, args[i]);
+        }
+        return Value(rt, args[count - 1]);
+      });
+  rt.global().setProperty(rt, "keep", keep);
+
+  EXPECT_EQ(
+      eval("keep.call({}, 'a', {b: 2}, 3)").getNumber(), 3);
+  EXPECT_EQ(
+      eval("keep.call({}, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'ten', {v: 11})")
+          .getObject(rt)
+          .getProperty(rt, "v")
+          .getNumber(),
+      11);
+  eval("gc()");
+
+  ASSERT_EQ(kept.size(), 14u);
+  EXPECT_EQ(kept[0].getString(rt).utf8(rt), "a");
+  EXPECT_EQ(kept[1].getObject(rt).getProperty(rt, "b").getNumber(), 2);
+  EXPECT_EQ(kept[12].getString(rt).utf8(rt), "ten");
+  EXPECT_EQ(kept[13].getObject(rt).getProperty(rt, "v").getNumber(), 11);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Runtimes,
     JSITestExt,
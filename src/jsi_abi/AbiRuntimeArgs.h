@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Argument buffers shared by the two facebook::jsi::Runtime implementations
+// over a jsi_runtime (see AbiRuntimeInterfaces.h). Each runtime supplies the
+// conversion to or from its own value representation: jsi_value and
+// ManagedPointerHolder in JsiAbiRuntime, v8::Local<v8::Value> and
+// V8PointerValue in V8DirectRuntime. Both buffers are inline up to
+// kInlineArgs, so the common calls do not allocate.
+//
+// Internal to those two runtimes; ships as source alongside JsiAbiRuntime.cpp.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace jsi::abi {
+
+// Arguments of a call into JS, each converted by toArg(const Value &) to T.
+// The converted values may borrow the callers' Values, which outlive the call.
+template <typename T>
+class CallArgs {
+ public:
+  static constexpr size_t kInlineArgs = 8;
+
+  template <typename ToArg>
+  CallArgs(const facebook::jsi::Value *args, size_t count, ToArg &&toArg) {
+    if (count > kInlineArgs) {
+      heap_ = std::make_unique<T[]>(count);
+      data_ = heap_.get();
+    }
+    for (size_t i = 0; i < count; ++i)
+      data_[i] = toArg(args[i]);
+  }
+
+  CallArgs(const CallArgs &) = delete;
+  CallArgs &operator=(const CallArgs &) = delete;
+
+  T *data() {
+    return data_;
+  }
+
+ private:
+  T inline_[kInlineArgs];
+  std::unique_ptr<T[]> heap_;
+  T *data_{inline_};
+};
+
+// Host function arguments viewed as facebook::jsi::Values without taking
+// references: borrow(index, pointer) wraps argument index (0 is this, the
+// arguments follow) in a non-owning Pointer constructed in place in the
+// storage at pointer, and returns the Value. Pointer::invalidate() must be a
+// no-op for such a value; a host function that keeps an argument copies the
+// Value, which clones it.
+template <typename Pointer>
+class BorrowedArgs {
+ public:
+  static constexpr size_t kInlineArgs = 8;
+
+  template <typename Borrow>
+  BorrowedArgs(size_t count, Borrow &&borrow) : count_(count) {
+    if (count_ > kInlineArgs) {
+      heapValues_ = std::make_unique<facebook::jsi::Value[]>(count_ + 1);
+      heapSlots_ = std::make_unique<PointerSlot[]>(count_ + 1);
+      values_ = heapValues_.get();
+      slots_ = heapSlots_.get();
+    }
+    for (size_t i = 0; i <= count_; ++i)
+      values_[i] = borrow(i, slots_[i].get());
+  }
+
+  ~BorrowedArgs() {
+    // Drop the Values before their pointers, which are trivially destroyed.
+    for (size_t i = 0; i <= count_; ++i)
+      values_[i] = facebook::jsi::Value();
+  }
+
+  BorrowedArgs(const BorrowedArgs &) = delete;
+  BorrowedArgs &operator=(const BorrowedArgs &) = delete;
+
+  const facebook::jsi::Value &thisArg() const {
+    return values_[0];
+  }
+  const facebook::jsi::Value *data() const {
+    return values_ + 1;
+  }
+  size_t size() const {
+    return count_;
+  }
+
+ private:
+  struct PointerSlot {
+    alignas(Pointer) unsigned char bytes[sizeof(Pointer)];
+    Pointer *get() {
+      return reinterpret_cast<Pointer *>(bytes);
+    }
+  };
+
+  size_t count_;
+  facebook::jsi::Value inlineValues_[kInlineArgs + 1];
+  PointerSlot inlineSlots_[kInlineArgs + 1];
+  std::unique_ptr<facebook::jsi::Value[]> heapValues_;
+  std::unique_ptr<PointerSlot[]> heapSlots_;
+  facebook::jsi::Value *values_{inlineValues_};
+  PointerSlot *slots_{inlineSlots_};
+};
+
+} // namespace jsi::abi
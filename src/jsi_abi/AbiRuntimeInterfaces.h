@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Glue shared by the two facebook::jsi::Runtime implementations over a
+// jsi_runtime: JsiAbiRuntime, compiled by the consumer, and V8DirectRuntime,
+// inside v8jsi.dll. Both answer castInterface for the engine-agnostic runtime
+// interfaces (ScriptStoreRuntime.h, AsyncPrepareRuntime.h,
+// StartupCompleteRuntime.h) with the adapters below, which forward each call
+// to its jsi_runtime_vtable entry. A runtime using them provides:
+//
+//   jsi_runtime *abiRuntime() const;
+//   std::weak_ptr<Runtime *> weakSelf() const;  // expires with the wrapper
+//   static jsi_buffer *wrapBuffer(std::shared_ptr<const Buffer>);
+//   std::shared_ptr<const PreparedJavaScript> adoptPreparedJavaScript(
+//       jsi_prepared_javascript_or_error);  // throws for an error
+//
+// Internal to those two runtimes; ships as source alongside JsiAbiRuntime.cpp.
+
+#pragma once
+
+#include "jsi_abi/AsyncPrepareRuntime.h"
+#include "jsi_abi/ScriptStoreRuntime.h"
+#include "jsi_abi/StartupCompleteRuntime.h"
+#include "jsi_abi/jsi_abi.h"
+#include "jsi_abi/jsi_abi_helpers.h"
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace jsi::abi {
+
+// Starts prepare_javascript_async on rt's jsi_runtime and hands the result to
+// done on the JS thread. If the wrapper or the jsi_runtime is gone by the time
+// the script is ready, the result is released and done never runs.
+template <typename Runtime>
+void startPrepareJavaScriptAsync(
+    Runtime &rt,
+    const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+    const std::string &sourceURL,
+    PrepareJavaScriptCallback done) {
+  // Freed by the completion callback, which the ABI calls exactly once.
+  struct Pending {
+    std::weak_ptr<Runtime *> rt;
+    PrepareJavaScriptCallback done;
+  };
+  auto onPrepared = [](void *ctx,
+                       jsi_runtime *abiRt,
+                       jsi_prepared_javascript_or_error result) noexcept {
+    std::unique_ptr<Pending> pending(static_cast<Pending *>(ctx));
+    std::shared_ptr<Runtime *> self = pending->rt.lock();
+    if (!abiRt || !self) {
+      // The runtime or just this wrapper is gone.
+      if (!is_error(result)) {
+        jsi_prepared_javascript *prepared = get_prepared_javascript(result);
+        prepared->vtable->release(prepared);
+      } else if (abiRt && get_error(result) == jsi_error_js) {
+        release_value(abiRt->vt->get_and_clear_js_error_value(abiRt));
+      }
+      return;
+    }
+
+    Runtime &rt = **self;
+    std::shared_ptr<const facebook::jsi::PreparedJavaScript> prepared;
+    std::exception_ptr error;
+    try {
+      prepared = rt.adoptPreparedJavaScript(result);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    pending->done(rt, std::move(prepared), error);
+  };
+
+  jsi_runtime *abiRt = rt.abiRuntime();
+  auto *pending = new Pending{rt.weakSelf(), std::move(done)};
+  abiRt->vt->prepare_javascript_async(
+      abiRt,
+      Runtime::wrapBuffer(buffer),
+      sourceURL.c_str(),
+      sourceURL.size(),
+      pending,
+      onPrepared);
+}
+
+#if JSI_VERSION >= 20
+// castInterface target for Interface on Runtime. Leads castInterface back to
+// the runtime, so each interface it supports is reachable from every other.
+template <typename Interface, typename Runtime>
+class InterfaceAdapter : public Interface {
+ public:
+  explicit InterfaceAdapter(Runtime &rt) : rt_(rt) {}
+
+  InterfaceAdapter(const InterfaceAdapter &) = delete;
+  InterfaceAdapter &operator=(const InterfaceAdapter &) = delete;
+
+  facebook::jsi::ICast *castInterface(
+      const facebook::jsi::UUID &interfaceUUID) override {
+    return rt_.castInterface(interfaceUUID);
+  }
+
+ protected:
+  Runtime &rt_;
+};
+
+template <typename Runtime>
+class ScriptStoreAdapter final
+    : public InterfaceAdapter<IScriptStoreRuntime, Runtime> {
+ public:
+  using InterfaceAdapter<IScriptStoreRuntime, Runtime>::InterfaceAdapter;
+
+  std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+  prepareJavaScriptFromStore(const std::string &sourceURL) override {
+    jsi_runtime *abiRt = this->rt_.abiRuntime();
+    return this->rt_.adoptPreparedJavaScript(
+        abiRt->vt->prepare_javascript_from_store(
+            abiRt, sourceURL.c_str(), sourceURL.size()));
+  }
+};
+
+template <typename Runtime>
+class AsyncPrepareAdapter final
+    : public InterfaceAdapter<IAsyncPrepareRuntime, Runtime> {
+ public:
+  using InterfaceAdapter<IAsyncPrepareRuntime, Runtime>::InterfaceAdapter;
+
+  void prepareJavaScriptAsync(
+      const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+      std::string sourceURL,
+      PrepareJavaScriptCallback done) override {
+    startPrepareJavaScriptAsync(this->rt_, buffer, sourceURL, std::move(done));
+  }
+};
+
+template <typename Runtime>
+class StartupCompleteAdapter final
+    : public InterfaceAdapter<IStartupCompleteRuntime, Runtime> {
+ public:
+  using InterfaceAdapter<IStartupCompleteRuntime, Runtime>::InterfaceAdapter;
+
+  void notifyStartupComplete() override {
+    jsi_runtime *abiRt = this->rt_.abiRuntime();
+    abiRt->vt->notify_startup_complete(abiRt);
+  }
+};
+#endif
+
+} // namespace jsi::abi
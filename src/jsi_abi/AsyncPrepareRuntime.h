@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Preparing scripts off the JS thread.
+//
+// Runtime::prepareJavaScript parses and compiles the whole source before it
+// returns, which for a multi-megabyte bundle keeps the JS thread busy for the
+// longest single step of a cold start. prepareJavaScriptAsync returns at once:
+// the runtime parses the source on a worker thread and calls back from its
+// foreground task runner (V8RuntimeArgs::foreground_task_runner) once the
+// script is ready to evaluate. A source with a code cache entry is compiled
+// from the cache instead, also before the callback runs.
+//
+// On a runtime that cannot prepare off the JS thread, prepareJavaScriptAsync
+// prepares synchronously and calls back before returning, so hosts can use it
+// unconditionally.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace jsi::abi {
+
+// Receives the prepared script, or the exception that preparing it threw
+// (JSError for a syntax error) with prepared null. Must not throw.
+using PrepareJavaScriptCallback = std::function<void(
+    facebook::jsi::Runtime &rt,
+    std::shared_ptr<const facebook::jsi::PreparedJavaScript> prepared,
+    std::exception_ptr error)>;
+
+#if JSI_VERSION >= 20
+// Runtime interface behind prepareJavaScriptAsync.
+struct IAsyncPrepareRuntime : facebook::jsi::ICast {
+  static constexpr facebook::jsi::UUID uuid{
+      0x8c41f2a7,
+      0x1d93,
+      0x4e65,
+      0xb0c8,
+      0x5a72e914d3f6};
+
+  // done runs on the JS thread, from a task posted to the runtime's task
+  // runner, or before this returns if the runtime has none. It never runs if
+  // the runtime is destroyed first.
+  virtual void prepareJavaScriptAsync(
+      const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+      std::string sourceURL,
+      PrepareJavaScriptCallback done) = 0;
+
+ protected:
+  ~IAsyncPrepareRuntime() = default;
+};
+#endif
+
+// Prepares buffer off the JS thread where the runtime supports it; otherwise
+// prepares it synchronously and calls done before returning.
+inline void prepareJavaScriptAsync(
+    facebook::jsi::Runtime &rt,
+    const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+    std::string sourceURL,
+    PrepareJavaScriptCallback done) {
+#if JSI_VERSION >= 20
+  if (auto *async = facebook::jsi::castInterface<IAsyncPrepareRuntime>(&rt)) {
+    async->prepareJavaScriptAsync(buffer, std::move(sourceURL), std::move(done));
+    return;
+  }
+#endif
+  std::shared_ptr<const facebook::jsi::PreparedJavaScript> prepared;
+  std::exception_ptr error;
+  try {
+    prepared = rt.prepareJavaScript(buffer, std::move(sourceURL));
+  } catch (...) {
+    error = std::current_exception();
+  }
+  done(rt, std::move(prepared), error);
+}
+
+} // namespace jsi::abi
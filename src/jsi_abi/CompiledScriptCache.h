@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Keeps the scripts a runtime has compiled, keyed on source URL and hash.
+//
+// A host that prepares the same bundle more than once (a reload, one module
+// source evaluated into several fresh scopes) pays for the hash, the code
+// cache load and the deserialization every time, even though the isolate
+// still holds the compiled script. An UnboundScript is not tied to a context,
+// so a later prepare of the same (URL, hash) can hand out the one compiled
+// first and the host only binds and runs it.
+//
+// Each entry keeps its script, and so its source, alive. The cache is bounded
+// by the total size of those sources and drops the least recently used
+// entries first.
+//
+// Not thread-safe: callers hold the isolate. Exception-free apart from
+// std::bad_alloc, like the rest of the ABI implementation.
+
+#pragma once
+
+#include "v8.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+
+namespace v8rt_internal {
+
+class CompiledScriptCache {
+ public:
+  CompiledScriptCache() = default;
+  CompiledScriptCache(const CompiledScriptCache &) = delete;
+  CompiledScriptCache &operator=(const CompiledScriptCache &) = delete;
+
+  /// Sets the bound on the total source size of the cached scripts. 0 (the
+  /// default) disables the cache. Call before the first insert.
+  void setMaxBytes(size_t max_bytes) noexcept { maxBytes_ = max_bytes; }
+
+  bool enabled() const noexcept { return maxBytes_ != 0; }
+
+  /// Sets script to the script compiled from url and hash and returns true
+  /// if the cache holds one.
+  bool lookup(
+      v8::Isolate *isolate,
+      std::string_view url,
+      uint64_t hash,
+      v8::Local<v8::UnboundScript> &script) {
+    if (!enabled())
+      return false;
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->hash == hash && it->url == url) {
+        entries_.splice(entries_.begin(), entries_, it);
+        script = it->script.Get(isolate);
+        ++hits_;
+        return true;
+      }
+    }
+    ++misses_;
+    return false;
+  }
+
+  /// Remembers script as compiled from the size-byte source at url with
+  /// hash, evicting the least recently used entries to stay within the
+  /// bound. A source larger than the whole bound is not cached.
+  void insert(
+      v8::Isolate *isolate,
+      std::string_view url,
+      uint64_t hash,
+      size_t size,
+      v8::Local<v8::UnboundScript> script) {
+    if (!enabled() || size > maxBytes_)
+      return;
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->hash == hash && it->url == url) {
+        bytes_ -= it->size;
+        entries_.erase(it);
+        break;
+      }
+    }
+    while (bytes_ + size > maxBytes_) {
+      bytes_ -= entries_.back().size;
+      entries_.pop_back();
+    }
+    Entry &entry = entries_.emplace_front();
+    entry.url.assign(url);
+    entry.hash = hash;
+    entry.size = size;
+    entry.script.Reset(isolate, script);
+    bytes_ += size;
+  }
+
+  /// Drops every entry. Must run before the isolate is disposed.
+  void clear() noexcept {
+    entries_.clear();
+    bytes_ = 0;
+  }
+
+  size_t hits() const noexcept { return hits_; }
+  size_t misses() const noexcept { return misses_; }
+  size_t bytes() const noexcept { return bytes_; }
+  size_t entries() const noexcept { return entries_.size(); }
+  size_t maxBytes() const noexcept { return maxBytes_; }
+
+ private:
+  struct Entry {
+    std::string url;
+    uint64_t hash{0};
+    size_t size{0};
+    v8::Global<v8::UnboundScript> script;
+  };
+
+  // Most recently used first.
+  std::list<Entry> entries_;
+  size_t maxBytes_{0};
+  size_t bytes_{0};
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+} // namespace v8rt_internal
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Per-object external memory accounting for Object::setExternalMemoryPressure.
+//
+// Host objects that own large native buffers (decoded images, media frames)
+// report them through setExternalMemoryPressure so V8's GC heuristics see the
+// memory a collection would free. JSI defines the amount as a property of the
+// object: a later call replaces the previous amount, and the memory counts as
+// freed once the object is collected.
+//
+// The table keeps one record per object that carries a non-zero amount. The
+// record hangs off the object through a private symbol and holds a weak
+// reference to it; setting a new amount adjusts the isolate's external memory
+// by the difference, and collecting the object (or setting zero) subtracts
+// whatever is left. Collection takes two weak callback passes: the first only
+// resets the handle, as V8 requires, and the second returns the memory and
+// frees the record.
+//
+// Not thread-safe: callers hold the isolate (the runtime's JS thread or its
+// v8::Locker). Exception-free apart from std::bad_alloc, like the rest of the
+// ABI implementation.
+
+#pragma once
+
+#include "v8.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+namespace v8rt_internal {
+
+class ExternalMemoryTable {
+ public:
+  ExternalMemoryTable() = default;
+  ExternalMemoryTable(const ExternalMemoryTable &) = delete;
+  ExternalMemoryTable &operator=(const ExternalMemoryTable &) = delete;
+
+  /// Runs after the isolate is disposed, when no second pass can still come.
+  ~ExternalMemoryTable() {
+    clear(nullptr);
+    for (Record *record : collected_)
+      delete record;
+  }
+
+  /// Sets the external memory attached to obj to amount bytes and adjusts the
+  /// isolate's external allocation by the change. Returns false if V8 failed
+  /// to read or attach the record (a pending exception or termination).
+  bool set(
+      v8::Isolate *isolate,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::Object> obj,
+      size_t amount) {
+    if (key_.IsEmpty())
+      key_.Reset(
+          isolate,
+          v8::Private::New(
+              isolate,
+              v8::String::NewFromUtf8Literal(
+                  isolate, "v8rt::externalMemory")));
+    v8::Local<v8::Private> key = key_.Get(isolate);
+
+    v8::Local<v8::Value> tag;
+    if (!obj->GetPrivate(context, key).ToLocal(&tag))
+      return false;
+    Record *record = tag->IsExternal()
+        ? static_cast<Record *>(tag.As<v8::External>()->Value())
+        : nullptr;
+    // A record released by clear() may still be tagged on a live object.
+    if (record && records_.count(record) == 0)
+      record = nullptr;
+
+    if (!record) {
+      if (amount == 0)
+        return true;
+      record = new Record{this, {}, 0};
+      if (!obj->SetPrivate(context, key, v8::External::New(isolate, record))
+               .FromMaybe(false)) {
+        delete record;
+        return false;
+      }
+      record->object.Reset(isolate, obj);
+      record->object.SetWeak(
+          record, onObjectCollected, v8::WeakCallbackType::kParameter);
+      records_.insert(record);
+    } else if (amount == 0) {
+      obj->DeletePrivate(context, key).FromMaybe(false);
+      release(isolate, record);
+      return true;
+    }
+
+    adjust(isolate, static_cast<int64_t>(amount) -
+               static_cast<int64_t>(record->amount));
+    record->amount = amount;
+    return true;
+  }
+
+  /// Releases every record and returns their memory to the isolate. Must run
+  /// before the isolate is disposed; isolate may be null if it is already gone.
+  /// Records of collected objects stay allocated until their second pass runs
+  /// or the table is destroyed, since V8 still holds them as callback data.
+  void clear(v8::Isolate *isolate) noexcept {
+    for (Record *record : records_) {
+      if (isolate)
+        adjust(isolate, -static_cast<int64_t>(record->amount));
+      record->object.Reset();
+      delete record;
+    }
+    records_.clear();
+    for (Record *record : collected_) {
+      if (isolate)
+        adjust(isolate, -static_cast<int64_t>(record->amount));
+      record->amount = 0;
+    }
+    totalBytes_ = 0;
+    key_.Reset();
+  }
+
+  /// Bytes currently reported to the isolate, including those of collected
+  /// objects whose second pass has not run yet.
+  int64_t totalBytes() const noexcept { return totalBytes_; }
+
+  /// Number of live objects with a non-zero amount.
+  size_t trackedObjects() const noexcept { return records_.size(); }
+
+ private:
+  struct Record {
+    ExternalMemoryTable *table;
+    v8::Global<v8::Object> object;
+    size_t amount;
+  };
+
+  // First pass: V8 allows nothing but resetting the handle here.
+  static void onObjectCollected(const v8::WeakCallbackInfo<Record> &info) {
+    Record *record = info.GetParameter();
+    record->object.Reset();
+    record->table->records_.erase(record);
+    record->table->collected_.insert(record);
+    info.SetSecondPassCallback(onObjectCollectedSecondPass);
+  }
+
+  static void onObjectCollectedSecondPass(
+      const v8::WeakCallbackInfo<Record> &info) {
+    Record *record = info.GetParameter();
+    ExternalMemoryTable *table = record->table;
+    table->collected_.erase(record);
+    table->adjust(info.GetIsolate(), -static_cast<int64_t>(record->amount));
+    delete record;
+  }
+
+  void release(v8::Isolate *isolate, Record *record) noexcept {
+    adjust(isolate, -static_cast<int64_t>(record->amount));
+    records_.erase(record);
+    record->object.Reset();
+    delete record;
+  }
+
+  void adjust(v8::Isolate *isolate, int64_t delta) noexcept {
+    if (delta == 0)
+      return;
+    totalBytes_ += delta;
+    isolate->AdjustAmountOfExternalAllocatedMemory(delta);
+  }
+
+  std::unordered_set<Record *> records_;
+  // Records whose object is collected but whose second pass has not run yet.
+  std::unordered_set<Record *> collected_;
+  int64_t totalBytes_{0};
+  v8::Global<v8::Private> key_;
+};
+
+} // namespace v8rt_internal
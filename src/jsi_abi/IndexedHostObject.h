@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Integer-keyed extension of facebook::jsi::HostObject.
+//
+// A plain HostObject sees every element access as a property name: obj[3]
+// becomes std::to_string(3), a JS string and a PropNameID before get() runs.
+// Host objects that emulate arrays or typed buffers derive from
+// IndexedHostObject instead and are created with createIndexedHostObject;
+// runtimes that support it dispatch integer keys straight to getIndex /
+// setIndex (over the C ABI: jsi_host_object_vtable::get_index and friends).
+//
+// Engine-agnostic and header-only, like the rest of the consumer-side ABI
+// surface. Runtimes advertise support through facebook::jsi::castInterface,
+// so no RTTI is needed on either side of the DLL boundary.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace jsi::abi {
+
+class IndexedHostObject : public facebook::jsi::HostObject {
+ public:
+  // Returns the element at index. Called for every array-index key, including
+  // ones at or past length().
+  virtual facebook::jsi::Value getIndex(
+      facebook::jsi::Runtime &rt,
+      uint32_t index) = 0;
+
+  // Stores value at index. By default throws a TypeError, like
+  // HostObject::set.
+  virtual void setIndex(
+      facebook::jsi::Runtime &rt,
+      uint32_t index,
+      const facebook::jsi::Value & /*value*/) {
+    throw facebook::jsi::JSError(
+        rt,
+        "TypeError: Cannot assign to index " + std::to_string(index) +
+            " on IndexedHostObject with default setter");
+  }
+
+  // Number of elements. Enumeration reports indices [0, length) ahead of
+  // getPropertyNames().
+  virtual uint32_t length(facebook::jsi::Runtime &rt) = 0;
+};
+
+#if JSI_VERSION >= 20
+// Runtime interface behind createIndexedHostObject.
+struct IIndexedHostObjectFactory : facebook::jsi::ICast {
+  static constexpr facebook::jsi::UUID uuid{
+      0x6b1f3c2e,
+      0x8d4a,
+      0x4f7b,
+      0x9a61,
+      0x2c5e8f0d3b74};
+
+  virtual facebook::jsi::Object createIndexedHostObject(
+      std::shared_ptr<IndexedHostObject> ho) = 0;
+
+ protected:
+  ~IIndexedHostObjectFactory() = default;
+};
+#endif
+
+// Creates a JS object backed by ho. On runtimes without the indexed fast path
+// this is Object::createFromHostObject, and integer keys reach ho->get/set as
+// property names.
+inline facebook::jsi::Object createIndexedHostObject(
+    facebook::jsi::Runtime &rt,
+    std::shared_ptr<IndexedHostObject> ho) {
+#if JSI_VERSION >= 20
+  if (auto *factory =
+          facebook::jsi::castInterface<IIndexedHostObjectFactory>(&rt))
+    return factory->createIndexedHostObject(std::move(ho));
+#endif
+  return facebook::jsi::Object::createFromHostObject(rt, std::move(ho));
+}
+
+} // namespace jsi::abi
@@ -14,12 +14,21 @@
 
 #include "jsi_abi/JsiAbiRuntime.h"
 
+#include "jsi_abi/AbiRuntimeArgs.h"
+#include "jsi_abi/AbiRuntimeInterfaces.h"
+#include "jsi_abi/AsyncPrepareRuntime.h"
+#include "jsi_abi/IndexedHostObject.h"
+#include "jsi_abi/ScriptStoreRuntime.h"
+#include "jsi_abi/StartupCompleteRuntime.h"
+
 #include "jsi_abi/jsi_abi.h"
 #include "jsi_abi/jsi_abi_helpers.h"
 
 #include <atomic>
 #include <cassert>
 #include <cstring>
+#include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -164,8 +173,22 @@ class JsiAbiRuntime : public facebook::jsi::Runtime {
   std::string description() override;
   bool isInspectable() override;
 
+#if JSI_VERSION >= 20
+  facebook::jsi::ICast *castInterface(
+      const facebook::jsi::UUID &interfaceUUID) override;
+#endif
+
   jsi_runtime *abiRuntime() const noexcept { return abiRt_; }
 
+  // For the runtime interface adapters (AbiRuntimeInterfaces.h).
+  std::weak_ptr<JsiAbiRuntime *> weakSelf() const noexcept { return self_; }
+  static jsi_buffer *wrapBuffer(
+      std::shared_ptr<const facebook::jsi::Buffer> buffer) {
+    return new BufferWrapper(std::move(buffer));
+  }
+  std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+  adoptPreparedJavaScript(jsi_prepared_javascript_or_error result);
+
  protected:
   PointerValue *cloneSymbol(const PointerValue *pv) override;
   PointerValue *cloneString(const PointerValue *pv) override;
@@ -213,6 +236,17 @@ class JsiAbiRuntime : public facebook::jsi::Runtime {
       size_t length) override;
   std::string utf8(const facebook::jsi::String &) override;
 
+#if JSI_VERSION >= 16
+  void getStringData(
+      const facebook::jsi::String &str,
+      void *ctx,
+      void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) override;
+  void getPropNameIdData(
+      const facebook::jsi::PropNameID &sym,
+      void *ctx,
+      void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) override;
+#endif
+
   facebook::jsi::Object createObject() override;
   facebook::jsi::Object createObject(
       std::shared_ptr<facebook::jsi::HostObject> ho) override;
@@ -358,6 +392,9 @@ class JsiAbiRuntime : public facebook::jsi::Runtime {
   facebook::jsi::Value cloneToJSIValue(const jsi_value &val);
   facebook::jsi::PropNameID cloneToJSIPropNameID(jsi_propnameid name);
   facebook::jsi::Value intoJSIValue(jsi_value val);
+  facebook::jsi::Value borrowToJSIValue(
+      const jsi_value &val,
+      ManagedPointerHolder *holderStorage);
 
   [[noreturn]] void throwError(jsi_error_code err);
   void checkStatus(jsi_error_code err);
@@ -368,9 +405,32 @@ class JsiAbiRuntime : public facebook::jsi::Runtime {
   template <typename T, typename Fn>
   T abiRethrow(T (*wrapErr)(jsi_error_code), Fn fn);
 
+#if JSI_VERSION >= 20
+  // castInterface target for IIndexedHostObjectFactory: wraps the host object
+  // with the indexed jsi_host_object_vtable.
+  class IndexedHostObjectFactory final
+      : public InterfaceAdapter<IIndexedHostObjectFactory, JsiAbiRuntime> {
+   public:
+    using InterfaceAdapter::InterfaceAdapter;
+
+    facebook::jsi::Object createIndexedHostObject(
+        std::shared_ptr<IndexedHostObject> ho) override;
+  };
+#endif
+
   const jsi_runtime_vtable *vt_;
   jsi_runtime *abiRt_;
   bool activeJSError_ = false;
+  // Expires with the wrapper. prepare_javascript_async callbacks check it,
+  // since the jsi_runtime may outlive this wrapper.
+  std::shared_ptr<JsiAbiRuntime *> self_{
+      std::make_shared<JsiAbiRuntime *>(this)};
+#if JSI_VERSION >= 20
+  IndexedHostObjectFactory indexedHostObjectFactory_{*this};
+  ScriptStoreAdapter<JsiAbiRuntime> scriptStoreRuntime_{*this};
+  AsyncPrepareAdapter<JsiAbiRuntime> asyncPrepareRuntime_{*this};
+  StartupCompleteAdapter<JsiAbiRuntime> startupCompleteRuntime_{*this};
+#endif
 };
 
 } // namespace
@@ -383,10 +443,18 @@ class JsiAbiRuntime : public facebook::jsi::Runtime {
 class JsiAbiRuntime::ManagedPointerHolder : public PointerValue {
   jsi_pointer *pointer_;
   std::atomic<uint32_t> refCount_{1};
+  bool borrowed_{false};
 
  public:
+  struct Borrowed {};
+
   explicit ManagedPointerHolder(jsi_pointer *pointer) : pointer_(pointer) {}
 
+  // Non-owning holder for a host function argument (see BorrowedArgs). It
+  // lives in caller-provided storage and invalidate() is a no-op.
+  ManagedPointerHolder(jsi_pointer *pointer, Borrowed)
+      : pointer_(pointer), borrowed_(true) {}
+
   jsi_pointer *pointer() const {
     return pointer_;
   }
@@ -396,6 +464,8 @@ class JsiAbiRuntime::ManagedPointerHolder : public PointerValue {
   }
 
   void invalidate() JSI_NOEXCEPT_15 override {
+    if (borrowed_)
+      return;
     auto oldCount = refCount_.fetch_sub(1, std::memory_order_acq_rel);
     if (oldCount == 1) {
       if (pointer_) {
@@ -445,14 +515,16 @@ class JsiAbiRuntime::HostFunctionWrapper : public jsi_host_function {
     auto &rtw = wrapper->rtw_;
     return rtw.abiRethrow(
         abi::create_value_or_error, [&]() -> jsi_value_or_error {
-          facebook::jsi::Value jsThis = rtw.cloneToJSIValue(*thisArg);
-          std::vector<facebook::jsi::Value> jsArgs;
-          jsArgs.reserve(argCount);
-          for (size_t i = 0; i < argCount; ++i)
-            jsArgs.push_back(rtw.cloneToJSIValue(args[i]));
+          // The ABI passes the arguments borrowed for the duration of the
+          // call, so no clone happens.
+          BorrowedArgs<ManagedPointerHolder> borrowed(
+              argCount, [&](size_t i, ManagedPointerHolder *holder) {
+                return rtw.borrowToJSIValue(
+                    i == 0 ? *thisArg : args[i - 1], holder);
+              });
 
-          facebook::jsi::Value result =
-              wrapper->hf_(rtw, jsThis, jsArgs.data(), argCount);
+          facebook::jsi::Value result = wrapper->hf_(
+              rtw, borrowed.thisArg(), borrowed.data(), argCount);
 
           return abi::create_value_or_error(rtw.cloneToABIValue(result));
         });
@@ -466,6 +538,9 @@ class JsiAbiRuntime::HostFunctionWrapper : public jsi_host_function {
 class JsiAbiRuntime::HostObjectWrapper : public jsi_host_object {
   JsiAbiRuntime &rtw_;
   std::shared_ptr<facebook::jsi::HostObject> ho_;
+  // Non-null when ho_ is an IndexedHostObject created through
+  // createIndexedHostObject; selects getIndexedVt().
+  IndexedHostObject *indexed_{nullptr};
 
   struct PropNameIDListWrapper : public jsi_propnameid_list {
     std::vector<facebook::jsi::PropNameID> jsiProps_;
@@ -489,10 +564,20 @@ class JsiAbiRuntime::HostObjectWrapper : public jsi_host_object {
  public:
   static const jsi_host_object_vtable *getVt() {
     static const jsi_host_object_vtable hoVt{
-        &release, &get, &set, &getOwnKeys};
+        &release, &get, &set, &getOwnKeys, nullptr, nullptr, nullptr};
     return &hoVt;
   }
 
+  static const jsi_host_object_vtable *getIndexedVt() {
+    static const jsi_host_object_vtable hoVt{
+        &release, &get, &set, &getOwnKeys, &getIndex, &setIndex, &getLength};
+    return &hoVt;
+  }
+
+  static bool isWrapper(const jsi_host_object *ho) {
+    return ho->vtable == getVt() || ho->vtable == getIndexedVt();
+  }
+
   HostObjectWrapper(
       JsiAbiRuntime &rt,
       std::shared_ptr<facebook::jsi::HostObject> ho)
@@ -500,6 +585,12 @@ class JsiAbiRuntime::HostObjectWrapper : public jsi_host_object {
     vtable = const_cast<jsi_host_object_vtable *>(getVt());
   }
 
+  HostObjectWrapper(JsiAbiRuntime &rt, std::shared_ptr<IndexedHostObject> ho)
+      : rtw_(rt), indexed_(ho.get()) {
+    ho_ = std::move(ho);
+    vtable = const_cast<jsi_host_object_vtable *>(getIndexedVt());
+  }
+
   std::shared_ptr<facebook::jsi::HostObject> getHostObject() const {
     return ho_;
   }
@@ -560,6 +651,44 @@ class JsiAbiRuntime::HostObjectWrapper : public jsi_host_object {
           return abi::create_propnameid_list_or_error(list);
         });
   }
+
+  static jsi_value_or_error JSI_CDECL getIndex(
+      jsi_host_object *self,
+      jsi_runtime * /*abiRt*/,
+      uint32_t index) {
+    auto *wrapper = static_cast<HostObjectWrapper *>(self);
+    auto &rtw = wrapper->rtw_;
+    return rtw.abiRethrow(
+        abi::create_value_or_error, [&]() -> jsi_value_or_error {
+          facebook::jsi::Value result = wrapper->indexed_->getIndex(rtw, index);
+          return abi::create_value_or_error(rtw.cloneToABIValue(result));
+        });
+  }
+
+  static jsi_error_code JSI_CDECL setIndex(
+      jsi_host_object *self,
+      jsi_runtime * /*abiRt*/,
+      uint32_t index,
+      const jsi_value *value) {
+    auto *wrapper = static_cast<HostObjectWrapper *>(self);
+    auto &rtw = wrapper->rtw_;
+    return rtw.abiRethrow(abi::identity_error, [&]() -> jsi_error_code {
+      facebook::jsi::Value jsiVal = rtw.cloneToJSIValue(*value);
+      wrapper->indexed_->setIndex(rtw, index, jsiVal);
+      return jsi_no_error;
+    });
+  }
+
+  static jsi_size_or_error JSI_CDECL getLength(
+      jsi_host_object *self,
+      jsi_runtime * /*abiRt*/) {
+    auto *wrapper = static_cast<HostObjectWrapper *>(self);
+    auto &rtw = wrapper->rtw_;
+    return rtw.abiRethrow(abi::create_size_or_error, [&]() -> jsi_size_or_error {
+      return abi::create_size_or_error(
+          static_cast<size_t>(wrapper->indexed_->length(rtw)));
+    });
+  }
 };
 
 //==============================================================================
@@ -730,6 +859,39 @@ facebook::jsi::Value JsiAbiRuntime::cloneToJSIValue(const jsi_value &val) {
   }
 }
 
+facebook::jsi::Value JsiAbiRuntime::borrowToJSIValue(
+    const jsi_value &val,
+    ManagedPointerHolder *holderStorage) {
+  switch (abi::get_value_kind(val)) {
+    case jsi_valuekind_undefined:
+      return facebook::jsi::Value::undefined();
+    case jsi_valuekind_null:
+      return facebook::jsi::Value::null();
+    case jsi_valuekind_boolean:
+      return facebook::jsi::Value(abi::get_bool_value(val));
+    case jsi_valuekind_number:
+      return facebook::jsi::Value(abi::get_number_value(val));
+    case jsi_valuekind_string:
+      return facebook::jsi::Value(
+          make<facebook::jsi::String>(new (holderStorage) ManagedPointerHolder(
+              val.data.pointer, ManagedPointerHolder::Borrowed{})));
+    case jsi_valuekind_object:
+      return facebook::jsi::Value(
+          make<facebook::jsi::Object>(new (holderStorage) ManagedPointerHolder(
+              val.data.pointer, ManagedPointerHolder::Borrowed{})));
+    case jsi_valuekind_symbol:
+      return facebook::jsi::Value(
+          make<facebook::jsi::Symbol>(new (holderStorage) ManagedPointerHolder(
+              val.data.pointer, ManagedPointerHolder::Borrowed{})));
+    case jsi_valuekind_bigint:
+      return facebook::jsi::Value(
+          make<facebook::jsi::BigInt>(new (holderStorage) ManagedPointerHolder(
+              val.data.pointer, ManagedPointerHolder::Borrowed{})));
+    default:
+      return facebook::jsi::Value::undefined();
+  }
+}
+
 facebook::jsi::Value JsiAbiRuntime::intoJSIValue(jsi_value val) {
   switch (abi::get_value_kind(val)) {
     case jsi_valuekind_undefined:
@@ -854,8 +1016,13 @@ JsiAbiRuntime::prepareJavaScript(
     const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
     std::string sourceURL) {
   auto *abiBuf = new BufferWrapper(buffer);
-  auto result = vt_->prepare_javascript(
-      abiRt_, abiBuf, sourceURL.c_str(), sourceURL.size());
+  return adoptPreparedJavaScript(vt_->prepare_javascript(
+      abiRt_, abiBuf, sourceURL.c_str(), sourceURL.size()));
+}
+
+std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+JsiAbiRuntime::adoptPreparedJavaScript(
+    jsi_prepared_javascript_or_error result) {
   checkResult(result);
   auto wrapper = std::make_shared<PreparedJSWrapper>();
   wrapper->prepared = abi::get_prepared_javascript(result);
@@ -915,6 +1082,21 @@ bool JsiAbiRuntime::isInspectable() {
   return vt_->is_inspectable(abiRt_);
 }
 
+#if JSI_VERSION >= 20
+facebook::jsi::ICast *JsiAbiRuntime::castInterface(
+    const facebook::jsi::UUID &interfaceUUID) {
+  if (interfaceUUID == IIndexedHostObjectFactory::uuid)
+    return &indexedHostObjectFactory_;
+  if (interfaceUUID == IScriptStoreRuntime::uuid)
+    return &scriptStoreRuntime_;
+  if (interfaceUUID == IAsyncPrepareRuntime::uuid)
+    return &asyncPrepareRuntime_;
+  if (interfaceUUID == IStartupCompleteRuntime::uuid)
+    return &startupCompleteRuntime_;
+  return Runtime::castInterface(interfaceUUID);
+}
+#endif
+
 //==============================================================================
 // Clone operations
 //==============================================================================
@@ -1083,6 +1265,46 @@ std::string JsiAbiRuntime::utf8(const facebook::jsi::String &str) {
   return std::move(gb).get();
 }
 
+#if JSI_VERSION >= 16
+namespace {
+
+// Adapts a JSI string-data callback to jsi_string_data_cb, which carries the
+// ABI calling convention.
+struct StringDataCallback {
+  void *ctx;
+  void (*cb)(void *ctx, bool ascii, const void *data, size_t num);
+
+  static void JSI_CDECL invoke(
+      void *self,
+      bool ascii,
+      const void *data,
+      size_t num) {
+    auto *callback = static_cast<StringDataCallback *>(self);
+    callback->cb(callback->ctx, ascii, data, num);
+  }
+};
+
+} // namespace
+
+void JsiAbiRuntime::getStringData(
+    const facebook::jsi::String &str,
+    void *ctx,
+    void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
+  StringDataCallback callback{ctx, cb};
+  vt_->get_string_data(
+      abiRt_, toABIString(str), &callback, &StringDataCallback::invoke);
+}
+
+void JsiAbiRuntime::getPropNameIdData(
+    const facebook::jsi::PropNameID &sym,
+    void *ctx,
+    void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
+  StringDataCallback callback{ctx, cb};
+  vt_->get_propnameid_data(
+      abiRt_, toABIPropNameID(sym), &callback, &StringDataCallback::invoke);
+}
+#endif
+
 //==============================================================================
 // Object operations
 //==============================================================================
@@ -1108,11 +1330,23 @@ std::shared_ptr<facebook::jsi::HostObject> JsiAbiRuntime::getHostObject(
   auto *ho = vt_->get_host_object(abiRt_, toABIObject(obj));
   if (!ho)
     return nullptr;
-  if (ho->vtable == HostObjectWrapper::getVt())
+  if (HostObjectWrapper::isWrapper(ho))
     return static_cast<HostObjectWrapper *>(ho)->getHostObject();
   return nullptr;
 }
 
+#if JSI_VERSION >= 20
+facebook::jsi::Object
+JsiAbiRuntime::IndexedHostObjectFactory::createIndexedHostObject(
+    std::shared_ptr<IndexedHostObject> ho) {
+  auto *wrapper = new HostObjectWrapper(rt_, std::move(ho));
+  auto result = rt_.vt_->create_object_from_host_object(rt_.abiRt_, wrapper);
+  rt_.checkResult(result);
+  return make<facebook::jsi::Object>(
+      new ManagedPointerHolder(abi::get_object(result).pointer));
+}
+#endif
+
 facebook::jsi::HostFunctionType &JsiAbiRuntime::getHostFunction(
     const facebook::jsi::Function &fn) {
   auto *hf = vt_->get_host_function(abiRt_, toABIFunction(fn));
@@ -1255,7 +1489,7 @@ bool JsiAbiRuntime::isFunction(const facebook::jsi::Object &obj) const {
 bool JsiAbiRuntime::isHostObject(
     const facebook::jsi::Object &obj) const {
   auto *ho = vt_->get_host_object(abiRt_, toABIObject(obj));
-  return ho && ho->vtable == HostObjectWrapper::getVt();
+  return ho && HostObjectWrapper::isWrapper(ho);
 }
 
 bool JsiAbiRuntime::isHostFunction(
@@ -1378,9 +1612,10 @@ facebook::jsi::Value JsiAbiRuntime::call(
     const facebook::jsi::Value &jsThis,
     const facebook::jsi::Value *args,
     size_t count) {
-  std::vector<jsi_value> abiArgs(count);
-  for (size_t i = 0; i < count; ++i)
-    abiArgs[i] = toABIValue(args[i]);
+  CallArgs<jsi_value> abiArgs(
+      args, count, [this](const facebook::jsi::Value &arg) {
+        return toABIValue(arg);
+      });
   jsi_value abiThis = toABIValue(jsThis);
   auto result = vt_->call(
       abiRt_, toABIFunction(fn), &abiThis, abiArgs.data(), count);
@@ -1393,9 +1628,10 @@ facebook::jsi::Value JsiAbiRuntime::callAsConstructor(
     const facebook::jsi::Function &fn,
     const facebook::jsi::Value *args,
     size_t count) {
-  std::vector<jsi_value> abiArgs(count);
-  for (size_t i = 0; i < count; ++i)
-    abiArgs[i] = toABIValue(args[i]);
+  CallArgs<jsi_value> abiArgs(
+      args, count, [this](const facebook::jsi::Value &arg) {
+        return toABIValue(arg);
+      });
   auto result = vt_->call_as_constructor(
       abiRt_, toABIFunction(fn), abiArgs.data(), count);
   if (abi::is_error(result))
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Repeated calls of one JS function from native code.
+//
+// Event dispatch loops call the same function with the same receiver over and
+// over. A PreparedCall pins the function and receiver once and owns a single
+// argument frame that every call reuses: setting an argument replaces the Value
+// in its slot, and call() hands the frame straight to the runtime. Together
+// with the runtimes' inline argument arrays, a dispatch loop does no per-call
+// heap allocation on the native side.
+//
+// Engine-agnostic and header-only, like IndexedHostObject.h. A PreparedCall is
+// bound to the runtime it was created on and, like any jsi::Value, must only be
+// used on that runtime's JS thread.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace jsi::abi {
+
+class PreparedCall {
+ public:
+  // Calls fn with an undefined receiver.
+  PreparedCall(
+      facebook::jsi::Runtime &rt,
+      facebook::jsi::Function fn,
+      size_t argCount)
+      : rt_(rt), fn_(std::move(fn)), frame_(argCount) {}
+
+  // Calls fn with receiver as `this`.
+  PreparedCall(
+      facebook::jsi::Runtime &rt,
+      facebook::jsi::Function fn,
+      facebook::jsi::Object receiver,
+      size_t argCount)
+      : rt_(rt),
+        fn_(std::move(fn)),
+        receiver_(std::move(receiver)),
+        frame_(argCount) {}
+
+  PreparedCall(const PreparedCall &) = delete;
+  PreparedCall &operator=(const PreparedCall &) = delete;
+  PreparedCall(PreparedCall &&) = default;
+
+  size_t argCount() const noexcept {
+    return frame_.size();
+  }
+
+  // Slot of the argument at index. Its value is kept between calls, so
+  // arguments that do not change need to be set only once.
+  facebook::jsi::Value &arg(size_t index) {
+    return frame_.at(index);
+  }
+
+  // Calls the function with the current frame.
+  facebook::jsi::Value call() {
+    // Through a const pointer, so the (args, count) overloads are chosen over
+    // the variadic ones.
+    const facebook::jsi::Value *args = frame_.data();
+    if (receiver_)
+      return fn_.callWithThis(rt_, *receiver_, args, frame_.size());
+    return fn_.call(rt_, args, frame_.size());
+  }
+
+  // Stores args in the first sizeof...(args) slots, then calls the function.
+  // Slots past the given arguments keep their values.
+  template <typename... Args>
+  facebook::jsi::Value operator()(Args &&...args) {
+    static_assert(sizeof...(Args) > 0, "use call() to reuse the frame as is");
+    if (sizeof...(Args) > frame_.size())
+      throw facebook::jsi::JSINativeException(
+          "PreparedCall: more arguments than the frame holds");
+    size_t index = 0;
+    ((frame_[index++] =
+          facebook::jsi::detail::toValue(rt_, std::forward<Args>(args))),
+     ...);
+    return call();
+  }
+
+  // Drops the references held by the frame; every slot becomes undefined.
+  void clearArgs() noexcept {
+    for (facebook::jsi::Value &value : frame_)
+      value = facebook::jsi::Value();
+  }
+
+ private:
+  facebook::jsi::Runtime &rt_;
+  facebook::jsi::Function fn_;
+  std::optional<facebook::jsi::Object> receiver_;
+  std::vector<facebook::jsi::Value> frame_;
+};
+
+} // namespace jsi::abi
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Bounded per-runtime cache of internalized property-name strings.
+//
+// Native modules create the same PropNameIDs (PropNameID::forAscii(rt, "foo"))
+// over and over; without a cache each call allocates a V8 string and looks it
+// up in the isolate's string table. The intern table keeps the internalized
+// string for recently used names in a v8::Global, keyed by the name's bytes,
+// so a repeated name costs one hash and one memcmp.
+//
+// The table is direct-mapped: each name hashes to exactly one slot and a
+// colliding name replaces the previous occupant. That bounds both memory and
+// the number of strings kept alive, and needs no LRU bookkeeping on the hit
+// path. Long names are never cached; they are rarely hot and would make the
+// key comparison the dominant cost.
+//
+// Not thread-safe: callers hold the isolate (the runtime's JS thread or its
+// v8::Locker). Exception-free apart from std::bad_alloc, like the rest of the
+// ABI implementation.
+
+#pragma once
+
+#include "v8.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace v8rt_internal {
+
+class PropNameInternTable {
+ public:
+  static constexpr size_t kSlotCount = 512; // power of two
+  static constexpr size_t kMaxNameLength = 64;
+
+  PropNameInternTable() = default;
+  PropNameInternTable(const PropNameInternTable &) = delete;
+  PropNameInternTable &operator=(const PropNameInternTable &) = delete;
+
+  /// Returns the internalized string for name, creating it with
+  /// create(isolate, name) on a miss. create must return an internalized
+  /// string (v8::NewStringType::kInternalized). An empty result from create is
+  /// passed through and not cached.
+  template <typename CreateFn>
+  v8::MaybeLocal<v8::String>
+  get(v8::Isolate *isolate, std::string_view name, CreateFn &&create) {
+    if (name.size() > kMaxNameLength) {
+      ++misses_;
+      return create(isolate, name);
+    }
+
+    if (!slots_)
+      slots_ = std::make_unique<Slot[]>(kSlotCount);
+    Slot &slot = slots_[std::hash<std::string_view>{}(name) & (kSlotCount - 1)];
+    if (!slot.value.IsEmpty() && slot.key == name) {
+      ++hits_;
+      return slot.value.Get(isolate);
+    }
+
+    ++misses_;
+    v8::Local<v8::String> value;
+    if (!create(isolate, name).ToLocal(&value))
+      return {};
+    slot.key.assign(name.data(), name.size());
+    slot.value.Reset(isolate, value);
+    return value;
+  }
+
+  /// Releases every cached string. Must run before the isolate is disposed.
+  void clear() noexcept { slots_.reset(); }
+
+  uint64_t hits() const noexcept { return hits_; }
+  uint64_t misses() const noexcept { return misses_; }
+
+ private:
+  struct Slot {
+    std::string key;
+    v8::Global<v8::String> value;
+  };
+
+  // Allocated on first use so runtimes that never create names pay nothing.
+  std::unique_ptr<Slot[]> slots_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace v8rt_internal
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Evaluating scripts by URL from the runtime's facebook::jsi::ScriptStore.
+//
+// prepareJavaScript(buffer, url) keys the code cache on a hash of the whole
+// source, so every warm start reads every byte of the bundle before V8 needs
+// any of it. A runtime created with a ScriptStore (V8RuntimeArgs::scriptStore)
+// can instead load a script by URL: the store hands over the bytes together
+// with the embedder's version for them, and that version is the code cache
+// key.
+//
+// A runtime without a ScriptStore, or one that cannot load by URL, makes
+// prepareJavaScriptFromStore throw; a host that may run on either loads the
+// bytes itself and calls prepareJavaScript.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <memory>
+#include <string>
+
+namespace jsi::abi {
+
+#if JSI_VERSION >= 20
+// Runtime interface behind prepareJavaScriptFromStore.
+struct IScriptStoreRuntime : facebook::jsi::ICast {
+  static constexpr facebook::jsi::UUID uuid{
+      0x3e7a9d15,
+      0x52c8,
+      0x4b0e,
+      0xa4f3,
+      0x91d6c27b5e08};
+
+  // Throws JSINativeException if the runtime has no ScriptStore or the store
+  // has no script for sourceURL.
+  virtual std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+  prepareJavaScriptFromStore(const std::string &sourceURL) = 0;
+
+ protected:
+  ~IScriptStoreRuntime() = default;
+};
+#endif
+
+// Prepares the script the runtime's ScriptStore holds for sourceURL.
+inline std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+prepareJavaScriptFromStore(
+    facebook::jsi::Runtime &rt,
+    const std::string &sourceURL) {
+#if JSI_VERSION >= 20
+  if (auto *store = facebook::jsi::castInterface<IScriptStoreRuntime>(&rt))
+    return store->prepareJavaScriptFromStore(sourceURL);
+#endif
+  throw facebook::jsi::JSINativeException(
+      "Runtime does not support loading scripts from a ScriptStore");
+}
+
+// Evaluates the script the runtime's ScriptStore holds for sourceURL.
+inline facebook::jsi::Value evaluateJavaScriptFromStore(
+    facebook::jsi::Runtime &rt,
+    const std::string &sourceURL) {
+  return rt.evaluatePreparedJavaScript(
+      prepareJavaScriptFromStore(rt, sourceURL));
+}
+
+} // namespace jsi::abi
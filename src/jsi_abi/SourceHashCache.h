@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Remembers the hashes of script sources that are still wrapped in place.
+//
+// prepareJavaScript hashes the whole source for the code cache key. Hosts
+// often hand the same buffer to the runtime more than once (evaluate after
+// prepare, reload of a cached bundle), and for multi-megabyte bundles the
+// hash is a visible part of the call. A buffer's address alone cannot be
+// trusted, since the memory may have been freed and reused; but while the
+// external string that wraps an ASCII source in place is alive, it owns the
+// source bytes, so the same address and size still mean the same bytes. The
+// cache holds a weak handle to that string and forgets the entry once V8
+// collects it.
+//
+// Not thread-safe: callers hold the isolate. Exception-free apart from
+// std::bad_alloc, like the rest of the ABI implementation.
+
+#pragma once
+
+#include "v8.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace v8rt_internal {
+
+class SourceHashCache {
+ public:
+  SourceHashCache() = default;
+  SourceHashCache(const SourceHashCache &) = delete;
+  SourceHashCache &operator=(const SourceHashCache &) = delete;
+
+  /// Sets hash to the remembered hash of [data, data + size) and returns
+  /// true if the string wrapping those bytes is still alive. A hit implies
+  /// the bytes are ASCII.
+  bool lookup(const uint8_t *data, size_t size, uint64_t &hash) noexcept {
+    for (Entry &entry : entries_) {
+      if (entry.data == data && entry.size == size && !entry.source.IsEmpty()) {
+        hash = entry.hash;
+        ++hits_;
+        return true;
+      }
+    }
+    ++misses_;
+    return false;
+  }
+
+  /// Remembers hash for [data, data + size) if source wraps exactly those
+  /// bytes in place. Replaces the oldest entry when the cache is full.
+  void remember(
+      v8::Isolate *isolate,
+      const uint8_t *data,
+      size_t size,
+      uint64_t hash,
+      v8::Local<v8::String> source) {
+    if (!source->IsExternalOneByte() ||
+        source->GetExternalOneByteStringResource()->data() !=
+            reinterpret_cast<const char *>(data))
+      return;
+    Entry &entry = entries_[next_];
+    next_ = (next_ + 1) % entries_.size();
+    entry.data = data;
+    entry.size = size;
+    entry.hash = hash;
+    entry.source.Reset(isolate, source);
+    entry.source.SetWeak();
+  }
+
+  /// Drops every entry. Must run before the isolate is disposed.
+  void clear() noexcept {
+    for (Entry &entry : entries_)
+      entry.source.Reset();
+  }
+
+  size_t hits() const noexcept { return hits_; }
+  size_t misses() const noexcept { return misses_; }
+
+ private:
+  struct Entry {
+    const uint8_t *data{nullptr};
+    size_t size{0};
+    uint64_t hash{0};
+    // Weak; V8 resets it when the string is collected.
+    v8::Global<v8::String> source;
+  };
+
+  std::array<Entry, 4> entries_;
+  size_t next_{0};
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+} // namespace v8rt_internal
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Telling the runtime that the host has finished starting up.
+//
+// Some of what a runtime learns while an app starts is only worth keeping
+// once startup is over: V8 compiles functions lazily, so a code cache written
+// right after a script is compiled covers little more than its top level,
+// while one written after startup covers every function startup ran.
+// notifyStartupComplete marks that point; a V8 runtime created with
+// V8RuntimeArgs::flags.warmCodeCache then stores warm code caches.
+//
+// notifyStartupComplete does nothing on a runtime that has no use for the
+// signal, so hosts can call it unconditionally once their first screen is up.
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+namespace jsi::abi {
+
+#if JSI_VERSION >= 20
+// Runtime interface behind notifyStartupComplete.
+struct IStartupCompleteRuntime : facebook::jsi::ICast {
+  static constexpr facebook::jsi::UUID uuid{
+      0x5d2b8e61,
+      0xa4c7,
+      0x4f19,
+      0x8e3d,
+      0x06b1f7a9c245};
+
+  // Call on the JS thread. Calls after the first do nothing.
+  virtual void notifyStartupComplete() = 0;
+
+ protected:
+  ~IStartupCompleteRuntime() = default;
+};
+#endif
+
+// Tells rt that the host has finished starting up. Does nothing for a
+// runtime without the interface.
+inline void notifyStartupComplete(facebook::jsi::Runtime &rt) {
+#if JSI_VERSION >= 20
+  if (auto *startup =
+          facebook::jsi::castInterface<IStartupCompleteRuntime>(&rt))
+    startup->notifyStartupComplete();
+#else
+  (void)rt;
+#endif
+}
+
+} // namespace jsi::abi
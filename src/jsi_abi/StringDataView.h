@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Zero-copy access to a V8 string's characters for Runtime::getStringData.
+//
+// The default jsi::Runtime::getStringData materializes a std::u16string for
+// every call. V8 already keeps flat strings as one-byte or two-byte arrays, so
+// visitStringData hands the callback that storage directly through
+// v8::String::ValueView: two-byte strings in one UTF-16 chunk, one-byte strings
+// as ASCII chunks. JSI's "ascii" flag means 7-bit ASCII, while a V8 one-byte
+// string is Latin-1, so the part of a one-byte string from its first non-ASCII
+// character on is widened to UTF-16 through a small stack buffer.
+//
+// The ValueView disallows GC for its lifetime; the callback must not touch the
+// runtime, as the JSI contract already requires. Callers hold the isolate and
+// an open HandleScope.
+
+#pragma once
+
+#include "v8.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace v8rt_internal {
+
+/// Invokes cb(bool ascii, const void *data, size_t num) one or more times with
+/// consecutive chunks of str. Calls cb once with an empty ASCII chunk if str is
+/// empty.
+template <typename Callback>
+void visitStringData(
+    v8::Isolate *isolate,
+    v8::Local<v8::String> str,
+    Callback &&cb) {
+  v8::String::ValueView view(isolate, str);
+  size_t length = view.length();
+  if (!view.is_one_byte()) {
+    cb(false, static_cast<const void *>(view.data16()), length);
+    return;
+  }
+
+  const uint8_t *chars = view.data8();
+  size_t ascii = 0;
+  while (ascii < length && chars[ascii] < 0x80)
+    ++ascii;
+  if (ascii > 0 || length == 0)
+    cb(true, static_cast<const void *>(chars), ascii);
+
+  constexpr size_t kChunkSize = 256;
+  char16_t wide[kChunkSize];
+  for (size_t pos = ascii; pos < length;) {
+    size_t count = std::min(kChunkSize, length - pos);
+    std::copy(chars + pos, chars + pos + count, wide);
+    cb(false, static_cast<const void *>(wide), count);
+    pos += count;
+  }
+}
+
+/// The string a PropNameID's data is read from: the name itself, or a
+/// symbol's description. Empty for a symbol without a string description.
+inline v8::Local<v8::String> propNameString(
+    v8::Isolate *isolate,
+    v8::Local<v8::Value> name) {
+  if (name->IsString())
+    return name.As<v8::String>();
+  if (name->IsSymbol()) {
+    v8::Local<v8::Value> desc = name.As<v8::Symbol>()->Description(isolate);
+    if (desc->IsString())
+      return desc.As<v8::String>();
+  }
+  return v8::String::Empty(isolate);
+}
+
+} // namespace v8rt_internal
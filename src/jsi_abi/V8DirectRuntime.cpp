@@ -0,0 +1,1979 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// V8DirectRuntime — facebook::jsi::Runtime implemented directly on V8 inside
+// v8jsi.dll. See V8DirectRuntime.h for when a consumer may opt in.
+//
+// The runtime owns one ref on a jsi_runtime created by v8_create_runtime and
+// shares its isolate and context (reached through v8rt_internal). Every hot
+// operation — strings, property names, properties, arrays, calls, host
+// functions and host objects — goes straight to V8, and each jsi handle is a
+// single V8PointerValue holding a v8::Global. Script evaluation and prepared
+// scripts are delegated to the jsi_runtime so the script cache and source
+// handling stay in one place.
+//
+// Unlike jsi_abi_v8.cpp this TU uses C++ exceptions: it implements
+// facebook::jsi::Runtime, whose contract is to throw JSError /
+// JSINativeException. Exceptions never propagate through V8 frames; the V8
+// callbacks below translate them into JS exceptions.
+
+#include "jsi_abi/V8DirectRuntime.h"
+
+#include "jsi_abi/AbiRuntimeArgs.h"
+#include "jsi_abi/AbiRuntimeInterfaces.h"
+#include "jsi_abi/AsyncPrepareRuntime.h"
+#include "jsi_abi/IndexedHostObject.h"
+#include "jsi_abi/ScriptStoreRuntime.h"
+#include "jsi_abi/StartupCompleteRuntime.h"
+#include "jsi_abi/StringDataView.h"
+#include "jsi_abi/jsi_abi.h"
+#include "jsi_abi/jsi_abi_helpers.h"
+#include "jsi_abi/jsi_abi_v8_internal.h"
+#include "jsi_abi/v8_jsi_config.h"
+#include "v8_string.h"
+#include "V8Instrumentation.h"
+
+#include <cstring>
+#include <list>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace v8runtime {
+
+namespace abi = ::jsi::abi;
+
+using ::jsi::abi::IAsyncPrepareRuntime;
+using ::jsi::abi::IIndexedHostObjectFactory;
+using ::jsi::abi::InterfaceAdapter;
+using ::jsi::abi::IndexedHostObject;
+using ::jsi::abi::IScriptStoreRuntime;
+using ::jsi::abi::IStartupCompleteRuntime;
+
+namespace {
+
+//==============================================================================
+// Helpers
+//==============================================================================
+
+// Growable buffer backed by std::string, for the delegated ABI calls that
+// report text.
+struct StringBuffer : public jsi_growable_buffer {
+  std::string buf_;
+
+  StringBuffer() : buf_(256, '\0') {
+    static const jsi_growable_buffer_vtable bufVt{&tryGrowTo};
+    vtable = const_cast<jsi_growable_buffer_vtable *>(&bufVt);
+    data = reinterpret_cast<uint8_t *>(buf_.data());
+    size = buf_.size();
+    used = 0;
+  }
+
+  static void JSI_CDECL tryGrowTo(jsi_growable_buffer *buf, size_t sz) {
+    auto *self = static_cast<StringBuffer *>(buf);
+    if (sz > self->buf_.size()) {
+      self->buf_.resize(sz);
+      buf->data = reinterpret_cast<uint8_t *>(self->buf_.data());
+      buf->size = self->buf_.size();
+    }
+  }
+
+  std::string get() && {
+    buf_.resize(used);
+    return std::move(buf_);
+  }
+};
+
+// Hands a facebook::jsi::Buffer to the delegated evaluate/prepare entry points,
+// which take ownership of the jsi_buffer.
+struct BufferWrapper : public jsi_buffer {
+  std::shared_ptr<const facebook::jsi::Buffer> buf_;
+
+  explicit BufferWrapper(std::shared_ptr<const facebook::jsi::Buffer> buf)
+      : buf_(std::move(buf)) {
+    static const jsi_buffer_vtable bufVt{&release};
+    vtable = const_cast<jsi_buffer_vtable *>(&bufVt);
+    data = buf_->data();
+    size = buf_->size();
+  }
+
+  static void JSI_CDECL release(jsi_buffer *self) {
+    delete static_cast<BufferWrapper *>(self);
+  }
+};
+
+struct PreparedScriptWrapper : public facebook::jsi::PreparedJavaScript {
+  jsi_prepared_javascript *prepared;
+
+  explicit PreparedScriptWrapper(jsi_prepared_javascript *p) : prepared(p) {}
+  ~PreparedScriptWrapper() override { prepared->vtable->release(prepared); }
+};
+
+template <typename T>
+struct SaveAndRestore {
+  T &target_;
+  T oldVal_;
+  explicit SaveAndRestore(T &target) : target_(target), oldVal_(target) {}
+  ~SaveAndRestore() { target_ = oldVal_; }
+};
+
+std::string toUtf8(v8::Isolate *isolate, v8::Local<v8::String> str) {
+  return v8rt::toUtf8String(isolate, str);
+}
+
+//==============================================================================
+// V8DirectRuntime
+//==============================================================================
+
+class V8DirectRuntime final : public facebook::jsi::Runtime {
+ public:
+  // Adopts one ref on abiRuntime; the destructor releases it.
+  explicit V8DirectRuntime(jsi_runtime *abiRuntime);
+  ~V8DirectRuntime() override;
+
+  V8DirectRuntime(const V8DirectRuntime &) = delete;
+  V8DirectRuntime &operator=(const V8DirectRuntime &) = delete;
+
+  facebook::jsi::Value evaluateJavaScript(
+      const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+      const std::string &sourceURL) override;
+
+  std::shared_ptr<const facebook::jsi::PreparedJavaScript> prepareJavaScript(
+      const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+      std::string sourceURL) override;
+
+  facebook::jsi::Value evaluatePreparedJavaScript(
+      const std::shared_ptr<const facebook::jsi::PreparedJavaScript> &js)
+      override;
+
+#if JSI_VERSION >= 4
+  bool drainMicrotasks(int maxMicrotasksHint = -1) override;
+#endif
+
+#if JSI_VERSION >= 12
+  void queueMicrotask(const facebook::jsi::Function &callback) override;
+#endif
+
+  facebook::jsi::Object global() override;
+  std::string description() override;
+  bool isInspectable() override;
+  facebook::jsi::Instrumentation &instrumentation() override;
+
+#if JSI_VERSION >= 20
+  facebook::jsi::ICast *castInterface(
+      const facebook::jsi::UUID &interfaceUUID) override;
+#endif
+
+  // For the runtime interface adapters (AbiRuntimeInterfaces.h).
+  jsi_runtime *abiRuntime() const noexcept { return abiRt_; }
+  std::weak_ptr<V8DirectRuntime *> weakSelf() const noexcept { return self_; }
+  static jsi_buffer *wrapBuffer(
+      std::shared_ptr<const facebook::jsi::Buffer> buffer) {
+    return new BufferWrapper(std::move(buffer));
+  }
+  std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+  adoptPreparedJavaScript(jsi_prepared_javascript_or_error result);
+
+ protected:
+  PointerValue *cloneSymbol(const PointerValue *pv) override;
+  PointerValue *cloneString(const PointerValue *pv) override;
+#if JSI_VERSION >= 6
+  PointerValue *cloneBigInt(const PointerValue *pv) override;
+#endif
+  PointerValue *cloneObject(const PointerValue *pv) override;
+  PointerValue *clonePropNameID(const PointerValue *pv) override;
+
+  facebook::jsi::PropNameID createPropNameIDFromAscii(
+      const char *str,
+      size_t length) override;
+  facebook::jsi::PropNameID createPropNameIDFromUtf8(
+      const uint8_t *utf8,
+      size_t length) override;
+  facebook::jsi::PropNameID createPropNameIDFromString(
+      const facebook::jsi::String &str) override;
+#if JSI_VERSION >= 5
+  facebook::jsi::PropNameID createPropNameIDFromSymbol(
+      const facebook::jsi::Symbol &sym) override;
+#endif
+  std::string utf8(const facebook::jsi::PropNameID &) override;
+  bool compare(
+      const facebook::jsi::PropNameID &,
+      const facebook::jsi::PropNameID &) override;
+
+  std::string symbolToString(const facebook::jsi::Symbol &) override;
+
+#if JSI_VERSION >= 8
+  facebook::jsi::BigInt createBigIntFromInt64(int64_t) override;
+  facebook::jsi::BigInt createBigIntFromUint64(uint64_t) override;
+  bool bigintIsInt64(const facebook::jsi::BigInt &) override;
+  bool bigintIsUint64(const facebook::jsi::BigInt &) override;
+  uint64_t truncate(const facebook::jsi::BigInt &) override;
+  facebook::jsi::String bigintToString(
+      const facebook::jsi::BigInt &,
+      int) override;
+#endif
+
+  facebook::jsi::String createStringFromAscii(
+      const char *str,
+      size_t length) override;
+  facebook::jsi::String createStringFromUtf8(
+      const uint8_t *utf8,
+      size_t length) override;
+#if JSI_VERSION >= 19
+  facebook::jsi::String createStringFromUtf16(
+      const char16_t *utf16,
+      size_t length) override;
+#endif
+  std::string utf8(const facebook::jsi::String &) override;
+
+#if JSI_VERSION >= 16
+  void getStringData(
+      const facebook::jsi::String &str,
+      void *ctx,
+      void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) override;
+  void getPropNameIdData(
+      const facebook::jsi::PropNameID &sym,
+      void *ctx,
+      void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) override;
+#endif
+
+  facebook::jsi::Object createObject() override;
+  facebook::jsi::Object createObject(
+      std::shared_ptr<facebook::jsi::HostObject> ho) override;
+  std::shared_ptr<facebook::jsi::HostObject> getHostObject(
+      const facebook::jsi::Object &) override;
+  facebook::jsi::HostFunctionType &getHostFunction(
+      const facebook::jsi::Function &) override;
+
+#if JSI_VERSION >= 7
+  bool hasNativeState(const facebook::jsi::Object &) override;
+  std::shared_ptr<facebook::jsi::NativeState> getNativeState(
+      const facebook::jsi::Object &) override;
+  void setNativeState(
+      const facebook::jsi::Object &,
+      std::shared_ptr<facebook::jsi::NativeState> state) override;
+#endif
+
+#if JSI_VERSION >= 17
+  void setPrototypeOf(
+      const facebook::jsi::Object &object,
+      const facebook::jsi::Value &prototype) override;
+  facebook::jsi::Value getPrototypeOf(
+      const facebook::jsi::Object &object) override;
+#endif
+
+  facebook::jsi::Value getProperty(
+      const facebook::jsi::Object &,
+      const facebook::jsi::PropNameID &name) override;
+  facebook::jsi::Value getProperty(
+      const facebook::jsi::Object &,
+      const facebook::jsi::String &name) override;
+  bool hasProperty(
+      const facebook::jsi::Object &,
+      const facebook::jsi::PropNameID &name) override;
+  bool hasProperty(
+      const facebook::jsi::Object &,
+      const facebook::jsi::String &name) override;
+  void setPropertyValue(
+      JSI_CONST_10 facebook::jsi::Object &,
+      const facebook::jsi::PropNameID &name,
+      const facebook::jsi::Value &value) override;
+  void setPropertyValue(
+      JSI_CONST_10 facebook::jsi::Object &,
+      const facebook::jsi::String &name,
+      const facebook::jsi::Value &value) override;
+
+  bool isArray(const facebook::jsi::Object &) const override;
+  bool isArrayBuffer(const facebook::jsi::Object &) const override;
+  bool isFunction(const facebook::jsi::Object &) const override;
+  bool isHostObject(const facebook::jsi::Object &) const override;
+  bool isHostFunction(const facebook::jsi::Function &) const override;
+  facebook::jsi::Array getPropertyNames(
+      const facebook::jsi::Object &) override;
+
+  facebook::jsi::WeakObject createWeakObject(
+      const facebook::jsi::Object &) override;
+  facebook::jsi::Value lockWeakObject(
+      JSI_NO_CONST_3 JSI_CONST_10 facebook::jsi::WeakObject &) override;
+
+  facebook::jsi::Array createArray(size_t length) override;
+#if JSI_VERSION >= 9
+  facebook::jsi::ArrayBuffer createArrayBuffer(
+      std::shared_ptr<facebook::jsi::MutableBuffer> buffer) override;
+#endif
+  size_t size(const facebook::jsi::Array &) override;
+  size_t size(const facebook::jsi::ArrayBuffer &) override;
+  uint8_t *data(const facebook::jsi::ArrayBuffer &) override;
+  facebook::jsi::Value getValueAtIndex(
+      const facebook::jsi::Array &,
+      size_t i) override;
+  void setValueAtIndexImpl(
+      JSI_CONST_10 facebook::jsi::Array &,
+      size_t i,
+      const facebook::jsi::Value &value) override;
+
+  facebook::jsi::Function createFunctionFromHostFunction(
+      const facebook::jsi::PropNameID &name,
+      unsigned int paramCount,
+      facebook::jsi::HostFunctionType func) override;
+  facebook::jsi::Value call(
+      const facebook::jsi::Function &,
+      const facebook::jsi::Value &jsThis,
+      const facebook::jsi::Value *args,
+      size_t count) override;
+  facebook::jsi::Value callAsConstructor(
+      const facebook::jsi::Function &,
+      const facebook::jsi::Value *args,
+      size_t count) override;
+
+  bool strictEquals(
+      const facebook::jsi::Symbol &a,
+      const facebook::jsi::Symbol &b) const override;
+#if JSI_VERSION >= 6
+  bool strictEquals(
+      const facebook::jsi::BigInt &a,
+      const facebook::jsi::BigInt &b) const override;
+#endif
+  bool strictEquals(
+      const facebook::jsi::String &a,
+      const facebook::jsi::String &b) const override;
+  bool strictEquals(
+      const facebook::jsi::Object &a,
+      const facebook::jsi::Object &b) const override;
+
+  bool instanceOf(
+      const facebook::jsi::Object &o,
+      const facebook::jsi::Function &f) override;
+
+#if JSI_VERSION >= 11
+  void setExternalMemoryPressure(
+      const facebook::jsi::Object &,
+      size_t) override;
+#endif
+
+ private:
+  class V8PointerValue;
+  class V8WeakValue;
+  class Scope;
+  class IsolateLock;
+  struct HostFunctionContext;
+  struct HostObjectProxy;
+  struct NativeStateHolder;
+  struct HostRegistry;
+
+  // Value conversion. toLocal requires an open Scope; toValue creates an
+  // owning V8PointerValue for pointer kinds.
+  v8::Local<v8::Value> toLocal(const PointerValue *pv) const;
+  v8::Local<v8::Value> toLocal(const facebook::jsi::Pointer &ptr) const {
+    return toLocal(getPointerValue(ptr));
+  }
+  v8::Local<v8::Object> toObject(const facebook::jsi::Pointer &ptr) const {
+    return toLocal(ptr).As<v8::Object>();
+  }
+  v8::Local<v8::Value> toLocal(const facebook::jsi::Value &value) const;
+  facebook::jsi::Value toValue(v8::Local<v8::Value> value);
+  facebook::jsi::Value borrowValue(
+      v8::Local<v8::Value> value,
+      V8PointerValue *storage);
+  PointerValue *newPointer(v8::Local<v8::Value> value) const;
+  PointerValue *clonePointer(const PointerValue *pv) const;
+  v8::Local<v8::Context> context() const { return context_->Get(isolate_); }
+
+  // Error plumbing.
+  [[noreturn]] void throwPendingError(v8::TryCatch &tryCatch);
+  [[noreturn]] void throwJSError(facebook::jsi::Value &&error);
+  [[noreturn]] void throwAbiError(jsi_error_code err);
+  facebook::jsi::Value adoptAbiValue(jsi_value value);
+  void throwNativeError(const std::string &message) const;
+
+  // Host function and host object plumbing.
+  static void hostFunctionCallback(
+      const v8::FunctionCallbackInfo<v8::Value> &info);
+  static void hostFunctionWeakCallback(
+      const v8::WeakCallbackInfo<HostFunctionContext> &info);
+  static void hostObjectWeakCallback(
+      const v8::WeakCallbackInfo<HostObjectProxy> &info);
+  static void nativeStateWeakCallback(
+      const v8::WeakCallbackInfo<NativeStateHolder> &info);
+  static v8::Intercepted hostObjectGet(
+      v8::Local<v8::Name> name,
+      const v8::PropertyCallbackInfo<v8::Value> &info);
+  static v8::Intercepted hostObjectSet(
+      v8::Local<v8::Name> name,
+      v8::Local<v8::Value> value,
+      const v8::PropertyCallbackInfo<void> &info);
+  static v8::Intercepted hostObjectGetIndexed(
+      uint32_t index,
+      const v8::PropertyCallbackInfo<v8::Value> &info);
+  static v8::Intercepted hostObjectSetIndexed(
+      uint32_t index,
+      v8::Local<v8::Value> value,
+      const v8::PropertyCallbackInfo<void> &info);
+  static void hostObjectEnumerator(
+      const v8::PropertyCallbackInfo<v8::Array> &info);
+  static void hostObjectIndexedEnumerator(
+      const v8::PropertyCallbackInfo<v8::Array> &info);
+  static HostObjectProxy *getHostObjectProxy(v8::Local<v8::Object> obj);
+  static void throwHostException(
+      v8::Isolate *isolate,
+      V8DirectRuntime &rt,
+      const char *prefix);
+
+  HostFunctionContext *getHostFunctionContext(
+      v8::Local<v8::Object> fn) const;
+  HostObjectProxy *getHostObjectProxyOf(v8::Local<v8::Object> obj) const;
+  NativeStateHolder *getNativeStateHolder(v8::Local<v8::Object> obj) const;
+  v8::Local<v8::Function> getHostObjectConstructor();
+  facebook::jsi::Object createHostObject(
+      std::shared_ptr<facebook::jsi::HostObject> ho,
+      IndexedHostObject *indexed);
+
+#if JSI_VERSION >= 20
+  // castInterface target for IIndexedHostObjectFactory.
+  class IndexedHostObjectFactory final
+      : public InterfaceAdapter<IIndexedHostObjectFactory, V8DirectRuntime> {
+   public:
+    using InterfaceAdapter::InterfaceAdapter;
+
+    facebook::jsi::Object createIndexedHostObject(
+        std::shared_ptr<IndexedHostObject> ho) override {
+      IndexedHostObject *indexed = ho.get();
+      return rt_.createHostObject(std::move(ho), indexed);
+    }
+  };
+#endif
+
+  jsi_runtime *abiRt_;
+  const jsi_runtime_vtable *vt_;
+  v8::Isolate *isolate_;
+  const v8::Global<v8::Context> *context_;
+  bool enableMultiThread_;
+  bool activeJSError_{false};
+
+  // Private keys tagging the objects this runtime created, so the getters can
+  // recognize them. Distinct from the jsi_runtime's keys: the two never share
+  // host objects, host functions or native state.
+  v8::Global<v8::Private> hostFunctionKey_;
+  v8::Global<v8::Private> hostObjectKey_;
+  v8::Global<v8::Private> nativeStateKey_;
+  v8::Global<v8::Function> hostObjectConstructor_;
+
+  // Live callback contexts. Owned by the jsi_runtime's teardown hook, not by
+  // this wrapper; see HostRegistry.
+  HostRegistry *hosts_;
+
+  std::unique_ptr<V8Instrumentation> instrumentation_;
+  // Expires with this runtime. prepare_javascript_async callbacks check it,
+  // since the jsi_runtime may outlive this wrapper.
+  std::shared_ptr<V8DirectRuntime *> self_{
+      std::make_shared<V8DirectRuntime *>(this)};
+#if JSI_VERSION >= 20
+  IndexedHostObjectFactory indexedHostObjectFactory_{*this};
+  abi::ScriptStoreAdapter<V8DirectRuntime> scriptStoreRuntime_{*this};
+  abi::AsyncPrepareAdapter<V8DirectRuntime> asyncPrepareRuntime_{*this};
+  abi::StartupCompleteAdapter<V8DirectRuntime> startupCompleteRuntime_{*this};
+#endif
+};
+
+//==============================================================================
+// V8PointerValue — the single handle layer
+//==============================================================================
+
+// Holds a v8::Global for the lifetime of the jsi handle. Host function
+// arguments and host object property names are instead borrowed: they wrap a
+// v8::Local from the callback's HandleScope, live in caller-owned storage and
+// have a no-op invalidate. Copying a borrowed Value clones it into a Global.
+class V8DirectRuntime::V8PointerValue final : public PointerValue {
+ public:
+  struct Borrowed {};
+
+  V8PointerValue(v8::Isolate *isolate, v8::Local<v8::Value> value)
+      : global_(isolate, value) {}
+
+  V8PointerValue(v8::Isolate *isolate, const v8::Global<v8::Value> &value)
+      : global_(isolate, value) {}
+
+  V8PointerValue(Borrowed, v8::Local<v8::Value> value) : borrowed_(value) {}
+
+  void invalidate() JSI_NOEXCEPT_15 override {
+    if (borrowed_.IsEmpty())
+      delete this;
+  }
+
+  v8::Local<v8::Value> get(v8::Isolate *isolate) const {
+    if (!borrowed_.IsEmpty())
+      return borrowed_;
+    return global_.Get(isolate);
+  }
+
+  V8PointerValue *clone(v8::Isolate *isolate) const {
+    if (!borrowed_.IsEmpty())
+      return new V8PointerValue(isolate, borrowed_);
+    return new V8PointerValue(isolate, global_);
+  }
+
+ private:
+  v8::Global<v8::Value> global_;
+  v8::Local<v8::Value> borrowed_;
+};
+
+class V8DirectRuntime::V8WeakValue final : public PointerValue {
+ public:
+  V8WeakValue(v8::Isolate *isolate, v8::Local<v8::Object> value)
+      : global_(isolate, value) {
+    global_.SetWeak();
+  }
+
+  void invalidate() JSI_NOEXCEPT_15 override { delete this; }
+
+  v8::Local<v8::Object> get(v8::Isolate *isolate) const {
+    return global_.Get(isolate);
+  }
+
+ private:
+  v8::Global<v8::Object> global_;
+};
+
+//==============================================================================
+// Scopes
+//==============================================================================
+
+// Enters the isolate and context for one jsi::Runtime call. Mirrors V8Scope in
+// jsi_abi_v8.cpp; the Locker is only taken for multi-threaded runtimes.
+class V8DirectRuntime::Scope {
+ public:
+  explicit Scope(const V8DirectRuntime &rt)
+      : locker_(makeLocker(rt)),
+        isolateScope_(rt.isolate_),
+        handleScope_(rt.isolate_),
+        contextScope_(rt.context()) {}
+
+  static std::optional<v8::Locker> makeLocker(const V8DirectRuntime &rt) {
+    if (rt.enableMultiThread_)
+      return std::make_optional<v8::Locker>(rt.isolate_);
+    return std::nullopt;
+  }
+
+ private:
+  std::optional<v8::Locker> locker_;
+  v8::Isolate::Scope isolateScope_;
+  v8::HandleScope handleScope_;
+  v8::Context::Scope contextScope_;
+};
+
+// Lock only: enough for creating a Global from another Global.
+class V8DirectRuntime::IsolateLock {
+ public:
+  explicit IsolateLock(const V8DirectRuntime &rt)
+      : locker_(Scope::makeLocker(rt)) {}
+
+ private:
+  std::optional<v8::Locker> locker_;
+};
+
+//==============================================================================
+// Callback contexts
+//==============================================================================
+
+// Host functions and host objects keep a pointer to the runtime that created
+// them; the destructor clears it, and a callback that finds it null fails
+// without touching the runtime. Each context unlinks itself from its runtime's
+// HostRegistry when its object is collected.
+struct V8DirectRuntime::HostFunctionContext {
+  V8DirectRuntime *runtime;
+  HostRegistry &registry;
+  facebook::jsi::HostFunctionType func;
+  v8::Global<v8::Function> weakRef;
+  std::list<HostFunctionContext *>::iterator listIter;
+
+  HostFunctionContext(
+      V8DirectRuntime &rt,
+      facebook::jsi::HostFunctionType f)
+      : runtime(&rt), registry(*rt.hosts_), func(std::move(f)) {}
+};
+
+struct V8DirectRuntime::HostObjectProxy {
+  V8DirectRuntime *runtime;
+  HostRegistry &registry;
+  std::shared_ptr<facebook::jsi::HostObject> hostObject;
+  // Set for createIndexedHostObject; integer keys then skip the string path.
+  IndexedHostObject *indexed;
+  v8::Global<v8::Object> weakRef;
+  std::list<HostObjectProxy *>::iterator listIter;
+
+  HostObjectProxy(
+      V8DirectRuntime &rt,
+      std::shared_ptr<facebook::jsi::HostObject> ho,
+      IndexedHostObject *idx)
+      : runtime(&rt),
+        registry(*rt.hosts_),
+        hostObject(std::move(ho)),
+        indexed(idx) {}
+};
+
+struct V8DirectRuntime::NativeStateHolder {
+  HostRegistry &registry;
+  std::shared_ptr<facebook::jsi::NativeState> state;
+  v8::Global<v8::Object> weakRef;
+  std::list<NativeStateHolder *>::iterator listIter;
+
+  NativeStateHolder(
+      V8DirectRuntime &rt,
+      std::shared_ptr<facebook::jsi::NativeState> s)
+      : registry(*rt.hosts_), state(std::move(s)) {}
+};
+
+// The callback contexts a runtime has created, removed by their weak
+// callbacks. JS can reach the rest for as long as the isolate lives, and
+// anything else holding the jsi_runtime keeps the isolate alive past this
+// wrapper. So the registry belongs to the jsi_runtime: its teardown hook frees
+// the registry, and the contexts still in it, once the last reference is
+// released and before the isolate is disposed.
+struct V8DirectRuntime::HostRegistry {
+  std::list<HostFunctionContext *> hostFunctions;
+  std::list<HostObjectProxy *> hostObjects;
+  std::list<NativeStateHolder *> nativeStates;
+
+  ~HostRegistry() {
+    for (HostFunctionContext *ctx : hostFunctions)
+      delete ctx;
+    for (HostObjectProxy *proxy : hostObjects)
+      delete proxy;
+    for (NativeStateHolder *holder : nativeStates)
+      delete holder;
+  }
+
+  static void destroy(void *registry) {
+    delete static_cast<HostRegistry *>(registry);
+  }
+};
+
+//==============================================================================
+// Constructor / Destructor
+//==============================================================================
+
+V8DirectRuntime::V8DirectRuntime(jsi_runtime *abiRuntime)
+    : abiRt_(abiRuntime),
+      vt_(abiRuntime->vt),
+      isolate_(v8rt_internal::getIsolate(abiRuntime)),
+      context_(&v8rt_internal::getContext(abiRuntime)),
+      enableMultiThread_(v8rt_internal::getEnableMultiThread(abiRuntime)),
+      hosts_(new HostRegistry()) {
+  v8rt_internal::addTeardownHook(abiRt_, &HostRegistry::destroy, hosts_);
+  Scope scope(*this);
+  hostFunctionKey_.Reset(
+      isolate_,
+      v8::Private::New(
+          isolate_,
+          v8::String::NewFromUtf8Literal(isolate_, "v8jsi::hostFunction")));
+  hostObjectKey_.Reset(
+      isolate_,
+      v8::Private::New(
+          isolate_,
+          v8::String::NewFromUtf8Literal(isolate_, "v8jsi::hostObject")));
+  nativeStateKey_.Reset(
+      isolate_,
+      v8::Private::New(
+          isolate_,
+          v8::String::NewFromUtf8Literal(isolate_, "v8jsi::nativeState")));
+
+  // getHeapInfo reports how many host objects and host functions are still
+  // tracked; both lists shrink as their weak callbacks fire. It also reports
+  // the property-name intern table and source hash cache counters and the
+  // external memory attached through setExternalMemoryPressure.
+  instrumentation_ = std::make_unique<V8Instrumentation>(
+      isolate_, [this](std::unordered_map<std::string, int64_t> &heapInfo) {
+        heapInfo["hostObjectTrackers"] =
+            static_cast<int64_t>(
+                hosts_->hostObjects.size() + hosts_->hostFunctions.size());
+        auto &propNames = v8rt_internal::getPropNameInternTable(abiRt_);
+        heapInfo["propNameCacheHits"] =
+            static_cast<int64_t>(propNames.hits());
+        heapInfo["propNameCacheMisses"] =
+            static_cast<int64_t>(propNames.misses());
+        auto &externalMemory = v8rt_internal::getExternalMemoryTable(abiRt_);
+        heapInfo["externalMemoryBytes"] = externalMemory.totalBytes();
+        heapInfo["externalMemoryObjects"] =
+            static_cast<int64_t>(externalMemory.trackedObjects());
+        auto &sourceHashes = v8rt_internal::getSourceHashCache(abiRt_);
+        heapInfo["sourceHashCacheHits"] =
+            static_cast<int64_t>(sourceHashes.hits());
+        heapInfo["sourceHashCacheMisses"] =
+            static_cast<int64_t>(sourceHashes.misses());
+        auto &compiledScripts = v8rt_internal::getCompiledScriptCache(abiRt_);
+        heapInfo["compiledScriptCacheHits"] =
+            static_cast<int64_t>(compiledScripts.hits());
+        heapInfo["compiledScriptCacheMisses"] =
+            static_cast<int64_t>(compiledScripts.misses());
+        heapInfo["compiledScriptCacheBytes"] =
+            static_cast<int64_t>(compiledScripts.bytes());
+      });
+}
+
+V8DirectRuntime::~V8DirectRuntime() {
+  // JS may still reach these if the jsi_runtime outlives this wrapper; their
+  // callbacks now fail instead of calling into it. The registry's teardown
+  // hook frees them with the jsi_runtime.
+  for (HostFunctionContext *ctx : hosts_->hostFunctions)
+    ctx->runtime = nullptr;
+  for (HostObjectProxy *proxy : hosts_->hostObjects)
+    proxy->runtime = nullptr;
+
+  hostObjectConstructor_.Reset();
+  nativeStateKey_.Reset();
+  hostObjectKey_.Reset();
+  hostFunctionKey_.Reset();
+
+  vt_->release(abiRt_);
+}
+
+//==============================================================================
+// Conversion
+//==============================================================================
+
+v8::Local<v8::Value> V8DirectRuntime::toLocal(const PointerValue *pv) const {
+  return static_cast<const V8PointerValue *>(pv)->get(isolate_);
+}
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::newPointer(
+    v8::Local<v8::Value> value) const {
+  return new V8PointerValue(isolate_, value);
+}
+
+v8::Local<v8::Value> V8DirectRuntime::toLocal(
+    const facebook::jsi::Value &value) const {
+  if (value.isUndefined())
+    return v8::Undefined(isolate_);
+  if (value.isNull())
+    return v8::Null(isolate_);
+  if (value.isBool())
+    return v8::Boolean::New(isolate_, value.getBool());
+  if (value.isNumber())
+    return v8::Number::New(isolate_, value.getNumber());
+  return toLocal(getPointerValue(value));
+}
+
+facebook::jsi::Value V8DirectRuntime::toValue(v8::Local<v8::Value> value) {
+  if (value->IsUndefined())
+    return facebook::jsi::Value::undefined();
+  if (value->IsNull())
+    return facebook::jsi::Value::null();
+  if (value->IsBoolean())
+    return facebook::jsi::Value(value->BooleanValue(isolate_));
+  if (value->IsNumber())
+    return facebook::jsi::Value(value.As<v8::Number>()->Value());
+  if (value->IsString())
+    return make<facebook::jsi::String>(newPointer(value));
+  if (value->IsSymbol())
+    return make<facebook::jsi::Symbol>(newPointer(value));
+  if (value->IsBigInt())
+    return make<facebook::jsi::BigInt>(newPointer(value));
+  if (value->IsObject())
+    return make<facebook::jsi::Object>(newPointer(value));
+  return facebook::jsi::Value::undefined();
+}
+
+facebook::jsi::Value V8DirectRuntime::borrowValue(
+    v8::Local<v8::Value> value,
+    V8PointerValue *storage) {
+  if (value->IsString())
+    return make<facebook::jsi::String>(
+        new (storage) V8PointerValue(V8PointerValue::Borrowed{}, value));
+  if (value->IsSymbol())
+    return make<facebook::jsi::Symbol>(
+        new (storage) V8PointerValue(V8PointerValue::Borrowed{}, value));
+  if (value->IsBigInt())
+    return make<facebook::jsi::BigInt>(
+        new (storage) V8PointerValue(V8PointerValue::Borrowed{}, value));
+  if (value->IsObject())
+    return make<facebook::jsi::Object>(
+        new (storage) V8PointerValue(V8PointerValue::Borrowed{}, value));
+  return toValue(value);
+}
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::clonePointer(
+    const PointerValue *pv) const {
+  if (!pv)
+    return nullptr;
+  IsolateLock lock(*this);
+  return static_cast<const V8PointerValue *>(pv)->clone(isolate_);
+}
+
+//==============================================================================
+// Error handling
+//==============================================================================
+
+void V8DirectRuntime::throwPendingError(v8::TryCatch &tryCatch) {
+  if (!tryCatch.HasCaught())
+    throw facebook::jsi::JSINativeException("V8 call failed without an exception");
+  facebook::jsi::Value error = toValue(tryCatch.Exception());
+  tryCatch.Reset();
+  throwJSError(std::move(error));
+}
+
+void V8DirectRuntime::throwJSError(facebook::jsi::Value &&error) {
+  if (activeJSError_)
+    throw facebook::jsi::JSINativeException(
+        "Error thrown while handling error.");
+
+  SaveAndRestore<bool> s(activeJSError_);
+  activeJSError_ = true;
+  throw facebook::jsi::JSError(*this, std::move(error));
+}
+
+void V8DirectRuntime::throwAbiError(jsi_error_code err) {
+  if (err == jsi_error_js)
+    throwJSError(adoptAbiValue(vt_->get_and_clear_js_error_value(abiRt_)));
+  if (err == jsi_error_native) {
+    StringBuffer gb;
+    vt_->get_and_clear_native_exception_message(abiRt_, &gb);
+    throw facebook::jsi::JSINativeException(std::move(gb).get());
+  }
+  throw facebook::jsi::JSINativeException("Unknown ABI error");
+}
+
+facebook::jsi::Value V8DirectRuntime::adoptAbiValue(jsi_value value) {
+  if (!abi::is_pointer_value(value)) {
+    switch (abi::get_value_kind(value)) {
+      case jsi_valuekind_boolean:
+        return facebook::jsi::Value(abi::get_bool_value(value));
+      case jsi_valuekind_number:
+        return facebook::jsi::Value(abi::get_number_value(value));
+      case jsi_valuekind_null:
+        return facebook::jsi::Value::null();
+      default:
+        return facebook::jsi::Value::undefined();
+    }
+  }
+  Scope scope(*this);
+  facebook::jsi::Value result = toValue(v8rt_internal::toV8Value(abiRt_, value));
+  abi::release_value(value);
+  return result;
+}
+
+void V8DirectRuntime::throwNativeError(const std::string &message) const {
+  v8::Local<v8::String> text;
+  if (!v8::String::NewFromUtf8(
+           isolate_, message.data(), v8::NewStringType::kNormal,
+           static_cast<int>(message.size()))
+           .ToLocal(&text))
+    text = v8::String::Empty(isolate_);
+  isolate_->ThrowException(v8::Exception::Error(text));
+}
+
+// Translate the in-flight C++ exception into a JS exception. Called from the
+// catch (...) of a V8 callback; native messages get the same prefixes the ABI
+// trampolines use so both runtimes report identical errors.
+void V8DirectRuntime::throwHostException(
+    v8::Isolate *isolate,
+    V8DirectRuntime &rt,
+    const char *prefix) {
+  try {
+    throw;
+  } catch (const facebook::jsi::JSError &e) {
+    isolate->ThrowException(rt.toLocal(e.value()));
+  } catch (const std::exception &e) {
+    rt.throwNativeError(std::string(prefix) + e.what());
+  } catch (...) {
+    rt.throwNativeError(
+        std::string(prefix) + "Unknown exception in host callback");
+  }
+}
+
+//==============================================================================
+// Script evaluation (delegated to the jsi_runtime)
+//==============================================================================
+
+facebook::jsi::Value V8DirectRuntime::evaluateJavaScript(
+    const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+    const std::string &sourceURL) {
+  auto *abiBuf = new BufferWrapper(buffer);
+  auto result = vt_->evaluate_javascript_source(
+      abiRt_, abiBuf, sourceURL.c_str(), sourceURL.size());
+  if (abi::is_error(result))
+    throwAbiError(abi::get_error(result));
+  return adoptAbiValue(abi::get_value(result));
+}
+
+std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+V8DirectRuntime::prepareJavaScript(
+    const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+    std::string sourceURL) {
+  auto *abiBuf = new BufferWrapper(buffer);
+  return adoptPreparedJavaScript(vt_->prepare_javascript(
+      abiRt_, abiBuf, sourceURL.c_str(), sourceURL.size()));
+}
+
+std::shared_ptr<const facebook::jsi::PreparedJavaScript>
+V8DirectRuntime::adoptPreparedJavaScript(
+    jsi_prepared_javascript_or_error result) {
+  if (abi::is_error(result))
+    throwAbiError(abi::get_error(result));
+  return std::make_shared<PreparedScriptWrapper>(
+      abi::get_prepared_javascript(result));
+}
+
+facebook::jsi::Value V8DirectRuntime::evaluatePreparedJavaScript(
+    const std::shared_ptr<const facebook::jsi::PreparedJavaScript> &js) {
+  auto *wrapper = static_cast<const PreparedScriptWrapper *>(js.get());
+  auto result = vt_->evaluate_prepared_javascript(abiRt_, wrapper->prepared);
+  if (abi::is_error(result))
+    throwAbiError(abi::get_error(result));
+  return adoptAbiValue(abi::get_value(result));
+}
+
+//==============================================================================
+// Microtasks
+//==============================================================================
+
+#if JSI_VERSION >= 4
+bool V8DirectRuntime::drainMicrotasks(int /*maxMicrotasksHint*/) {
+  Scope scope(*this);
+  if (isolate_->GetMicrotasksPolicy() == v8::MicrotasksPolicy::kExplicit)
+    isolate_->PerformMicrotaskCheckpoint();
+  return false;
+}
+#endif
+
+#if JSI_VERSION >= 12
+void V8DirectRuntime::queueMicrotask(const facebook::jsi::Function &callback) {
+  Scope scope(*this);
+  isolate_->EnqueueMicrotask(toLocal(callback).As<v8::Function>());
+}
+#endif
+
+//==============================================================================
+// Global / Description / Inspectable
+//==============================================================================
+
+facebook::jsi::Object V8DirectRuntime::global() {
+  Scope scope(*this);
+  return make<facebook::jsi::Object>(newPointer(context()->Global()));
+}
+
+std::string V8DirectRuntime::description() {
+  StringBuffer gb;
+  vt_->get_description(abiRt_, &gb);
+  return std::move(gb).get();
+}
+
+bool V8DirectRuntime::isInspectable() {
+  return vt_->is_inspectable(abiRt_);
+}
+
+facebook::jsi::Instrumentation &V8DirectRuntime::instrumentation() {
+  return *instrumentation_;
+}
+
+#if JSI_VERSION >= 20
+facebook::jsi::ICast *V8DirectRuntime::castInterface(
+    const facebook::jsi::UUID &interfaceUUID) {
+  if (interfaceUUID == IIndexedHostObjectFactory::uuid)
+    return &indexedHostObjectFactory_;
+  if (interfaceUUID == IScriptStoreRuntime::uuid)
+    return &scriptStoreRuntime_;
+  if (interfaceUUID == IAsyncPrepareRuntime::uuid)
+    return &asyncPrepareRuntime_;
+  if (interfaceUUID == IStartupCompleteRuntime::uuid)
+    return &startupCompleteRuntime_;
+  return Runtime::castInterface(interfaceUUID);
+}
+#endif
+
+//==============================================================================
+// Clone operations
+//==============================================================================
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::cloneSymbol(
+    const PointerValue *pv) {
+  return clonePointer(pv);
+}
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::cloneString(
+    const PointerValue *pv) {
+  return clonePointer(pv);
+}
+
+#if JSI_VERSION >= 6
+V8DirectRuntime::PointerValue *V8DirectRuntime::cloneBigInt(
+    const PointerValue *pv) {
+  return clonePointer(pv);
+}
+#endif
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::cloneObject(
+    const PointerValue *pv) {
+  return clonePointer(pv);
+}
+
+V8DirectRuntime::PointerValue *V8DirectRuntime::clonePropNameID(
+    const PointerValue *pv) {
+  return clonePointer(pv);
+}
+
+//==============================================================================
+// PropNameID operations
+//==============================================================================
+
+facebook::jsi::PropNameID V8DirectRuntime::createPropNameIDFromAscii(
+    const char *str,
+    size_t length) {
+  Scope scope(*this);
+  // ASCII bytes decode identically as one-byte and UTF-8, so both factories
+  // share the runtime's intern table.
+  v8::Local<v8::String> v8str;
+  if (!v8rt_internal::getPropNameInternTable(abiRt_)
+           .get(isolate_, std::string_view(str, length),
+                [](v8::Isolate *isolate, std::string_view name) {
+                  return v8::String::NewFromOneByte(
+                      isolate, reinterpret_cast<const uint8_t *>(name.data()),
+                      v8::NewStringType::kInternalized,
+                      static_cast<int>(name.size()));
+                })
+           .ToLocal(&v8str))
+    throw facebook::jsi::JSINativeException("Failed to create property name");
+  return make<facebook::jsi::PropNameID>(newPointer(v8str));
+}
+
+facebook::jsi::PropNameID V8DirectRuntime::createPropNameIDFromUtf8(
+    const uint8_t *utf8,
+    size_t length) {
+  Scope scope(*this);
+  v8::Local<v8::String> v8str;
+  if (!v8rt_internal::getPropNameInternTable(abiRt_)
+           .get(isolate_,
+                std::string_view(reinterpret_cast<const char *>(utf8), length),
+                [](v8::Isolate *isolate, std::string_view name) {
+                  return v8rt::newStringFromUtf8(
+                      isolate, name.data(), name.size(),
+                      v8::NewStringType::kInternalized);
+                })
+           .ToLocal(&v8str))
+    throw facebook::jsi::JSINativeException("Failed to create property name");
+  return make<facebook::jsi::PropNameID>(newPointer(v8str));
+}
+
+facebook::jsi::PropNameID V8DirectRuntime::createPropNameIDFromString(
+    const facebook::jsi::String &str) {
+  return make<facebook::jsi::PropNameID>(clonePointer(getPointerValue(str)));
+}
+
+#if JSI_VERSION >= 5
+facebook::jsi::PropNameID V8DirectRuntime::createPropNameIDFromSymbol(
+    const facebook::jsi::Symbol &sym) {
+  return make<facebook::jsi::PropNameID>(clonePointer(getPointerValue(sym)));
+}
+#endif
+
+std::string V8DirectRuntime::utf8(const facebook::jsi::PropNameID &name) {
+  Scope scope(*this);
+  return toUtf8(
+      isolate_, v8rt_internal::propNameString(isolate_, toLocal(name)));
+}
+
+bool V8DirectRuntime::compare(
+    const facebook::jsi::PropNameID &a,
+    const facebook::jsi::PropNameID &b) {
+  Scope scope(*this);
+  return toLocal(a)->StrictEquals(toLocal(b));
+}
+
+//==============================================================================
+// Symbol operations
+//==============================================================================
+
+std::string V8DirectRuntime::symbolToString(const facebook::jsi::Symbol &sym) {
+  Scope scope(*this);
+  v8::Local<v8::Value> desc =
+      toLocal(sym).As<v8::Symbol>()->Description(isolate_);
+  std::string result = "Symbol(";
+  if (desc->IsString())
+    result += toUtf8(isolate_, desc.As<v8::String>());
+  result += ")";
+  return result;
+}
+
+//==============================================================================
+// BigInt operations
+//==============================================================================
+
+#if JSI_VERSION >= 8
+facebook::jsi::BigInt V8DirectRuntime::createBigIntFromInt64(int64_t val) {
+  Scope scope(*this);
+  return make<facebook::jsi::BigInt>(
+      newPointer(v8::BigInt::New(isolate_, val)));
+}
+
+facebook::jsi::BigInt V8DirectRuntime::createBigIntFromUint64(uint64_t val) {
+  Scope scope(*this);
+  return make<facebook::jsi::BigInt>(
+      newPointer(v8::BigInt::NewFromUnsigned(isolate_, val)));
+}
+
+bool V8DirectRuntime::bigintIsInt64(const facebook::jsi::BigInt &bi) {
+  Scope scope(*this);
+  bool lossless = true;
+  toLocal(bi).As<v8::BigInt>()->Int64Value(&lossless);
+  return lossless;
+}
+
+bool V8DirectRuntime::bigintIsUint64(const facebook::jsi::BigInt &bi) {
+  Scope scope(*this);
+  bool lossless = true;
+  toLocal(bi).As<v8::BigInt>()->Uint64Value(&lossless);
+  return lossless;
+}
+
+uint64_t V8DirectRuntime::truncate(const facebook::jsi::BigInt &bi) {
+  Scope scope(*this);
+  bool lossless = false;
+  return toLocal(bi).As<v8::BigInt>()->Uint64Value(&lossless);
+}
+
+facebook::jsi::String V8DirectRuntime::bigintToString(
+    const facebook::jsi::BigInt &bi,
+    int radix) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Context> ctx = context();
+  v8::Local<v8::Value> v8bi = toLocal(bi);
+
+  v8::Local<v8::Object> boxed;
+  v8::Local<v8::Value> toStringFn;
+  if (!v8bi->ToObject(ctx).ToLocal(&boxed) ||
+      !boxed->Get(ctx, v8::String::NewFromUtf8Literal(isolate_, "toString"))
+           .ToLocal(&toStringFn))
+    throwPendingError(tryCatch);
+  if (!toStringFn->IsFunction())
+    throw facebook::jsi::JSINativeException(
+        "BigInt.prototype.toString not found");
+
+  v8::Local<v8::Value> radixArg = v8::Integer::New(isolate_, radix);
+  v8::Local<v8::Value> result;
+  if (!toStringFn.As<v8::Function>()->Call(ctx, v8bi, 1, &radixArg).ToLocal(
+          &result))
+    throwPendingError(tryCatch);
+  if (!result->IsString())
+    throw facebook::jsi::JSINativeException(
+        "BigInt.toString did not return a string");
+  return make<facebook::jsi::String>(newPointer(result));
+}
+#endif
+
+//==============================================================================
+// String operations
+//==============================================================================
+
+facebook::jsi::String V8DirectRuntime::createStringFromAscii(
+    const char *str,
+    size_t length) {
+  Scope scope(*this);
+  v8::Local<v8::String> v8str;
+  if (!v8::String::NewFromOneByte(
+           isolate_, reinterpret_cast<const uint8_t *>(str),
+           v8::NewStringType::kNormal, static_cast<int>(length))
+           .ToLocal(&v8str))
+    throw facebook::jsi::JSINativeException("Failed to create string");
+  return make<facebook::jsi::String>(newPointer(v8str));
+}
+
+facebook::jsi::String V8DirectRuntime::createStringFromUtf8(
+    const uint8_t *utf8,
+    size_t length) {
+  Scope scope(*this);
+  v8::Local<v8::String> v8str;
+  if (!v8rt::newStringFromUtf8(
+           isolate_, reinterpret_cast<const char *>(utf8), length)
+           .ToLocal(&v8str))
+    throw facebook::jsi::JSINativeException("Failed to create string");
+  return make<facebook::jsi::String>(newPointer(v8str));
+}
+
+#if JSI_VERSION >= 19
+facebook::jsi::String V8DirectRuntime::createStringFromUtf16(
+    const char16_t *utf16,
+    size_t length) {
+  Scope scope(*this);
+  v8::Local<v8::String> v8str;
+  if (!v8::String::NewFromTwoByte(
+           isolate_, reinterpret_cast<const uint16_t *>(utf16),
+           v8::NewStringType::kNormal, static_cast<int>(length))
+           .ToLocal(&v8str))
+    throw facebook::jsi::JSINativeException("Failed to create string");
+  return make<facebook::jsi::String>(newPointer(v8str));
+}
+#endif
+
+std::string V8DirectRuntime::utf8(const facebook::jsi::String &str) {
+  Scope scope(*this);
+  return toUtf8(isolate_, toLocal(str).As<v8::String>());
+}
+
+#if JSI_VERSION >= 16
+void V8DirectRuntime::getStringData(
+    const facebook::jsi::String &str,
+    void *ctx,
+    void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
+  Scope scope(*this);
+  v8rt_internal::visitStringData(
+      isolate_,
+      toLocal(str).As<v8::String>(),
+      [&](bool ascii, const void *data, size_t num) {
+        cb(ctx, ascii, data, num);
+      });
+}
+
+void V8DirectRuntime::getPropNameIdData(
+    const facebook::jsi::PropNameID &sym,
+    void *ctx,
+    void (*cb)(void *ctx, bool ascii, const void *data, size_t num)) {
+  Scope scope(*this);
+  v8rt_internal::visitStringData(
+      isolate_,
+      v8rt_internal::propNameString(isolate_, toLocal(sym)),
+      [&](bool ascii, const void *data, size_t num) {
+        cb(ctx, ascii, data, num);
+      });
+}
+#endif
+
+//==============================================================================
+// Object operations
+//==============================================================================
+
+facebook::jsi::Object V8DirectRuntime::createObject() {
+  Scope scope(*this);
+  return make<facebook::jsi::Object>(newPointer(v8::Object::New(isolate_)));
+}
+
+v8::Local<v8::Function> V8DirectRuntime::getHostObjectConstructor() {
+  if (hostObjectConstructor_.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> constructorTemplate =
+        v8::FunctionTemplate::New(isolate_);
+    v8::Local<v8::ObjectTemplate> instanceTemplate =
+        constructorTemplate->InstanceTemplate();
+    instanceTemplate->SetHandler(v8::NamedPropertyHandlerConfiguration(
+        hostObjectGet, hostObjectSet, nullptr, nullptr, hostObjectEnumerator));
+    instanceTemplate->SetHandler(v8::IndexedPropertyHandlerConfiguration(
+        hostObjectGetIndexed, hostObjectSetIndexed, nullptr, nullptr,
+        hostObjectIndexedEnumerator));
+    instanceTemplate->SetInternalFieldCount(1);
+    hostObjectConstructor_.Reset(
+        isolate_, constructorTemplate->GetFunction(context()).ToLocalChecked());
+  }
+  return hostObjectConstructor_.Get(isolate_);
+}
+
+facebook::jsi::Object V8DirectRuntime::createObject(
+    std::shared_ptr<facebook::jsi::HostObject> ho) {
+  return createHostObject(std::move(ho), nullptr);
+}
+
+facebook::jsi::Object V8DirectRuntime::createHostObject(
+    std::shared_ptr<facebook::jsi::HostObject> ho,
+    IndexedHostObject *indexed) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Context> ctx = context();
+
+  v8::Local<v8::Object> obj;
+  if (!getHostObjectConstructor()->NewInstance(ctx).ToLocal(&obj))
+    throwPendingError(tryCatch);
+
+  auto *proxy = new HostObjectProxy(*this, std::move(ho), indexed);
+  proxy->weakRef.Reset(isolate_, obj);
+  proxy->weakRef.SetWeak(
+      proxy, hostObjectWeakCallback, v8::WeakCallbackType::kParameter);
+  proxy->listIter =
+      hosts_->hostObjects.insert(hosts_->hostObjects.end(), proxy);
+
+  v8::Local<v8::External> external = v8::External::New(isolate_, proxy);
+  obj->SetInternalField(0, external);
+  obj->SetPrivate(ctx, hostObjectKey_.Get(isolate_), external).Check();
+  return make<facebook::jsi::Object>(newPointer(obj));
+}
+
+V8DirectRuntime::HostObjectProxy *V8DirectRuntime::getHostObjectProxyOf(
+    v8::Local<v8::Object> obj) const {
+  v8::Local<v8::Value> tag;
+  if (obj->GetPrivate(context(), hostObjectKey_.Get(isolate_)).ToLocal(&tag) &&
+      tag->IsExternal())
+    return static_cast<HostObjectProxy *>(tag.As<v8::External>()->Value());
+  return nullptr;
+}
+
+std::shared_ptr<facebook::jsi::HostObject> V8DirectRuntime::getHostObject(
+    const facebook::jsi::Object &obj) {
+  Scope scope(*this);
+  HostObjectProxy *proxy = getHostObjectProxyOf(toObject(obj));
+  return proxy ? proxy->hostObject : nullptr;
+}
+
+V8DirectRuntime::HostFunctionContext *V8DirectRuntime::getHostFunctionContext(
+    v8::Local<v8::Object> fn) const {
+  v8::Local<v8::Value> tag;
+  if (fn->GetPrivate(context(), hostFunctionKey_.Get(isolate_)).ToLocal(&tag) &&
+      tag->IsExternal())
+    return static_cast<HostFunctionContext *>(tag.As<v8::External>()->Value());
+  return nullptr;
+}
+
+facebook::jsi::HostFunctionType &V8DirectRuntime::getHostFunction(
+    const facebook::jsi::Function &fn) {
+  Scope scope(*this);
+  HostFunctionContext *ctx = getHostFunctionContext(toObject(fn));
+  if (!ctx)
+    throw facebook::jsi::JSINativeException("Not a host function");
+  return ctx->func;
+}
+
+#if JSI_VERSION >= 7
+V8DirectRuntime::NativeStateHolder *V8DirectRuntime::getNativeStateHolder(
+    v8::Local<v8::Object> obj) const {
+  v8::Local<v8::Value> tag;
+  if (obj->GetPrivate(context(), nativeStateKey_.Get(isolate_)).ToLocal(&tag) &&
+      tag->IsExternal())
+    return static_cast<NativeStateHolder *>(tag.As<v8::External>()->Value());
+  return nullptr;
+}
+
+bool V8DirectRuntime::hasNativeState(const facebook::jsi::Object &obj) {
+  Scope scope(*this);
+  return toObject(obj)
+      ->HasPrivate(context(), nativeStateKey_.Get(isolate_))
+      .FromMaybe(false);
+}
+
+std::shared_ptr<facebook::jsi::NativeState> V8DirectRuntime::getNativeState(
+    const facebook::jsi::Object &obj) {
+  Scope scope(*this);
+  NativeStateHolder *holder = getNativeStateHolder(toObject(obj));
+  return holder ? holder->state : nullptr;
+}
+
+void V8DirectRuntime::setNativeState(
+    const facebook::jsi::Object &obj,
+    std::shared_ptr<facebook::jsi::NativeState> state) {
+  Scope scope(*this);
+  v8::Local<v8::Object> v8obj = toObject(obj);
+  if (NativeStateHolder *existing = getNativeStateHolder(v8obj)) {
+    existing->state = std::move(state);
+    return;
+  }
+
+  auto *holder = new NativeStateHolder(*this, std::move(state));
+  holder->weakRef.Reset(isolate_, v8obj);
+  holder->weakRef.SetWeak(
+      holder, nativeStateWeakCallback, v8::WeakCallbackType::kParameter);
+  holder->listIter =
+      hosts_->nativeStates.insert(hosts_->nativeStates.end(), holder);
+  v8obj
+      ->SetPrivate(
+          context(), nativeStateKey_.Get(isolate_),
+          v8::External::New(isolate_, holder))
+      .Check();
+}
+#endif
+
+//==============================================================================
+// Prototype operations
+//==============================================================================
+
+#if JSI_VERSION >= 17
+void V8DirectRuntime::setPrototypeOf(
+    const facebook::jsi::Object &object,
+    const facebook::jsi::Value &prototype) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Maybe<bool> success =
+      toObject(object)->SetPrototypeV2(context(), toLocal(prototype));
+  if (success.IsNothing())
+    throwPendingError(tryCatch);
+  if (!success.FromJust())
+    throw facebook::jsi::JSINativeException("Failed to set prototype");
+}
+
+facebook::jsi::Value V8DirectRuntime::getPrototypeOf(
+    const facebook::jsi::Object &object) {
+  Scope scope(*this);
+  return toValue(toObject(object)->GetPrototypeV2());
+}
+#endif
+
+//==============================================================================
+// Property operations
+//==============================================================================
+
+facebook::jsi::Value V8DirectRuntime::getProperty(
+    const facebook::jsi::Object &obj,
+    const facebook::jsi::PropNameID &name) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Value> result;
+  if (!toObject(obj)->Get(context(), toLocal(name)).ToLocal(&result))
+    throwPendingError(tryCatch);
+  return toValue(result);
+}
+
+facebook::jsi::Value V8DirectRuntime::getProperty(
+    const facebook::jsi::Object &obj,
+    const facebook::jsi::String &name) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Value> result;
+  if (!toObject(obj)->Get(context(), toLocal(name)).ToLocal(&result))
+    throwPendingError(tryCatch);
+  return toValue(result);
+}
+
+bool V8DirectRuntime::hasProperty(
+    const facebook::jsi::Object &obj,
+    const facebook::jsi::PropNameID &name) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Maybe<bool> has = toObject(obj)->Has(context(), toLocal(name));
+  if (has.IsNothing())
+    throwPendingError(tryCatch);
+  return has.FromJust();
+}
+
+bool V8DirectRuntime::hasProperty(
+    const facebook::jsi::Object &obj,
+    const facebook::jsi::String &name) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Maybe<bool> has = toObject(obj)->Has(context(), toLocal(name));
+  if (has.IsNothing())
+    throwPendingError(tryCatch);
+  return has.FromJust();
+}
+
+void V8DirectRuntime::setPropertyValue(
+    JSI_CONST_10 facebook::jsi::Object &obj,
+    const facebook::jsi::PropNameID &name,
+    const facebook::jsi::Value &value) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  if (toObject(obj)->Set(context(), toLocal(name), toLocal(value)).IsNothing())
+    throwPendingError(tryCatch);
+}
+
+void V8DirectRuntime::setPropertyValue(
+    JSI_CONST_10 facebook::jsi::Object &obj,
+    const facebook::jsi::String &name,
+    const facebook::jsi::Value &value) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  if (toObject(obj)->Set(context(), toLocal(name), toLocal(value)).IsNothing())
+    throwPendingError(tryCatch);
+}
+
+//==============================================================================
+// Type checks
+//==============================================================================
+
+bool V8DirectRuntime::isArray(const facebook::jsi::Object &obj) const {
+  Scope scope(*this);
+  return toLocal(obj)->IsArray();
+}
+
+bool V8DirectRuntime::isArrayBuffer(const facebook::jsi::Object &obj) const {
+  Scope scope(*this);
+  return toLocal(obj)->IsArrayBuffer();
+}
+
+bool V8DirectRuntime::isFunction(const facebook::jsi::Object &obj) const {
+  Scope scope(*this);
+  return toLocal(obj)->IsFunction();
+}
+
+bool V8DirectRuntime::isHostObject(const facebook::jsi::Object &obj) const {
+  Scope scope(*this);
+  return getHostObjectProxyOf(toObject(obj)) != nullptr;
+}
+
+bool V8DirectRuntime::isHostFunction(const facebook::jsi::Function &fn) const {
+  Scope scope(*this);
+  return getHostFunctionContext(toObject(fn)) != nullptr;
+}
+
+facebook::jsi::Array V8DirectRuntime::getPropertyNames(
+    const facebook::jsi::Object &obj) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Array> names;
+  if (!toObject(obj)
+           ->GetPropertyNames(
+               context(), v8::KeyCollectionMode::kIncludePrototypes,
+               static_cast<v8::PropertyFilter>(
+                   v8::ONLY_ENUMERABLE | v8::SKIP_SYMBOLS),
+               v8::IndexFilter::kIncludeIndices,
+               v8::KeyConversionMode::kConvertToString)
+           .ToLocal(&names))
+    throwPendingError(tryCatch);
+  return make<facebook::jsi::Array>(newPointer(names));
+}
+
+//==============================================================================
+// Weak references
+//==============================================================================
+
+facebook::jsi::WeakObject V8DirectRuntime::createWeakObject(
+    const facebook::jsi::Object &obj) {
+  Scope scope(*this);
+  return make<facebook::jsi::WeakObject>(
+      new V8WeakValue(isolate_, toObject(obj)));
+}
+
+facebook::jsi::Value V8DirectRuntime::lockWeakObject(
+    JSI_NO_CONST_3 JSI_CONST_10 facebook::jsi::WeakObject &wo) {
+  Scope scope(*this);
+  v8::Local<v8::Object> obj =
+      static_cast<const V8WeakValue *>(getPointerValue(wo))->get(isolate_);
+  if (obj.IsEmpty())
+    return facebook::jsi::Value::undefined();
+  return make<facebook::jsi::Object>(newPointer(obj));
+}
+
+//==============================================================================
+// Array operations
+//==============================================================================
+
+facebook::jsi::Array V8DirectRuntime::createArray(size_t length) {
+  Scope scope(*this);
+  return make<facebook::jsi::Array>(
+      newPointer(v8::Array::New(isolate_, static_cast<int>(length))));
+}
+
+#if JSI_VERSION >= 9
+facebook::jsi::ArrayBuffer V8DirectRuntime::createArrayBuffer(
+    std::shared_ptr<facebook::jsi::MutableBuffer> buffer) {
+  Scope scope(*this);
+#ifdef V8_ENABLE_SANDBOX
+  // Backing stores must live inside the sandbox cage; copy, as the ABI does.
+  v8::Local<v8::ArrayBuffer> ab =
+      v8::ArrayBuffer::New(isolate_, buffer->size());
+  if (buffer->size() != 0)
+    std::memcpy(ab->Data(), buffer->data(), buffer->size());
+#else
+  auto *ref = new std::shared_ptr<facebook::jsi::MutableBuffer>(buffer);
+  std::unique_ptr<v8::BackingStore> backingStore =
+      v8::ArrayBuffer::NewBackingStore(
+          buffer->data(), buffer->size(),
+          [](void * /*data*/, size_t /*length*/, void *deleterData) {
+            delete static_cast<std::shared_ptr<facebook::jsi::MutableBuffer> *>(
+                deleterData);
+          },
+          ref);
+  v8::Local<v8::ArrayBuffer> ab =
+      v8::ArrayBuffer::New(isolate_, std::move(backingStore));
+#endif  // V8_ENABLE_SANDBOX
+  return make<facebook::jsi::ArrayBuffer>(newPointer(ab));
+}
+#endif
+
+size_t V8DirectRuntime::size(const facebook::jsi::Array &arr) {
+  Scope scope(*this);
+  return toLocal(arr).As<v8::Array>()->Length();
+}
+
+size_t V8DirectRuntime::size(const facebook::jsi::ArrayBuffer &ab) {
+  Scope scope(*this);
+  return toLocal(ab).As<v8::ArrayBuffer>()->ByteLength();
+}
+
+uint8_t *V8DirectRuntime::data(const facebook::jsi::ArrayBuffer &ab) {
+  Scope scope(*this);
+  return static_cast<uint8_t *>(toLocal(ab).As<v8::ArrayBuffer>()->Data());
+}
+
+facebook::jsi::Value V8DirectRuntime::getValueAtIndex(
+    const facebook::jsi::Array &arr,
+    size_t i) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Value> result;
+  if (!toObject(arr)
+           ->Get(context(), static_cast<uint32_t>(i))
+           .ToLocal(&result))
+    throwPendingError(tryCatch);
+  return toValue(result);
+}
+
+void V8DirectRuntime::setValueAtIndexImpl(
+    JSI_CONST_10 facebook::jsi::Array &arr,
+    size_t i,
+    const facebook::jsi::Value &value) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  if (toObject(arr)
+          ->Set(context(), static_cast<uint32_t>(i), toLocal(value))
+          .IsNothing())
+    throwPendingError(tryCatch);
+}
+
+//==============================================================================
+// Function operations
+//==============================================================================
+
+void V8DirectRuntime::hostFunctionCallback(
+    const v8::FunctionCallbackInfo<v8::Value> &info) {
+  v8::Isolate *isolate = info.GetIsolate();
+  v8::HandleScope handleScope(isolate);
+  auto *ctx =
+      static_cast<HostFunctionContext *>(info.Data().As<v8::External>()->Value());
+  if (!ctx->runtime) {
+    isolate->ThrowException(v8::Exception::Error(v8::String::NewFromUtf8Literal(
+        isolate, "Host function called after its runtime was destroyed")));
+    return;
+  }
+  V8DirectRuntime &rt = *ctx->runtime;
+
+  try {
+    abi::BorrowedArgs<V8PointerValue> args(
+        static_cast<size_t>(info.Length()),
+        [&](size_t i, V8PointerValue *slot) {
+          return rt.borrowValue(
+              i == 0 ? info.This() : info[static_cast<int>(i - 1)], slot);
+        });
+    facebook::jsi::Value result =
+        ctx->func(rt, args.thisArg(), args.data(), args.size());
+    info.GetReturnValue().Set(rt.toLocal(result));
+  } catch (...) {
+    throwHostException(isolate, rt, "Exception in HostFunction: ");
+  }
+}
+
+void V8DirectRuntime::hostFunctionWeakCallback(
+    const v8::WeakCallbackInfo<HostFunctionContext> &info) {
+  HostFunctionContext *ctx = info.GetParameter();
+  ctx->registry.hostFunctions.erase(ctx->listIter);
+  delete ctx;
+}
+
+facebook::jsi::Function V8DirectRuntime::createFunctionFromHostFunction(
+    const facebook::jsi::PropNameID &name,
+    unsigned int paramCount,
+    facebook::jsi::HostFunctionType func) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Local<v8::Context> ctx = context();
+
+  auto hostFunction = std::make_unique<HostFunctionContext>(*this, std::move(func));
+  v8::Local<v8::External> data = v8::External::New(isolate_, hostFunction.get());
+
+  v8::Local<v8::Function> fn;
+  if (!v8::Function::New(
+           ctx, hostFunctionCallback, data, static_cast<int>(paramCount))
+           .ToLocal(&fn))
+    throwPendingError(tryCatch);
+
+  HostFunctionContext *tracked = hostFunction.release();
+  tracked->weakRef.Reset(isolate_, fn);
+  tracked->weakRef.SetWeak(
+      tracked, hostFunctionWeakCallback, v8::WeakCallbackType::kParameter);
+  tracked->listIter =
+      hosts_->hostFunctions.insert(hosts_->hostFunctions.end(), tracked);
+
+  fn->SetPrivate(ctx, hostFunctionKey_.Get(isolate_), data).Check();
+  v8::Local<v8::Value> v8name = toLocal(name);
+  if (v8name->IsString())
+    fn->SetName(v8name.As<v8::String>());
+
+  return make<facebook::jsi::Function>(newPointer(fn));
+}
+
+facebook::jsi::Value V8DirectRuntime::call(
+    const facebook::jsi::Function &fn,
+    const facebook::jsi::Value &jsThis,
+    const facebook::jsi::Value *args,
+    size_t count) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  abi::CallArgs<v8::Local<v8::Value>> argv(
+      args, count,
+      [this](const facebook::jsi::Value &arg) { return toLocal(arg); });
+  v8::Local<v8::Value> result;
+  if (!toLocal(fn)
+           .As<v8::Function>()
+           ->Call(context(), toLocal(jsThis), static_cast<int>(count),
+                  argv.data())
+           .ToLocal(&result))
+    throwPendingError(tryCatch);
+  return toValue(result);
+}
+
+facebook::jsi::Value V8DirectRuntime::callAsConstructor(
+    const facebook::jsi::Function &fn,
+    const facebook::jsi::Value *args,
+    size_t count) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  abi::CallArgs<v8::Local<v8::Value>> argv(
+      args, count,
+      [this](const facebook::jsi::Value &arg) { return toLocal(arg); });
+  v8::Local<v8::Object> result;
+  if (!toLocal(fn)
+           .As<v8::Function>()
+           ->NewInstance(context(), static_cast<int>(count), argv.data())
+           .ToLocal(&result))
+    throwPendingError(tryCatch);
+  return make<facebook::jsi::Object>(newPointer(result));
+}
+
+//==============================================================================
+// Host object interceptors
+//==============================================================================
+
+// Interceptors also run for objects that inherit from a host object, so walk
+// the prototype chain to the instance carrying the internal field.
+V8DirectRuntime::HostObjectProxy *V8DirectRuntime::getHostObjectProxy(
+    v8::Local<v8::Object> obj) {
+  while (obj->InternalFieldCount() != 1) {
+    v8::Local<v8::Value> proto = obj->GetPrototypeV2();
+    if (proto.IsEmpty() || !proto->IsObject())
+      return nullptr;
+    obj = proto.As<v8::Object>();
+  }
+  v8::Local<v8::Value> external = obj->GetInternalField(0).As<v8::Value>();
+  if (external.IsEmpty() || !external->IsExternal())
+    return nullptr;
+  // Once its runtime is gone, a host object behaves as a plain object.
+  auto *proxy =
+      static_cast<HostObjectProxy *>(external.As<v8::External>()->Value());
+  return proxy->runtime ? proxy : nullptr;
+}
+
+void V8DirectRuntime::hostObjectWeakCallback(
+    const v8::WeakCallbackInfo<HostObjectProxy> &info) {
+  HostObjectProxy *proxy = info.GetParameter();
+  proxy->registry.hostObjects.erase(proxy->listIter);
+  delete proxy;
+}
+
+void V8DirectRuntime::nativeStateWeakCallback(
+    const v8::WeakCallbackInfo<NativeStateHolder> &info) {
+  NativeStateHolder *holder = info.GetParameter();
+  holder->registry.nativeStates.erase(holder->listIter);
+  delete holder;
+}
+
+v8::Intercepted V8DirectRuntime::hostObjectGet(
+    v8::Local<v8::Name> name,
+    const v8::PropertyCallbackInfo<v8::Value> &info) {
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (!proxy)
+    return v8::Intercepted::kNo;
+
+  V8DirectRuntime &rt = *proxy->runtime;
+  try {
+    V8PointerValue nameValue(V8PointerValue::Borrowed{}, name);
+    facebook::jsi::PropNameID jsiName =
+        make<facebook::jsi::PropNameID>(&nameValue);
+    facebook::jsi::Value result = proxy->hostObject->get(rt, jsiName);
+    info.GetReturnValue().Set(rt.toLocal(result));
+  } catch (...) {
+    throwHostException(info.GetIsolate(), rt, "");
+  }
+  return v8::Intercepted::kYes;
+}
+
+v8::Intercepted V8DirectRuntime::hostObjectSet(
+    v8::Local<v8::Name> name,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info) {
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (!proxy)
+    return v8::Intercepted::kNo;
+
+  V8DirectRuntime &rt = *proxy->runtime;
+  try {
+    V8PointerValue nameValue(V8PointerValue::Borrowed{}, name);
+    facebook::jsi::PropNameID jsiName =
+        make<facebook::jsi::PropNameID>(&nameValue);
+    facebook::jsi::Value jsiValue = rt.toValue(value);
+    proxy->hostObject->set(rt, jsiName, jsiValue);
+  } catch (...) {
+    throwHostException(info.GetIsolate(), rt, "");
+  }
+  return v8::Intercepted::kYes;
+}
+
+v8::Intercepted V8DirectRuntime::hostObjectGetIndexed(
+    uint32_t index,
+    const v8::PropertyCallbackInfo<v8::Value> &info) {
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (proxy && proxy->indexed) {
+    V8DirectRuntime &rt = *proxy->runtime;
+    try {
+      facebook::jsi::Value result = proxy->indexed->getIndex(rt, index);
+      info.GetReturnValue().Set(rt.toLocal(result));
+    } catch (...) {
+      throwHostException(info.GetIsolate(), rt, "");
+    }
+    return v8::Intercepted::kYes;
+  }
+
+  v8::Local<v8::String> name =
+      v8::Integer::NewFromUnsigned(info.GetIsolate(), index)
+          ->ToString(info.GetIsolate()->GetCurrentContext())
+          .ToLocalChecked();
+  return hostObjectGet(name, info);
+}
+
+v8::Intercepted V8DirectRuntime::hostObjectSetIndexed(
+    uint32_t index,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info) {
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (proxy && proxy->indexed) {
+    V8DirectRuntime &rt = *proxy->runtime;
+    try {
+      facebook::jsi::Value jsiValue = rt.toValue(value);
+      proxy->indexed->setIndex(rt, index, jsiValue);
+    } catch (...) {
+      throwHostException(info.GetIsolate(), rt, "");
+    }
+    return v8::Intercepted::kYes;
+  }
+
+  v8::Local<v8::String> name =
+      v8::Integer::NewFromUnsigned(info.GetIsolate(), index)
+          ->ToString(info.GetIsolate()->GetCurrentContext())
+          .ToLocalChecked();
+  return hostObjectSet(name, value, info);
+}
+
+void V8DirectRuntime::hostObjectEnumerator(
+    const v8::PropertyCallbackInfo<v8::Array> &info) {
+  v8::Isolate *isolate = info.GetIsolate();
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (!proxy) {
+    info.GetReturnValue().Set(v8::Array::New(isolate));
+    return;
+  }
+
+  V8DirectRuntime &rt = *proxy->runtime;
+  try {
+    std::vector<facebook::jsi::PropNameID> names =
+        proxy->hostObject->getPropertyNames(rt);
+    v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+    v8::Local<v8::Array> result =
+        v8::Array::New(isolate, static_cast<int>(names.size()));
+    for (size_t i = 0; i < names.size(); ++i)
+      result->Set(ctx, static_cast<uint32_t>(i), rt.toLocal(names[i]))
+          .FromMaybe(false);
+    info.GetReturnValue().Set(result);
+  } catch (...) {
+    // Matches the ABI proxy: a failing getPropertyNames enumerates nothing.
+    info.GetReturnValue().Set(v8::Array::New(isolate));
+  }
+}
+
+void V8DirectRuntime::hostObjectIndexedEnumerator(
+    const v8::PropertyCallbackInfo<v8::Array> &info) {
+  v8::Isolate *isolate = info.GetIsolate();
+  HostObjectProxy *proxy = getHostObjectProxy(info.This());
+  if (!proxy || !proxy->indexed) {
+    info.GetReturnValue().Set(v8::Array::New(isolate));
+    return;
+  }
+
+  try {
+    uint32_t length = proxy->indexed->length(*proxy->runtime);
+    v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+    v8::Local<v8::Array> result =
+        v8::Array::New(isolate, static_cast<int>(length));
+    for (uint32_t i = 0; i < length; ++i)
+      result->Set(ctx, i, v8::Integer::NewFromUnsigned(isolate, i))
+          .FromMaybe(false);
+    info.GetReturnValue().Set(result);
+  } catch (...) {
+    info.GetReturnValue().Set(v8::Array::New(isolate));
+  }
+}
+
+//==============================================================================
+// Comparison
+//==============================================================================
+
+bool V8DirectRuntime::strictEquals(
+    const facebook::jsi::Symbol &a,
+    const facebook::jsi::Symbol &b) const {
+  Scope scope(*this);
+  return toLocal(a)->StrictEquals(toLocal(b));
+}
+
+#if JSI_VERSION >= 6
+bool V8DirectRuntime::strictEquals(
+    const facebook::jsi::BigInt &a,
+    const facebook::jsi::BigInt &b) const {
+  Scope scope(*this);
+  return toLocal(a)->StrictEquals(toLocal(b));
+}
+#endif
+
+bool V8DirectRuntime::strictEquals(
+    const facebook::jsi::String &a,
+    const facebook::jsi::String &b) const {
+  Scope scope(*this);
+  return toLocal(a)->StrictEquals(toLocal(b));
+}
+
+bool V8DirectRuntime::strictEquals(
+    const facebook::jsi::Object &a,
+    const facebook::jsi::Object &b) const {
+  Scope scope(*this);
+  return toLocal(a)->StrictEquals(toLocal(b));
+}
+
+bool V8DirectRuntime::instanceOf(
+    const facebook::jsi::Object &o,
+    const facebook::jsi::Function &f) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  v8::Maybe<bool> result = toObject(o)->InstanceOf(context(), toObject(f));
+  if (result.IsNothing())
+    throwPendingError(tryCatch);
+  return result.FromJust();
+}
+
+//==============================================================================
+// External memory pressure
+//==============================================================================
+
+#if JSI_VERSION >= 11
+void V8DirectRuntime::setExternalMemoryPressure(
+    const facebook::jsi::Object &obj,
+    size_t amount) {
+  Scope scope(*this);
+  v8::TryCatch tryCatch(isolate_);
+  if (!v8rt_internal::getExternalMemoryTable(abiRt_).set(
+          isolate_, context(), toObject(obj), amount))
+    throwPendingError(tryCatch);
+}
+#endif
+
+} // namespace
+
+} // namespace v8runtime
+
+//==============================================================================
+// Factory
+//==============================================================================
+
+JSI_API void *JSI_CDECL v8_create_direct_runtime(
+    uint32_t requested_abi_version,
+    jsi_configure_runtime_cb configure,
+    void *configure_data) {
+  jsi_runtime *rt =
+      v8_create_runtime(requested_abi_version, configure, configure_data);
+  if (!rt)
+    return nullptr;
+  // Handed out through the base class: makeV8DirectRuntime casts it back to
+  // facebook::jsi::Runtime*.
+  facebook::jsi::Runtime *runtime = new v8runtime::V8DirectRuntime(rt);
+  return runtime;
+}
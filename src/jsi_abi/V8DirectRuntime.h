@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// In-process facebook::jsi::Runtime implemented directly on V8.
+//
+// The default makeV8Runtime hands out a JsiAbiRuntime: every jsi::Runtime call
+// crosses the jsi_runtime_vtable and every handle is a ManagedPointerHolder
+// around an ABI HandleWrapper. The direct runtime lives inside v8jsi.dll and
+// implements jsi::Runtime against V8 itself, with one PointerValue per handle.
+//
+// The object this returns is NOT ABI-safe. Its vtable, the facebook::jsi::Value
+// layout it reads and the heap it frees into all belong to v8jsi.dll, so a
+// consumer may only opt in (V8RuntimeArgs::flags.directRuntime) when it is
+// built against the same JSI_VERSION and shares the DLL's C++ runtime. The
+// export itself has C linkage and hands the runtime out as an opaque pointer,
+// so a consumer that never opts in still links against C symbols only.
+
+#pragma once
+
+#include "jsi_abi/jsi_abi.h"
+
+#include "V8JsiRuntime.h"
+
+#include <memory>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Create a direct V8 runtime. Takes the same arguments as v8_create_runtime
+/// and returns the new facebook::jsi::Runtime*, owned by the caller, as an
+/// opaque pointer; NULL if v8_create_runtime fails. Use makeV8DirectRuntime
+/// rather than calling this directly.
+JSI_API void *JSI_CDECL v8_create_direct_runtime(
+    uint32_t requested_abi_version,
+    jsi_configure_runtime_cb configure,
+    void *configure_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace v8runtime {
+
+/// Create a direct V8 runtime. Configuration goes through the same callback and
+/// v8_jsi_config_* setters as v8_create_runtime; script evaluation, prepared
+/// scripts and the script cache are served by that underlying runtime.
+/// Throws facebook::jsi::JSINativeException if the runtime cannot be created.
+inline std::unique_ptr<facebook::jsi::Runtime> makeV8DirectRuntime(
+    jsi_configure_runtime_cb configure,
+    void *configure_data) {
+  void *rt =
+      v8_create_direct_runtime(JSI_ABI_VERSION, configure, configure_data);
+  if (!rt) {
+    throw facebook::jsi::JSINativeException(
+        "V8 direct runtime creation failed: configure error");
+  }
+  return std::unique_ptr<facebook::jsi::Runtime>(
+      static_cast<facebook::jsi::Runtime *>(rt));
+}
+
+} // namespace v8runtime
@@ -74,7 +74,15 @@ extern "C" {
  * the runtime to it or fails if it exceeds the implementation's max (Model B).
  *==========================================================================*/
 
-#define JSI_ABI_VERSION 1u
+#define JSI_ABI_VERSION 6u
+
+/* Version history:
+ *   1 - initial ABI.
+ *   2 - jsi_host_object_vtable gains get_index / set_index / get_length.
+ *   3 - jsi_runtime_vtable gains get_string_data / get_propnameid_data.
+ *   4 - jsi_runtime_vtable gains prepare_javascript_from_store.
+ *   5 - jsi_runtime_vtable gains prepare_javascript_async.
+ *   6 - jsi_runtime_vtable gains notify_startup_complete. */
 
 /*==========================================================================
  * Forward Declarations
@@ -104,6 +112,16 @@ typedef struct jsi_config_s* jsi_config;
  * with the same allocator that allocated it. */
 typedef void(JSI_CDECL *jsi_data_delete_cb)(void *data, void *deleter_data);
 
+/* Receives a chunk of a string's characters from get_string_data /
+ * get_propnameid_data. If ascii is true, data points to num 7-bit ASCII
+ * bytes; otherwise to num UTF-16 code units. data is only valid during the
+ * call, and the callback must not call back into the runtime. */
+typedef void(JSI_CDECL *jsi_string_data_cb)(
+    void *ctx,
+    bool ascii,
+    const void *data,
+    size_t num);
+
 /*==========================================================================
  * Error Codes
  *==========================================================================*/
@@ -386,11 +404,24 @@ struct jsi_prepared_javascript_or_error {
   uintptr_t ptr_or_error;
 };
 
+/* Receives the result of prepare_javascript_async on the runtime's JS thread.
+ * On failure the error is pending on rt, as after a synchronous call. If the
+ * runtime is destroyed first, the callback runs with rt NULL and
+ * jsi_error_native (nothing pending) so that ctx can be freed. */
+typedef void(JSI_CDECL *jsi_prepare_javascript_cb)(
+    void *ctx,
+    struct jsi_runtime *rt,
+    struct jsi_prepared_javascript_or_error result);
+
 /*==========================================================================
  * Callback Types (embedded-struct pattern — from Hermes ABI)
  *==========================================================================*/
 
-/* Host function: called when JS invokes a native function. */
+/* Host function: called when JS invokes a native function.
+ *
+ * this_arg and args are borrowed: they are valid only until call returns and
+ * the callee must not invalidate them. To keep an argument beyond the call,
+ * promote it with the matching clone_* function. */
 struct jsi_host_function_vtable {
   void(JSI_CDECL *release)(struct jsi_host_function *);
   struct jsi_value_or_error(JSI_CDECL *call)(
@@ -433,6 +464,25 @@ struct jsi_host_object_vtable {
   struct jsi_propnameid_list_or_error(JSI_CDECL *get_own_keys)(
       struct jsi_host_object *self,
       struct jsi_runtime *rt);
+
+  /* Indexed access (JSI_ABI_VERSION >= 2). The engine only reads these when
+   * the runtime was created with a requested_abi_version of 2 or later. If
+   * get_index is NULL the host object is not indexed and integer keys reach
+   * get/set as property names; otherwise all three must be set, get/set then
+   * only see non-index names, and enumeration lists indices [0, length)
+   * ahead of get_own_keys. */
+  struct jsi_value_or_error(JSI_CDECL *get_index)(
+      struct jsi_host_object *self,
+      struct jsi_runtime *rt,
+      uint32_t index);
+  enum jsi_error_code(JSI_CDECL *set_index)(
+      struct jsi_host_object *self,
+      struct jsi_runtime *rt,
+      uint32_t index,
+      const struct jsi_value *value);
+  struct jsi_size_or_error(JSI_CDECL *get_length)(
+      struct jsi_host_object *self,
+      struct jsi_runtime *rt);
 };
 struct jsi_host_object {
   const struct jsi_host_object_vtable *vtable;
@@ -551,7 +601,15 @@ struct jsi_runtime_vtable {
 
   /* Push a new handle scope. All pointer types created after this call
    * are valid until pop_scope. Engines that don't need scopes (Hermes)
-   * can implement these as no-ops. */
+   * can implement these as no-ops.
+   *
+   * Scopes nest and must be popped in LIFO order; pop_scope takes the
+   * value written to *scope by the matching push_scope and returns
+   * jsi_error_native if it is not the innermost open scope. In the V8
+   * implementation, a pointer invalidated inside its scope leaves its memory
+   * to the scope's next pointer, and pop_scope returns that memory to the
+   * runtime in bulk. Pointers that are not invalidated before pop_scope stay
+   * valid until they are. */
   enum jsi_error_code(JSI_CDECL *push_scope)(
       struct jsi_runtime *rt,
       void **scope);
@@ -563,6 +621,12 @@ struct jsi_runtime_vtable {
    * Script evaluation
    *----------------------------------------------------------------------*/
 
+  /* evaluate_javascript_source and prepare_javascript take ownership of buf
+   * and release it through buf->vtable->release. If buf has a release
+   * callback, the engine may keep reading the bytes after the call returns
+   * (e.g. wrapping an ASCII source in place) and releases them once the
+   * source string is collected. A buffer without one is copied before the
+   * call returns, so its bytes may be freed right after. */
   struct jsi_value_or_error(JSI_CDECL *evaluate_javascript_source)(
       struct jsi_runtime *rt,
       struct jsi_buffer *buf,
@@ -894,6 +958,69 @@ struct jsi_runtime_vtable {
       struct jsi_runtime *rt,
       struct jsi_bigint bigint,
       uint32_t radix);
+
+  /*----------------------------------------------------------------------
+   * String data (JSI_ABI_VERSION >= 3)
+   *----------------------------------------------------------------------*/
+
+  /* Invoke cb one or more times with consecutive chunks of the string's
+   * characters, read in place where the engine's representation allows
+   * (Runtime::getStringData). cb is called once with an empty chunk for an
+   * empty string. */
+  void(JSI_CDECL *get_string_data)(
+      struct jsi_runtime *rt,
+      struct jsi_string str,
+      void *ctx,
+      jsi_string_data_cb cb);
+  /* As get_string_data, for a PropNameID (Runtime::getPropNameIdData). A
+   * symbol-backed name yields its description. */
+  void(JSI_CDECL *get_propnameid_data)(
+      struct jsi_runtime *rt,
+      struct jsi_propnameid name,
+      void *ctx,
+      jsi_string_data_cb cb);
+
+  /*----------------------------------------------------------------------
+   * Script store (JSI_ABI_VERSION >= 4)
+   *----------------------------------------------------------------------*/
+
+  /* Prepare the script the runtime's script store holds for source_url
+   * (source_url[source_url_len] must be '\0'). The store's version for the
+   * script, when it has one, keys the code cache instead of a hash of the
+   * source. Fails with jsi_error_native if the runtime has no script store or
+   * the store has no script for source_url. */
+  struct jsi_prepared_javascript_or_error(
+      JSI_CDECL *prepare_javascript_from_store)(
+      struct jsi_runtime *rt,
+      const char *source_url,
+      size_t source_url_len);
+
+  /*----------------------------------------------------------------------
+   * Async prepare (JSI_ABI_VERSION >= 5)
+   *----------------------------------------------------------------------*/
+
+  /* As prepare_javascript, but parses the source off the JS thread and
+   * returns at once. Takes over buf. cb runs exactly once, from a task posted
+   * to the runtime's foreground task runner (v8_jsi_config_set_task_runner).
+   * A runtime without a task runner prepares the script synchronously and
+   * calls cb before returning. */
+  void(JSI_CDECL *prepare_javascript_async)(
+      struct jsi_runtime *rt,
+      struct jsi_buffer *buf,
+      const char *source_url,
+      size_t source_url_len,
+      void *ctx,
+      jsi_prepare_javascript_cb cb);
+
+  /*----------------------------------------------------------------------
+   * Startup signal (JSI_ABI_VERSION >= 6)
+   *----------------------------------------------------------------------*/
+
+  /* Tells the runtime that the host has finished starting up. The runtime
+   * may persist what it learned while starting, such as code caches that now
+   * include the functions compiled since the scripts were prepared. Calls
+   * after the first do nothing. */
+  void(JSI_CDECL *notify_startup_complete)(struct jsi_runtime *rt);
 };
 
 /*==========================================================================
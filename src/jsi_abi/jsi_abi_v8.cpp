@@ -31,8 +31,11 @@
 #include "jsi_abi/v8_jsi_config.h"
 #include "jsi_abi/v8_snapshot_container.h"
 #include "jsi_abi/jsi_abi_v8_internal.h"
+#include "jsi_abi/StringDataView.h"
 #include "../v8_core.h"
-#include "../MurmurHash.h"
+#include "../v8_string.h"
+#include "../v8_source_hash.h"
+#include "../v8_script_streaming.h"
 #include "v8-profiler.h"
 
 #if defined(_WIN32) && defined(V8JSI_ENABLE_INSPECTOR)
@@ -40,14 +43,19 @@
 #endif
 
 #include <atomic>
+#include <cstddef>
+#include <new>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
 #include <list>
+#include <mutex>
 #include <optional>
+#include <utility>
 #include <sstream>
 #include <ostream>
 #include <fstream>
@@ -107,6 +115,19 @@ struct jsi_config_s {
   v8_jsi_script_cache_store_cb script_cache_store_cb{nullptr};
   jsi_data_delete_cb script_cache_data_delete_cb{nullptr};
   void *script_cache_deleter_data{nullptr};
+  v8_jsi_script_cache_reject_cb script_cache_reject_cb{nullptr};
+  bool background_code_cache{false};
+  bool warm_code_cache{false};
+  uint32_t warm_code_cache_delay_ms{0};
+  size_t compiled_script_cache_size{0};
+
+  // Script store — a null load callback means "no store". Same lifetime
+  // contract as the script-cache fields above.
+  void *script_store_data{nullptr};
+  v8_jsi_script_store_load_cb script_store_load_cb{nullptr};
+  jsi_data_delete_cb script_store_data_delete_cb{nullptr};
+  void *script_store_deleter_data{nullptr};
+  bool lazy_script_source{false};
 
   // Task runner — null callbacks mean "no task runner".
   // Same lifetime contract as the script-cache fields above: config takes
@@ -133,6 +154,9 @@ struct jsi_config_s {
     if (script_cache_data_delete_cb) {
       script_cache_data_delete_cb(script_cache_data, script_cache_deleter_data);
     }
+    if (script_store_data_delete_cb) {
+      script_store_data_delete_cb(script_store_data, script_store_deleter_data);
+    }
     if (task_runner_data_delete_cb) {
       task_runner_data_delete_cb(task_runner_data, task_runner_deleter_data);
     }
@@ -153,6 +177,8 @@ namespace {
 struct JsiRuntimeState;
 struct AbiHostObjectProxy;
 struct HostFunctionContext;
+struct AsyncPrepare;
+class WarmCodeCacheTimer;
 
 //==============================================================================
 // TaskRunner adapter (C-callbacks → v8rt::TaskRunner)
@@ -206,6 +232,228 @@ class CTaskRunner final : public v8rt::TaskRunner {
   void *deleter_data_;
 };
 
+//==============================================================================
+// Handle Wrapper Allocation
+//==============================================================================
+
+/// Live/peak counts of one runtime's handle wrappers, kept by its HandlePool
+/// for pooled and scoped wrappers alike. Reported by v8_jsi_get_handle_stats.
+struct HandleCounters {
+  size_t live{0};
+  size_t peak{0};
+
+  void onCreate() noexcept {
+    if (++live > peak)
+      peak = live;
+  }
+  void onRelease() noexcept { --live; }
+};
+
+/// Owner of the memory behind a handle wrapper. Every wrapper records its
+/// store so that its invalidate callback can hand the bytes back after running
+/// the destructor.
+class HandleStore {
+ public:
+  virtual void release(void *slot) noexcept = 0;
+
+ protected:
+  ~HandleStore() = default;
+};
+
+/// Memory for one handle wrapper. The wrappers are tiny and uniform, so they
+/// all share this size; a free slot links to the next one.
+union HandleSlot {
+  HandleSlot *next;
+  unsigned char bytes[4 * sizeof(void *)];
+};
+
+/// Per-runtime fixed-size slab allocator for handle wrappers, with a single
+/// intrusive free list. Scope frames borrow their slots from it. Slabs are
+/// only returned to the heap when the runtime is destroyed.
+///
+/// Like the wrappers themselves, the pool is only touched on the JS thread.
+class HandlePool final : public HandleStore {
+ public:
+  static constexpr size_t kSlotsPerSlab = 256;
+
+  explicit HandlePool(HandleCounters &counters) noexcept
+      : counters_(counters) {}
+
+  HandlePool(const HandlePool &) = delete;
+  HandlePool &operator=(const HandlePool &) = delete;
+
+  template <typename Handle, typename... Args>
+  Handle *create(Args &&...args) {
+    return construct<Handle>(take(), this, std::forward<Args>(args)...);
+  }
+
+  void release(void *p) noexcept override {
+    auto *slot = static_cast<HandleSlot *>(p);
+    give(slot, slot);
+    counters_.onRelease();
+  }
+
+  /// Constructs a Handle owned by store in slot.
+  template <typename Handle, typename... Args>
+  Handle *construct(HandleSlot *slot, HandleStore *store, Args &&...args) {
+    static_assert(sizeof(Handle) <= sizeof(HandleSlot) &&
+                      alignof(Handle) <= alignof(HandleSlot),
+                  "handle wrapper does not fit a pool slot");
+    Handle *handle = new (slot) Handle(std::forward<Args>(args)...);
+    handle->store = store;
+    counters_.onCreate();
+    return handle;
+  }
+
+  /// Takes a free slot off the pool.
+  HandleSlot *take() {
+    if (!freeList_)
+      grow();
+    HandleSlot *slot = freeList_;
+    freeList_ = slot->next;
+    return slot;
+  }
+
+  /// Puts back the free slots head..tail, already linked together.
+  void give(HandleSlot *head, HandleSlot *tail) noexcept {
+    tail->next = freeList_;
+    freeList_ = head;
+  }
+
+  HandleCounters &counters() noexcept { return counters_; }
+
+  size_t slabCount() const noexcept { return slabs_.size(); }
+
+ private:
+  void grow() {
+    auto slab = std::make_unique<HandleSlot[]>(kSlotsPerSlab);
+    for (size_t i = kSlotsPerSlab; i > 0; --i) {
+      slab[i - 1].next = freeList_;
+      freeList_ = &slab[i - 1];
+    }
+    slabs_.push_back(std::move(slab));
+  }
+
+  HandleCounters &counters_;
+  std::vector<std::unique_ptr<HandleSlot[]>> slabs_;
+  HandleSlot *freeList_{nullptr};
+};
+
+/// One level of jsi_push_scope nesting. Wrappers created while the frame is
+/// the innermost open scope take their slots from the runtime's HandlePool,
+/// and a wrapper invalidated while the frame is open puts its slot on the
+/// frame's own free list, where the scope's next wrapper picks it up. A scope
+/// that churns temporaries therefore cycles through a fixed set of slots, and
+/// jsi_pop_scope hands that free list back to the pool in one splice.
+///
+/// jsi::Scope is only advisory, so a wrapper may outlive its scope. It holds
+/// on to nothing but its own slot, which goes straight back to the pool when
+/// the wrapper is invalidated.
+class ScopeFrame final : public HandleStore {
+ public:
+  explicit ScopeFrame(HandlePool &pool) noexcept : pool_(pool) {}
+
+  ScopeFrame(const ScopeFrame &) = delete;
+  ScopeFrame &operator=(const ScopeFrame &) = delete;
+
+  template <typename Handle, typename... Args>
+  Handle *create(Args &&...args) {
+    HandleSlot *slot = freeList_;
+    if (slot) {
+      freeList_ = slot->next;
+      if (!freeList_)
+        freeTail_ = nullptr;
+    } else {
+      slot = pool_.take();
+    }
+    return pool_.construct<Handle>(slot, this, std::forward<Args>(args)...);
+  }
+
+  void release(void *p) noexcept override {
+    pool_.counters().onRelease();
+    auto *slot = static_cast<HandleSlot *>(p);
+    if (!open_) {
+      // The wrapper outlived its scope.
+      pool_.give(slot, slot);
+      return;
+    }
+    slot->next = freeList_;
+    freeList_ = slot;
+    if (!freeTail_)
+      freeTail_ = slot;
+  }
+
+  void open() noexcept { open_ = true; }
+
+  void close() noexcept {
+    open_ = false;
+    if (freeList_)
+      pool_.give(freeList_, freeTail_);
+    freeList_ = freeTail_ = nullptr;
+  }
+
+ private:
+  HandlePool &pool_;
+  HandleSlot *freeList_{nullptr};
+  HandleSlot *freeTail_{nullptr};
+  bool open_{false};
+};
+
+/// The runtime's jsi_push_scope scopes, innermost last. The frames of closed
+/// scopes are kept and reused by later scopes at the same depth, so only a
+/// scope nested deeper than any before it allocates. Wrappers that outlive
+/// their scope point at these frames, which live as long as the runtime.
+class ScopeStack {
+ public:
+  explicit ScopeStack(HandlePool &pool) noexcept : pool_(pool) {}
+
+  ScopeStack(const ScopeStack &) = delete;
+  ScopeStack &operator=(const ScopeStack &) = delete;
+
+  /// The innermost open scope, or null.
+  ScopeFrame *current() const noexcept {
+    return depth_ ? frames_[depth_ - 1].get() : nullptr;
+  }
+
+  ScopeFrame *push() {
+    if (depth_ == frames_.size())
+      frames_.push_back(std::make_unique<ScopeFrame>(pool_));
+    ScopeFrame *frame = frames_[depth_++].get();
+    frame->open();
+    return frame;
+  }
+
+  /// Closes the innermost scope. Returns false if no scope is open or frame
+  /// is neither null nor the innermost scope.
+  bool pop(const void *frame) noexcept {
+    ScopeFrame *top = current();
+    if (!top || (frame && frame != top))
+      return false;
+    top->close();
+    --depth_;
+    return true;
+  }
+
+  void closeAll() noexcept {
+    while (pop(nullptr)) {
+    }
+  }
+
+ private:
+  HandlePool &pool_;
+  std::vector<std::unique_ptr<ScopeFrame>> frames_;
+  size_t depth_{0};
+};
+
+/// Destroy a handle wrapper and return its memory to the pool or scope frame
+/// it was allocated from.
+template <typename Handle>
+void destroyHandle(Handle *handle) noexcept {
+  HandleStore *store = handle->store;
+  handle->~Handle();
+  store->release(handle);
+}
+
 //==============================================================================
 // Handle Wrapper Types (inherit from jsi_pointer)
 //==============================================================================
@@ -216,20 +464,36 @@ class CTaskRunner final : public v8rt::TaskRunner {
 template <typename V8Type>
 struct HandleWrapper : public jsi_pointer {
   static void JSI_CDECL invalidate(jsi_pointer *self) {
-    delete static_cast<HandleWrapper *>(self);
+    destroyHandle(static_cast<HandleWrapper *>(self));
   }
   static constexpr jsi_pointer_vtable pointerVt{invalidate};
 
+  // Borrowed wrappers are owned by the host function call that created them
+  // (see BorrowedHostCallArgs); invalidate from the callee is a no-op.
+  static void JSI_CDECL invalidateBorrowed(jsi_pointer * /*self*/) {}
+  static constexpr jsi_pointer_vtable borrowedVt{invalidateBorrowed};
+
+  struct Borrowed {};
+
   v8::Persistent<V8Type> persistent;
+  HandleStore *store{nullptr}; // pool or scope frame owning this wrapper
+  v8::Local<V8Type> borrowed;  // set instead of persistent when borrowed
 
   HandleWrapper(v8::Isolate *iso, v8::Local<V8Type> local)
       : jsi_pointer{&pointerVt} {
     persistent.Reset(iso, local);
   }
 
+  /// Wrap a local from an enclosing HandleScope without creating a global
+  /// handle. Only valid while that HandleScope is open.
+  HandleWrapper(Borrowed, v8::Local<V8Type> local)
+      : jsi_pointer{&borrowedVt}, borrowed(local) {}
+
   ~HandleWrapper() { persistent.Reset(); }
 
   v8::Local<V8Type> get(v8::Isolate *isolate) const {
+    if (!borrowed.IsEmpty())
+      return borrowed;
     return persistent.Get(isolate);
   }
 };
@@ -265,11 +529,12 @@ struct PreparedScriptImpl : public jsi_prepared_javascript {
 /// Wrapper for property name IDs (can be string or symbol).
 struct PropNameIdHandle : public jsi_pointer {
   static void JSI_CDECL invalidate(jsi_pointer *self) {
-    delete static_cast<PropNameIdHandle *>(self);
+    destroyHandle(static_cast<PropNameIdHandle *>(self));
   }
   static constexpr jsi_pointer_vtable pointerVt{invalidate};
 
   v8::Persistent<v8::Value> persistent; // String or Symbol
+  HandleStore *store{nullptr}; // pool or scope frame owning this wrapper
 
   PropNameIdHandle(v8::Isolate *iso, v8::Local<v8::Value> local)
       : jsi_pointer{&pointerVt} {
@@ -286,11 +551,12 @@ struct PropNameIdHandle : public jsi_pointer {
 /// Wrapper for weak object references.
 struct WeakObjectHandle : public jsi_pointer {
   static void JSI_CDECL invalidate(jsi_pointer *self) {
-    delete static_cast<WeakObjectHandle *>(self);
+    destroyHandle(static_cast<WeakObjectHandle *>(self));
   }
   static constexpr jsi_pointer_vtable pointerVt{invalidate};
 
   v8::Persistent<v8::Object> persistent;
+  HandleStore *store{nullptr}; // pool owning this wrapper
 
   WeakObjectHandle(v8::Isolate *iso, v8::Local<v8::Object> local)
       : jsi_pointer{&pointerVt} {
@@ -346,61 +612,6 @@ void writeToBuf(jsi_growable_buffer *buf, const std::string &str) {
   writeToBuf(buf, str.data(), str.size());
 }
 
-//==============================================================================
-// V8 Value <-> jsi_value Conversion
-//==============================================================================
-
-/// Convert a V8 local value to a jsi_value, allocating handles for pointer
-/// types.
-jsi_value createJsiValue(v8::Isolate *isolate, v8::Local<v8::Value> val) {
-  if (val->IsUndefined())
-    return abi::create_undefined_value();
-  if (val->IsNull())
-    return abi::create_null_value();
-  if (val->IsBoolean())
-    return abi::create_bool_value(val->BooleanValue(isolate));
-  if (val->IsNumber())
-    return abi::create_number_value(
-        val->NumberValue(isolate->GetCurrentContext()).FromJust());
-  if (val->IsString())
-    return abi::create_string_value(
-        new StringHandle(isolate, v8::Local<v8::String>::Cast(val)));
-  if (val->IsSymbol())
-    return abi::create_symbol_value(
-        new SymbolHandle(isolate, v8::Local<v8::Symbol>::Cast(val)));
-  if (val->IsBigInt())
-    return abi::create_bigint_value(
-        new BigIntHandle(isolate, v8::Local<v8::BigInt>::Cast(val)));
-  if (val->IsObject())
-    return abi::create_object_value(
-        new ObjectHandle(isolate, v8::Local<v8::Object>::Cast(val)));
-  return abi::create_undefined_value();
-}
-
-/// Convert a jsi_value to a V8 local value.
-v8::Local<v8::Value> toV8Value(v8::Isolate *isolate, const jsi_value *val) {
-  switch (val->kind) {
-  case jsi_valuekind_undefined:
-    return v8::Undefined(isolate);
-  case jsi_valuekind_null:
-    return v8::Null(isolate);
-  case jsi_valuekind_boolean:
-    return v8::Boolean::New(isolate, val->data.boolean);
-  case jsi_valuekind_number:
-    return v8::Number::New(isolate, val->data.number);
-  case jsi_valuekind_string:
-    return static_cast<StringHandle *>(val->data.pointer)->get(isolate);
-  case jsi_valuekind_symbol:
-    return static_cast<SymbolHandle *>(val->data.pointer)->get(isolate);
-  case jsi_valuekind_bigint:
-    return static_cast<BigIntHandle *>(val->data.pointer)->get(isolate);
-  case jsi_valuekind_object:
-    return static_cast<ObjectHandle *>(val->data.pointer)->get(isolate);
-  default:
-    return v8::Undefined(isolate);
-  }
-}
-
 //==============================================================================
 // Internal Runtime State (extends jsi_runtime)
 //==============================================================================
@@ -457,6 +668,45 @@ struct JsiRuntimeState : public jsi_runtime {
   v8_jsi_script_cache_store_cb script_cache_store_cb{nullptr};
   jsi_data_delete_cb script_cache_data_delete_cb{nullptr};
   void *script_cache_deleter_data{nullptr};
+  v8_jsi_script_cache_reject_cb script_cache_reject_cb{nullptr};
+
+  // Reported by v8_jsi_get_code_cache_stats.
+  v8_jsi_code_cache_stats codeCacheStats{};
+
+  // True if loaded code caches are deserialized on a worker thread
+  // (CodeCacheConsumeJob).
+  bool backgroundCodeCache{false};
+
+  // A script prepared before startup completed, whose code cache is stored
+  // again once it does (v8_jsi_config_enable_warm_code_cache).
+  struct WarmScript {
+    std::string url;
+    uint64_t hash;
+    // Size of the code cache loaded or stored for the script, or 0.
+    size_t cacheSize;
+    v8::Global<v8::UnboundScript> script;
+  };
+  bool warmCodeCache{false};
+  uint32_t warmCodeCacheDelayMs{0};
+  bool startupComplete{false};
+  std::vector<WarmScript> warmScripts;
+  // Set while warmCodeCacheDelayMs is running.
+  std::shared_ptr<WarmCodeCacheTimer> warmCodeCacheTimer;
+
+  // Script store — copied from the config in create(). Runtime owns
+  // script_store_data after handoff: the deleter runs in ~JsiRuntimeState.
+  void *script_store_data{nullptr};
+  v8_jsi_script_store_load_cb script_store_load_cb{nullptr};
+  jsi_data_delete_cb script_store_data_delete_cb{nullptr};
+  void *script_store_deleter_data{nullptr};
+  // True if the sources of versioned scripts from the store are dropped once
+  // compiled and loaded again on demand (StoreSourceLoader).
+  bool lazyScriptSource{false};
+  // With lazyScriptSource, the sources V8 read again since they were last
+  // parked. A SourceParkTask on the foreground task runner, or else the next
+  // compile, parks them again. Outlives the isolate, whose strings deregister
+  // from it as they are disposed.
+  std::shared_ptr<v8rt::ReloadedSources> reloadedSources;
 
   // Startup-snapshot blob — copied from the config in create(). The runtime
   // owns the bytes after handoff: V8 references them for the isolate's whole
@@ -465,6 +715,34 @@ struct JsiRuntimeState : public jsi_runtime {
   jsi_data_delete_cb startup_snapshot_delete_cb{nullptr};
   void *startup_snapshot_deleter_data{nullptr};
 
+  // Handle wrapper allocation. Wrappers come from the innermost open
+  // jsi_push_scope frame if there is one, otherwise from the runtime's slab
+  // pool; either way their slots belong to the pool.
+  HandleCounters handleCounters;
+  HandlePool handlePool{handleCounters};
+  ScopeStack scopes{handlePool};
+
+  // Internalized strings for recently created property names. Shared with a
+  // V8DirectRuntime layered on this runtime (getPropNameInternTable).
+  v8rt_internal::PropNameInternTable propNameInternTable;
+
+  // External memory attached to objects by set_object_external_memory_pressure.
+  // Shared with a V8DirectRuntime layered on this runtime
+  // (getExternalMemoryTable) so both see the same per-object amounts.
+  v8rt_internal::ExternalMemoryTable externalMemoryTable;
+
+  // Hashes of sources still wrapped in place, so re-preparing the same buffer
+  // skips hashing it. Shared with Node-API (getSourceHashCache).
+  v8rt_internal::SourceHashCache sourceHashCache;
+
+  // Scripts compiled by prepare_javascript, so that preparing the same source
+  // again reuses them (v8_jsi_config_set_compiled_script_cache_size). Shared
+  // with a V8DirectRuntime layered on this runtime for its instrumentation.
+  v8rt_internal::CompiledScriptCache compiledScripts;
+
+  // prepare_javascript_async calls whose callback has not run yet.
+  std::list<std::shared_ptr<AsyncPrepare>> asyncPrepares;
+
   // Error state (v2 pattern)
   jsi_value pendingJSError{}; // JS exception value (inline tagged union)
   std::string nativeExceptionMessage;
@@ -491,6 +769,11 @@ struct JsiRuntimeState : public jsi_runtime {
   void *attached_owner{nullptr};
   v8rt_internal::RuntimeAttachedDestroyCb attached_owner_destroy{nullptr};
 
+  // v8rt_internal::addTeardownHook callbacks, run newest first in
+  // ~JsiRuntimeState after the attached owner.
+  std::vector<std::pair<v8rt_internal::RuntimeTeardownCb, void *>>
+      teardown_hooks;
+
 #if defined(_WIN32) && defined(V8JSI_ENABLE_INSPECTOR)
   // per-runtime inspector agent. nullptr when enable_inspector is false.
   // Held by shared_ptr so multiple JsiRuntimeStates on the same isolate
@@ -561,6 +844,72 @@ inline JsiRuntimeState *getState(jsi_runtime *rt) {
   return static_cast<JsiRuntimeState *>(rt);
 }
 
+//==============================================================================
+// V8 Value <-> jsi_value Conversion
+//==============================================================================
+
+/// Allocate a strong handle wrapper. Inside a jsi_push_scope scope the wrapper
+/// is tracked by the innermost scope's frame; otherwise it comes straight from
+/// the runtime's slab pool.
+template <typename Handle, typename V8Type>
+Handle *newHandle(JsiRuntimeState *state, v8::Local<V8Type> local) {
+  if (ScopeFrame *frame = state->scopes.current())
+    return frame->create<Handle>(state->isolate, local);
+  return state->handlePool.create<Handle>(state->isolate, local);
+}
+
+/// Convert a V8 local value to a jsi_value, allocating handles for pointer
+/// types.
+jsi_value createJsiValue(JsiRuntimeState *state, v8::Local<v8::Value> val) {
+  v8::Isolate *isolate = state->isolate;
+  if (val->IsUndefined())
+    return abi::create_undefined_value();
+  if (val->IsNull())
+    return abi::create_null_value();
+  if (val->IsBoolean())
+    return abi::create_bool_value(val->BooleanValue(isolate));
+  if (val->IsNumber())
+    return abi::create_number_value(
+        val->NumberValue(isolate->GetCurrentContext()).FromJust());
+  if (val->IsString())
+    return abi::create_string_value(
+        newHandle<StringHandle>(state, v8::Local<v8::String>::Cast(val)));
+  if (val->IsSymbol())
+    return abi::create_symbol_value(
+        newHandle<SymbolHandle>(state, v8::Local<v8::Symbol>::Cast(val)));
+  if (val->IsBigInt())
+    return abi::create_bigint_value(
+        newHandle<BigIntHandle>(state, v8::Local<v8::BigInt>::Cast(val)));
+  if (val->IsObject())
+    return abi::create_object_value(
+        newHandle<ObjectHandle>(state, v8::Local<v8::Object>::Cast(val)));
+  return abi::create_undefined_value();
+}
+
+/// Convert a jsi_value to a V8 local value.
+v8::Local<v8::Value> toV8Value(v8::Isolate *isolate, const jsi_value *val) {
+  switch (val->kind) {
+  case jsi_valuekind_undefined:
+    return v8::Undefined(isolate);
+  case jsi_valuekind_null:
+    return v8::Null(isolate);
+  case jsi_valuekind_boolean:
+    return v8::Boolean::New(isolate, val->data.boolean);
+  case jsi_valuekind_number:
+    return v8::Number::New(isolate, val->data.number);
+  case jsi_valuekind_string:
+    return static_cast<StringHandle *>(val->data.pointer)->get(isolate);
+  case jsi_valuekind_symbol:
+    return static_cast<SymbolHandle *>(val->data.pointer)->get(isolate);
+  case jsi_valuekind_bigint:
+    return static_cast<BigIntHandle *>(val->data.pointer)->get(isolate);
+  case jsi_valuekind_object:
+    return static_cast<ObjectHandle *>(val->data.pointer)->get(isolate);
+  default:
+    return v8::Undefined(isolate);
+  }
+}
+
 //==============================================================================
 // TryCatch with Auto-Capture
 //==============================================================================
@@ -573,7 +922,7 @@ public:
   ~TryCatch() {
     if (HasCaught()) {
       v8::Local<v8::Value> exception = Exception();
-      state_->pendingJSError = createJsiValue(state_->isolate, exception);
+      state_->pendingJSError = createJsiValue(state_, exception);
     }
   }
 
@@ -594,6 +943,9 @@ struct AbiHostObjectProxy {
   v8::Global<v8::Object> weakRef;
   std::list<AbiHostObjectProxy *>::iterator listIter;
   bool registered{false};
+  // Integer keys go to get_index/set_index instead of being stringified.
+  // The vtable only has those slots if the consumer negotiated ABI v2.
+  bool indexed{false};
 
   AbiHostObjectProxy(jsi_runtime *rt, jsi_host_object *ho,
                      v8::Isolate *isolate, v8::Local<v8::Object> obj)
@@ -602,6 +954,7 @@ struct AbiHostObjectProxy {
     weakRef.SetWeak(this, weak_callback, v8::WeakCallbackType::kParameter);
 
     auto *state = getState(runtime);
+    indexed = state->abi_version >= 2 && ho->vtable->get_index != nullptr;
     state->hostObjectProxies.push_back(this);
     listIter = std::prev(state->hostObjectProxies.end());
     registered = true;
@@ -639,37 +992,16 @@ struct AbiHostObjectProxy {
       return v8::Intercepted::kNo;
 
     v8::Isolate *isolate = info.GetIsolate();
+    auto *state = getState(proxy->runtime);
 
-    jsi_propnameid propNameId{new PropNameIdHandle(isolate, v8PropName)};
+    jsi_propnameid propNameId{newHandle<PropNameIdHandle>(state, v8PropName)};
 
     jsi_value_or_error result = proxy->hostObject->vtable->get(
         proxy->hostObject, proxy->runtime, propNameId);
 
     propNameId.pointer->vtable->invalidate(propNameId.pointer);
 
-    if (abi::is_error(result)) {
-      auto *state = getState(proxy->runtime);
-      if (abi::get_error(result) == jsi_error_js) {
-        jsi_value jsErr = state->pendingJSError;
-        if (abi::is_pointer_value(jsErr)) {
-          isolate->ThrowException(toV8Value(isolate, &jsErr));
-        }
-        state->pendingJSError = abi::create_undefined_value();
-      } else {
-        v8::Local<v8::String> message =
-            v8::String::NewFromUtf8(isolate,
-                                    state->nativeExceptionMessage.c_str())
-                .ToLocalChecked();
-        isolate->ThrowException(v8::Exception::Error(message));
-        state->nativeExceptionMessage.clear();
-      }
-      return v8::Intercepted::kYes;
-    }
-
-    jsi_value val = abi::get_value(result);
-    info.GetReturnValue().Set(toV8Value(isolate, &val));
-    abi::release_value(val);
-    return v8::Intercepted::kYes;
+    return ReturnResult(isolate, state, result, info);
   }
 
   static v8::Intercepted
@@ -680,9 +1012,10 @@ struct AbiHostObjectProxy {
       return v8::Intercepted::kNo;
 
     v8::Isolate *isolate = info.GetIsolate();
+    auto *state = getState(proxy->runtime);
 
-    jsi_propnameid propNameId{new PropNameIdHandle(isolate, v8PropName)};
-    jsi_value jsiValue = createJsiValue(isolate, value);
+    jsi_propnameid propNameId{newHandle<PropNameIdHandle>(state, v8PropName)};
+    jsi_value jsiValue = createJsiValue(state, value);
 
     jsi_error_code result = proxy->hostObject->vtable->set(
         proxy->hostObject, proxy->runtime, propNameId, &jsiValue);
@@ -691,7 +1024,6 @@ struct AbiHostObjectProxy {
     abi::release_value(jsiValue);
 
     if (abi::is_error(result)) {
-      auto *state = getState(proxy->runtime);
       if (abi::get_error(result) == jsi_error_js &&
           abi::is_pointer_value(state->pendingJSError)) {
         isolate->ThrowException(toV8Value(isolate, &state->pendingJSError));
@@ -713,6 +1045,14 @@ struct AbiHostObjectProxy {
   GetIndexed(uint32_t index,
              const v8::PropertyCallbackInfo<v8::Value> &info) {
     v8::Isolate *isolate = info.GetIsolate();
+    AbiHostObjectProxy *proxy = GetProxy(info);
+    if (proxy && proxy->hostObject && proxy->indexed) {
+      auto *state = getState(proxy->runtime);
+      jsi_value_or_error result = proxy->hostObject->vtable->get_index(
+          proxy->hostObject, proxy->runtime, index);
+      return ReturnResult(isolate, state, result, info);
+    }
+
     v8::Local<v8::String> indexStr =
         v8::String::NewFromUtf8(isolate, std::to_string(index).c_str())
             .ToLocalChecked();
@@ -723,12 +1063,56 @@ struct AbiHostObjectProxy {
   SetIndexed(uint32_t index, v8::Local<v8::Value> value,
              const v8::PropertyCallbackInfo<void> &info) {
     v8::Isolate *isolate = info.GetIsolate();
+    AbiHostObjectProxy *proxy = GetProxy(info);
+    if (proxy && proxy->hostObject && proxy->indexed) {
+      auto *state = getState(proxy->runtime);
+      jsi_value jsiValue = createJsiValue(state, value);
+      jsi_error_code result = proxy->hostObject->vtable->set_index(
+          proxy->hostObject, proxy->runtime, index, &jsiValue);
+      abi::release_value(jsiValue);
+      if (abi::is_error(result))
+        ThrowCallbackError(isolate, state, abi::get_error(result));
+      return v8::Intercepted::kYes;
+    }
+
     v8::Local<v8::String> indexStr =
         v8::String::NewFromUtf8(isolate, std::to_string(index).c_str())
             .ToLocalChecked();
     return Set(indexStr, value, info);
   }
 
+  // Reports [0, length) for indexed host objects; the named Enumerator
+  // covers get_own_keys.
+  static void
+  IndexedEnumerator(const v8::PropertyCallbackInfo<v8::Array> &info) {
+    v8::Isolate *isolate = info.GetIsolate();
+    AbiHostObjectProxy *proxy = GetProxyFromThis(info.This(), isolate);
+    if (!proxy || !proxy->hostObject || !proxy->indexed) {
+      info.GetReturnValue().Set(v8::Array::New(isolate));
+      return;
+    }
+
+    jsi_size_or_error length = proxy->hostObject->vtable->get_length(
+        proxy->hostObject, proxy->runtime);
+    if (abi::is_error(length)) {
+      info.GetReturnValue().Set(v8::Array::New(isolate));
+      return;
+    }
+
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    size_t count = abi::get_size(length);
+    v8::Local<v8::Array> result =
+        v8::Array::New(isolate, static_cast<int>(count));
+    for (size_t i = 0; i < count; i++) {
+      result
+          ->Set(context, static_cast<uint32_t>(i),
+                v8::Integer::NewFromUnsigned(isolate,
+                                             static_cast<uint32_t>(i)))
+          .FromMaybe(false);
+    }
+    info.GetReturnValue().Set(result);
+  }
+
   static void Enumerator(const v8::PropertyCallbackInfo<v8::Array> &info) {
     AbiHostObjectProxy *proxy =
         GetProxyFromThis(info.This(), info.GetIsolate());
@@ -764,6 +1148,40 @@ struct AbiHostObjectProxy {
   }
 
 private:
+  // Rethrows the error a host object callback reported into V8.
+  static void ThrowCallbackError(v8::Isolate *isolate, JsiRuntimeState *state,
+                                 jsi_error_code error) {
+    if (error == jsi_error_js) {
+      jsi_value jsErr = state->pendingJSError;
+      if (abi::is_pointer_value(jsErr)) {
+        isolate->ThrowException(toV8Value(isolate, &jsErr));
+      }
+      state->pendingJSError = abi::create_undefined_value();
+    } else {
+      v8::Local<v8::String> message =
+          v8::String::NewFromUtf8(isolate,
+                                  state->nativeExceptionMessage.c_str())
+              .ToLocalChecked();
+      isolate->ThrowException(v8::Exception::Error(message));
+      state->nativeExceptionMessage.clear();
+    }
+  }
+
+  static v8::Intercepted
+  ReturnResult(v8::Isolate *isolate, JsiRuntimeState *state,
+               jsi_value_or_error result,
+               const v8::PropertyCallbackInfo<v8::Value> &info) {
+    if (abi::is_error(result)) {
+      ThrowCallbackError(isolate, state, abi::get_error(result));
+      return v8::Intercepted::kYes;
+    }
+
+    jsi_value val = abi::get_value(result);
+    info.GetReturnValue().Set(toV8Value(isolate, &val));
+    abi::release_value(val);
+    return v8::Intercepted::kYes;
+  }
+
   template <typename T>
   static AbiHostObjectProxy *
   GetProxy(const v8::PropertyCallbackInfo<T> &info) {
@@ -793,6 +1211,9 @@ private:
 // JsiRuntimeState Implementation
 //==============================================================================
 
+// Defined with compileScript.
+void scheduleSourcePark(void *data) noexcept;
+
 JsiRuntimeState *JsiRuntimeState::create(const jsi_config_s *config) {
   // Legacy default behavior (config==nullptr): match what the ABI runtime
   // shipped earlier — --expose_gc, kExplicit microtasks, enable_gc_api=true.
@@ -887,6 +1308,16 @@ JsiRuntimeState *JsiRuntimeState::create(const jsi_config_s *config) {
   state->context.Reset(isolate, context);
   state->isolateData = v8rt::IsolateData::fromIsolate(isolate);
   state->enableMultiThread = !useDefaults && config->enable_multi_thread;
+  state->backgroundCodeCache = !useDefaults && config->background_code_cache;
+  state->warmCodeCache = !useDefaults && config->warm_code_cache;
+  state->warmCodeCacheDelayMs =
+      useDefaults ? 0 : config->warm_code_cache_delay_ms;
+  state->lazyScriptSource = !useDefaults && config->lazy_script_source;
+  if (state->lazyScriptSource)
+    state->reloadedSources =
+        std::make_shared<v8rt::ReloadedSources>(scheduleSourcePark, state);
+  state->compiledScripts.setMaxBytes(
+      useDefaults ? 0 : config->compiled_script_cache_size);
   state->ignore_unhandled_promises =
       !useDefaults && config->ignore_unhandled_promises;
 
@@ -916,12 +1347,24 @@ JsiRuntimeState *JsiRuntimeState::create(const jsi_config_s *config) {
     state->script_cache_data_delete_cb =
         mutableConfig->script_cache_data_delete_cb;
     state->script_cache_deleter_data = mutableConfig->script_cache_deleter_data;
+    state->script_cache_reject_cb = mutableConfig->script_cache_reject_cb;
     mutableConfig->script_cache_data = nullptr;
     mutableConfig->script_cache_load_cb = nullptr;
     mutableConfig->script_cache_store_cb = nullptr;
     mutableConfig->script_cache_data_delete_cb = nullptr;
     mutableConfig->script_cache_deleter_data = nullptr;
 
+    // take ownership of the script store the same way.
+    state->script_store_data = mutableConfig->script_store_data;
+    state->script_store_load_cb = mutableConfig->script_store_load_cb;
+    state->script_store_data_delete_cb =
+        mutableConfig->script_store_data_delete_cb;
+    state->script_store_deleter_data = mutableConfig->script_store_deleter_data;
+    mutableConfig->script_store_data = nullptr;
+    mutableConfig->script_store_load_cb = nullptr;
+    mutableConfig->script_store_data_delete_cb = nullptr;
+    mutableConfig->script_store_deleter_data = nullptr;
+
     // take ownership of the startup-snapshot blob from the config. The runtime
     // now keeps the bytes alive for the isolate's lifetime and fires the
     // deleter once in ~JsiRuntimeState (after isolate disposal). Clearing the
@@ -981,7 +1424,8 @@ v8::Local<v8::Function> JsiRuntimeState::getHostObjectConstructor() {
         AbiHostObjectProxy::Get, AbiHostObjectProxy::Set, nullptr, nullptr,
         AbiHostObjectProxy::Enumerator));
     instanceTemplate->SetHandler(v8::IndexedPropertyHandlerConfiguration(
-        AbiHostObjectProxy::GetIndexed, AbiHostObjectProxy::SetIndexed));
+        AbiHostObjectProxy::GetIndexed, AbiHostObjectProxy::SetIndexed,
+        nullptr, nullptr, AbiHostObjectProxy::IndexedEnumerator));
 
     instanceTemplate->SetInternalFieldCount(1);
 
@@ -1067,9 +1511,20 @@ struct HostFunctionContext {
   }
 };
 
+// Defined after AsyncPrepare.
+void abandonAsyncPrepares(JsiRuntimeState *state);
+
+// Defined after WarmCodeCacheTimer.
+void cancelWarmCodeCacheTimer(JsiRuntimeState *state);
+
 // Deferred definition — requires HostFunctionContext and AbiHostObjectProxy
 // to be complete types.
 JsiRuntimeState::~JsiRuntimeState() {
+  // Stop the parses of prepare_javascript_async calls still in flight while
+  // the isolate is alive, and let their callers free their contexts.
+  abandonAsyncPrepares(this);
+  cancelWarmCodeCacheTimer(this);
+
   // tear down the attached Node-API surface (if any) before disposing
   // V8 state. The destroy callback owns deleting the attached object.
   if (attached_owner_destroy) {
@@ -1080,6 +1535,12 @@ JsiRuntimeState::~JsiRuntimeState() {
     cb(attached);
   }
 
+  while (!teardown_hooks.empty()) {
+    auto [cb, data] = teardown_hooks.back();
+    teardown_hooks.pop_back();
+    cb(data);
+  }
+
   // Drop the unhandled-promise record (if any) before the isolate goes away;
   // its v8::Globals must release while the isolate is still live.
   last_unhandled_promise.reset();
@@ -1098,6 +1559,9 @@ JsiRuntimeState::~JsiRuntimeState() {
 
   abi::release_value(pendingJSError);
 
+  // Close scopes the consumer left open.
+  scopes.closeAll();
+
 #if defined(_WIN32) && defined(V8JSI_ENABLE_INSPECTOR)
   // Tear down the inspector before the context is reset — the Agent's
   // removeContext takes a v8::Local<v8::Context>.
@@ -1111,6 +1575,11 @@ JsiRuntimeState::~JsiRuntimeState() {
 
   hostObjectConstructor.Reset();
   hostFunctionKey.Reset();
+  warmScripts.clear();
+  propNameInternTable.clear();
+  externalMemoryTable.clear(isolate);
+  sourceHashCache.clear();
+  compiledScripts.clear();
   context.Reset();
 
   if (isolate) {
@@ -1124,6 +1593,9 @@ JsiRuntimeState::~JsiRuntimeState() {
   if (script_cache_data_delete_cb) {
     script_cache_data_delete_cb(script_cache_data, script_cache_deleter_data);
   }
+  if (script_store_data_delete_cb) {
+    script_store_data_delete_cb(script_store_data, script_store_deleter_data);
+  }
 
   // release the startup-snapshot blob only after isolate disposal — V8 keeps a
   // pointer to these bytes for the whole isolate lifetime.
@@ -1192,6 +1664,133 @@ void JsiRuntimeState::RemoveUnhandledPromise(v8::Local<v8::Promise> promise) {
   }
 }
 
+/// Arguments (and `this`) of one host function call, passed to the callee
+/// borrowed. Pointer-kind values are wrapped without a global handle: each
+/// wrapper holds the v8::Local from the callback's HandleScope and has a no-op
+/// invalidate. The wrappers live in an inline buffer (spilling to the heap past
+/// kInlineArgs) and are destroyed when the call returns, so a host function
+/// that keeps an argument must promote it with the matching clone_* call.
+class BorrowedHostCallArgs {
+ public:
+  static constexpr size_t kInlineArgs = 8;
+
+  explicit BorrowedHostCallArgs(
+      const v8::FunctionCallbackInfo<v8::Value> &info)
+      : size_(static_cast<size_t>(info.Length())) {
+    if (size_ > kInlineArgs) {
+      heapValues_ = std::make_unique<jsi_value[]>(size_ + 1);
+      heapSlots_ = std::make_unique<Slot[]>(size_ + 1);
+      values_ = heapValues_.get();
+      slots_ = heapSlots_.get();
+    }
+    v8::Isolate *isolate = info.GetIsolate();
+    values_[0] = borrow(isolate, info.This(), slots_[0]);
+    for (size_t i = 0; i < size_; ++i)
+      values_[i + 1] = borrow(isolate, info[static_cast<int>(i)], slots_[i + 1]);
+  }
+
+  ~BorrowedHostCallArgs() {
+    for (size_t i = 0; i <= size_; ++i)
+      destroy(values_[i]);
+  }
+
+  BorrowedHostCallArgs(const BorrowedHostCallArgs &) = delete;
+  BorrowedHostCallArgs &operator=(const BorrowedHostCallArgs &) = delete;
+
+  const jsi_value *thisArg() const { return &values_[0]; }
+  const jsi_value *data() const { return values_ + 1; }
+  size_t size() const { return size_; }
+
+ private:
+  // Storage for one borrowed wrapper; the active member is tracked by the
+  // kind of the matching jsi_value and destroyed in destroy().
+  union Slot {
+    Slot() {}
+    ~Slot() {}
+    ObjectHandle object;
+    StringHandle string;
+    SymbolHandle symbol;
+    BigIntHandle bigint;
+  };
+
+  static jsi_value borrow(v8::Isolate *isolate, v8::Local<v8::Value> val,
+                          Slot &slot) {
+    if (val->IsString())
+      return abi::create_string_value(new (&slot.string) StringHandle(
+          StringHandle::Borrowed{}, v8::Local<v8::String>::Cast(val)));
+    if (val->IsSymbol())
+      return abi::create_symbol_value(new (&slot.symbol) SymbolHandle(
+          SymbolHandle::Borrowed{}, v8::Local<v8::Symbol>::Cast(val)));
+    if (val->IsBigInt())
+      return abi::create_bigint_value(new (&slot.bigint) BigIntHandle(
+          BigIntHandle::Borrowed{}, v8::Local<v8::BigInt>::Cast(val)));
+    if (val->IsObject())
+      return abi::create_object_value(new (&slot.object) ObjectHandle(
+          ObjectHandle::Borrowed{}, v8::Local<v8::Object>::Cast(val)));
+    if (val->IsBoolean())
+      return abi::create_bool_value(val->BooleanValue(isolate));
+    if (val->IsNumber())
+      return abi::create_number_value(
+          val->NumberValue(isolate->GetCurrentContext()).FromJust());
+    if (val->IsNull())
+      return abi::create_null_value();
+    return abi::create_undefined_value();
+  }
+
+  static void destroy(jsi_value &val) {
+    switch (val.kind) {
+    case jsi_valuekind_string:
+      static_cast<StringHandle *>(val.data.pointer)->~StringHandle();
+      break;
+    case jsi_valuekind_symbol:
+      static_cast<SymbolHandle *>(val.data.pointer)->~SymbolHandle();
+      break;
+    case jsi_valuekind_bigint:
+      static_cast<BigIntHandle *>(val.data.pointer)->~BigIntHandle();
+      break;
+    case jsi_valuekind_object:
+      static_cast<ObjectHandle *>(val.data.pointer)->~ObjectHandle();
+      break;
+    default:
+      break;
+    }
+  }
+
+  size_t size_;
+  jsi_value inlineValues_[kInlineArgs + 1];
+  Slot inlineSlots_[kInlineArgs + 1];
+  std::unique_ptr<jsi_value[]> heapValues_;
+  std::unique_ptr<Slot[]> heapSlots_;
+  jsi_value *values_{inlineValues_};
+  Slot *slots_{inlineSlots_};
+};
+
+/// v8::Local argv for jsi_call / jsi_call_as_constructor, inline up to
+/// kInlineArgs so the common short calls do not touch the heap.
+class CallArgs {
+ public:
+  static constexpr size_t kInlineArgs = 8;
+
+  CallArgs(v8::Isolate *isolate, const jsi_value *args, size_t count) {
+    if (count > kInlineArgs) {
+      heap_ = std::make_unique<v8::Local<v8::Value>[]>(count);
+      data_ = heap_.get();
+    }
+    for (size_t i = 0; i < count; ++i)
+      data_[i] = toV8Value(isolate, &args[i]);
+  }
+
+  CallArgs(const CallArgs &) = delete;
+  CallArgs &operator=(const CallArgs &) = delete;
+
+  v8::Local<v8::Value> *data() { return data_; }
+
+ private:
+  v8::Local<v8::Value> inline_[kInlineArgs];
+  std::unique_ptr<v8::Local<v8::Value>[]> heap_;
+  v8::Local<v8::Value> *data_{inline_};
+};
+
 void JSI_CDECL HostFunctionCallbackTrampoline(
     const v8::FunctionCallbackInfo<v8::Value> &info) {
   v8::Isolate *isolate = info.GetIsolate();
@@ -1199,23 +1798,15 @@ void JSI_CDECL HostFunctionCallbackTrampoline(
 
   v8::Local<v8::External> data = v8::Local<v8::External>::Cast(info.Data());
   auto *ctx = static_cast<HostFunctionContext *>(data->Value());
+  auto *state = getState(ctx->runtime);
 
-  std::vector<jsi_value> args;
-  args.reserve(info.Length());
-  for (int i = 0; i < info.Length(); ++i)
-    args.push_back(createJsiValue(isolate, info[i]));
-
-  jsi_value thisVal = createJsiValue(isolate, info.This());
+  BorrowedHostCallArgs args(info);
 
   jsi_value_or_error result = ctx->hostFunction->vtable->call(
-      ctx->hostFunction, ctx->runtime, &thisVal, args.data(), args.size());
-
-  for (auto &arg : args)
-    abi::release_value(arg);
-  abi::release_value(thisVal);
+      ctx->hostFunction, ctx->runtime, args.thisArg(), args.data(),
+      args.size());
 
   if (abi::is_error(result)) {
-    auto *state = getState(ctx->runtime);
     jsi_error_code err = abi::get_error(result);
     if (err == jsi_error_js && abi::is_pointer_value(state->pendingJSError)) {
       isolate->ThrowException(toV8Value(isolate, &state->pendingJSError));
@@ -1327,7 +1918,7 @@ void JSI_CDECL jsi_set_js_error_value(jsi_runtime *rt,
   abi::release_value(state->pendingJSError);
   if (abi::is_pointer_value(*error_value)) {
     v8::Local<v8::Value> v8val = toV8Value(state->isolate, error_value);
-    state->pendingJSError = createJsiValue(state->isolate, v8val);
+    state->pendingJSError = createJsiValue(state, v8val);
   } else {
     state->pendingJSError = *error_value;
   }
@@ -1349,35 +1940,35 @@ jsi_propnameid JSI_CDECL jsi_clone_propnameid(jsi_runtime *rt,
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::Value> v8val = toPropNameIdHandle(name)->get(state->isolate);
-  return {new PropNameIdHandle(state->isolate, v8val)};
+  return {newHandle<PropNameIdHandle>(state, v8val)};
 }
 
 jsi_string JSI_CDECL jsi_clone_string(jsi_runtime *rt, jsi_string str) {
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::String> v8str = toStringHandle(str)->get(state->isolate);
-  return {new StringHandle(state->isolate, v8str)};
+  return {newHandle<StringHandle>(state, v8str)};
 }
 
 jsi_symbol JSI_CDECL jsi_clone_symbol(jsi_runtime *rt, jsi_symbol sym) {
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::Symbol> v8sym = toSymbolHandle(sym)->get(state->isolate);
-  return {new SymbolHandle(state->isolate, v8sym)};
+  return {newHandle<SymbolHandle>(state, v8sym)};
 }
 
 jsi_object JSI_CDECL jsi_clone_object(jsi_runtime *rt, jsi_object obj) {
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::Object> v8obj = toObjectHandle(obj)->get(state->isolate);
-  return {new ObjectHandle(state->isolate, v8obj)};
+  return {newHandle<ObjectHandle>(state, v8obj)};
 }
 
 jsi_bigint JSI_CDECL jsi_clone_bigint(jsi_runtime *rt, jsi_bigint bigint) {
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::BigInt> v8bi = toBigIntHandle(bigint)->get(state->isolate);
-  return {new BigIntHandle(state->isolate, v8bi)};
+  return {newHandle<BigIntHandle>(state, v8bi)};
 }
 
 //------------------------------------------------------------------------------
@@ -1397,15 +1988,20 @@ bool JSI_CDECL jsi_is_inspectable(jsi_runtime * /*rt*/) { return false; }
 // Handle Scopes
 //------------------------------------------------------------------------------
 
-jsi_error_code JSI_CDECL jsi_push_scope(jsi_runtime * /*rt*/,
-                                            void **scope) {
+jsi_error_code JSI_CDECL jsi_push_scope(jsi_runtime *rt, void **scope) {
+  auto *state = getState(rt);
+  ScopeFrame *frame = state->scopes.push();
   if (scope)
-    *scope = reinterpret_cast<void *>(1);
+    *scope = frame;
   return jsi_no_error;
 }
 
-jsi_error_code JSI_CDECL jsi_pop_scope(jsi_runtime * /*rt*/,
-                                           void * /*scope*/) {
+jsi_error_code JSI_CDECL jsi_pop_scope(jsi_runtime *rt, void *scope) {
+  auto *state = getState(rt);
+  if (!state->scopes.pop(scope)) {
+    state->setNativeError("pop_scope called out of order");
+    return jsi_error_native;
+  }
   return jsi_no_error;
 }
 
@@ -1413,6 +2009,38 @@ jsi_error_code JSI_CDECL jsi_pop_scope(jsi_runtime * /*rt*/,
 // Script Evaluation
 //------------------------------------------------------------------------------
 
+// Releases the jsi_buffer behind a source string.
+void releaseSourceBuffer(void *data) {
+  auto *buffer = static_cast<jsi_buffer *>(data);
+  if (buffer->vtable && buffer->vtable->release)
+    buffer->vtable->release(buffer);
+}
+
+// Whether the engine may keep reading buf after the call that hands it over.
+// Without a release callback nothing tells when the consumer frees the bytes,
+// so they may go away as soon as the call returns.
+bool canBorrowSource(const jsi_buffer *buf) {
+  return buf->vtable && buf->vtable->release;
+}
+
+// Creates the V8 string for a script source and takes ownership of buf (see
+// v8rt::newExternalSourceString): ASCII sources are wrapped without a copy and
+// non-ASCII sources are transcoded off-heap once. A buffer that cannot be
+// borrowed is copied onto the V8 heap instead.
+v8::MaybeLocal<v8::String> newSourceString(
+    v8::Isolate *isolate,
+    jsi_buffer *buf,
+    std::optional<bool> is_ascii = std::nullopt) {
+  if (!canBorrowSource(buf))
+    return v8rt::newStringFromUtf8(
+        isolate, reinterpret_cast<const char *>(buf->data), buf->size);
+  return v8rt::newExternalSourceString(
+      isolate, reinterpret_cast<const char *>(buf->data), buf->size,
+      releaseSourceBuffer,
+      buf,
+      is_ascii);
+}
+
 jsi_value_or_error JSI_CDECL jsi_evaluate_javascript_source(
     jsi_runtime *rt, jsi_buffer *buf, const char *source_url,
     size_t source_url_len) {
@@ -1421,14 +2049,10 @@ jsi_value_or_error JSI_CDECL jsi_evaluate_javascript_source(
   v8::Isolate *isolate = state->isolate;
   TryCatch try_catch(state);
 
+  // The source string takes over buf: it stays alive while an ASCII source is
+  // wrapped in place and is released right away otherwise.
   v8::Local<v8::String> sourceStr;
-  if (!v8::String::NewFromUtf8(isolate,
-                                reinterpret_cast<const char *>(buf->data),
-                                v8::NewStringType::kNormal,
-                                static_cast<int>(buf->size))
-           .ToLocal(&sourceStr)) {
-    if (buf->vtable && buf->vtable->release)
-      buf->vtable->release(buf);
+  if (!newSourceString(isolate, buf).ToLocal(&sourceStr)) {
     state->setNativeError("Failed to create source string");
     return abi::create_value_or_error(jsi_error_native);
   }
@@ -1437,15 +2061,10 @@ jsi_value_or_error JSI_CDECL jsi_evaluate_javascript_source(
   if (!v8::String::NewFromUtf8(isolate, source_url, v8::NewStringType::kNormal,
                                 static_cast<int>(source_url_len))
            .ToLocal(&urlV8Str)) {
-    if (buf->vtable && buf->vtable->release)
-      buf->vtable->release(buf);
     state->setNativeError("Failed to create source URL string");
     return abi::create_value_or_error(jsi_error_native);
   }
 
-  if (buf->vtable && buf->vtable->release)
-    buf->vtable->release(buf);
-
   v8::ScriptOrigin origin(urlV8Str);
 
   v8::Local<v8::Script> compiled;
@@ -1457,136 +2076,753 @@ jsi_value_or_error JSI_CDECL jsi_evaluate_javascript_source(
   if (!compiled->Run(state->getContextLocal()).ToLocal(&resultValue))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(isolate, resultValue));
+  return abi::create_value_or_error(createJsiValue(state, resultValue));
 }
 
-jsi_prepared_javascript_or_error JSI_CDECL jsi_prepare_javascript(
-    jsi_runtime *rt, jsi_buffer *buf, const char *source_url,
-    size_t source_url_len) {
-  auto *state = getState(rt);
-  V8Scope scope(state);
-  v8::Isolate *isolate = state->isolate;
-  TryCatch try_catch(state);
+// Cache key of a script source, computed before newSourceString may release
+// its buffer.
+struct SourceKey {
+  uint64_t hash{0};
+  // Known once the source has been scanned (hashSource or isAscii).
+  std::optional<bool> is_ascii;
+  // The hash was computed rather than found in sourceHashCache.
+  bool hashed{false};
+  // Size of the source, charged against the compiled script cache.
+  size_t size{0};
+};
 
-  // compute MurmurHash3 over the source bytes for the cache key. Must
-  // happen before buf->release() since the buffer pointer becomes invalid.
-  uint64_t source_hash = 0;
-  if (state->script_cache_load_cb || state->script_cache_store_cb) {
-    murmurhash(buf->data, buf->size, source_hash);
+// source_version is the key if non-zero (a script store version); otherwise
+// the key is a hash of the source. The hash pass also tells whether the
+// source is ASCII; a buffer still wrapped in place by an earlier call is not
+// hashed again. The source is hashed only if the runtime has a script cache or
+// a compiled script cache to look it up in.
+SourceKey keySource(JsiRuntimeState *state, const jsi_buffer *buf,
+                    uint64_t source_version) {
+  SourceKey key;
+  key.hash = source_version;
+  key.size = buf->size;
+  if (source_version == 0 &&
+      (state->script_cache_load_cb || state->script_cache_store_cb ||
+       state->compiledScripts.enabled())) {
+    if (state->sourceHashCache.lookup(buf->data, buf->size, key.hash)) {
+      key.is_ascii = true;
+    } else {
+      key.is_ascii = v8rt::hashSource(buf->data, buf->size, key.hash,
+                                      v8rt::V8PlatformHolder::platform());
+      key.hashed = true;
+    }
+  }
+  return key;
+}
+
+// cache_tag = "perf" matches the legacy V8Runtime convention.
+// runtime_name = "V8" likewise — preserves cache keys for deployed
+// consumers whose stores already contain entries under that name.
+constexpr const char *kCodeCacheTag = "perf";
+constexpr const char *kCodeCacheRuntimeName = "V8";
+
+// Bytes loaded from the consumer's script cache. The consumer's deleter runs
+// on release() or destruction.
+struct LoadedCodeCache {
+  const uint8_t *data{nullptr};
+  size_t size{0};
+  jsi_data_delete_cb delete_cb{nullptr};
+  void *deleter_data{nullptr};
+
+  LoadedCodeCache() = default;
+  LoadedCodeCache(const LoadedCodeCache &) = delete;
+  LoadedCodeCache &operator=(const LoadedCodeCache &) = delete;
+  ~LoadedCodeCache() { release(); }
+
+  bool empty() const noexcept { return !data || size == 0; }
+
+  void release() noexcept {
+    if (delete_cb)
+      delete_cb(const_cast<uint8_t *>(data), deleter_data);
+    data = nullptr;
+    size = 0;
+    delete_cb = nullptr;
   }
+};
 
-  v8::Local<v8::String> sourceStr;
-  if (!v8::String::NewFromUtf8(isolate,
-                                reinterpret_cast<const char *>(buf->data),
-                                v8::NewStringType::kNormal,
-                                static_cast<int>(buf->size))
-           .ToLocal(&sourceStr)) {
-    if (buf->vtable && buf->vtable->release)
-      buf->vtable->release(buf);
+void loadCodeCache(JsiRuntimeState *state, const char *source_url,
+                   uint64_t source_hash, LoadedCodeCache &cache) {
+  if (!state->script_cache_load_cb)
+    return;
+  state->script_cache_load_cb(
+      state->script_cache_data,
+      source_url,
+      source_hash,
+      kCodeCacheRuntimeName,
+      v8::ScriptCompiler::CachedDataVersionTag(),
+      kCodeCacheTag,
+      &cache.data,
+      &cache.size,
+      &cache.delete_cb,
+      &cache.deleter_data);
+}
+
+// Produces the code cache for a script and hands it to the consumer, unless
+// it is smaller than min_size. Returns its size, or 0 if it was not stored.
+size_t storeCodeCache(JsiRuntimeState *state, const char *source_url,
+                      uint64_t source_hash,
+                      v8::Local<v8::UnboundScript> unbound,
+                      size_t min_size = 0) {
+  if (!state->script_cache_store_cb)
+    return 0;
+  v8::ScriptCompiler::CachedData *codeCache =
+      v8::ScriptCompiler::CreateCodeCache(unbound);
+  if (!codeCache)
+    return 0;
+  const size_t size = static_cast<size_t>(codeCache->length);
+  if (size < min_size) {
+    delete codeCache;
+    return 0;
+  }
+  // The consumer reads codeCache->data and then calls our delete_cb, which
+  // deletes the V8 CachedData object (and its owned buffer) in the DLL's
+  // CRT — the same CRT that allocated it.
+  auto delete_cb = [](void * /*data*/, void *deleter_data) {
+    delete static_cast<v8::ScriptCompiler::CachedData *>(deleter_data);
+  };
+  state->script_cache_store_cb(
+      state->script_cache_data,
+      source_url,
+      source_hash,
+      kCodeCacheRuntimeName,
+      v8::ScriptCompiler::CachedDataVersionTag(),
+      kCodeCacheTag,
+      codeCache->data,
+      size,
+      delete_cb,
+      codeCache);
+  return size;
+}
+
+// A warm code cache is stored only if it is at least 1/kWarmCodeCacheMinGrowth
+// larger than the one loaded or stored for the script, so that each start of
+// an app whose warm cache is already stored does not write it again.
+constexpr size_t kWarmCodeCacheMinGrowth = 8;
+
+// Stores warm code caches warmCodeCacheDelayMs after the first script is
+// prepared. The delay runs on a platform worker thread, which then posts the
+// store to the JS thread. The runtime cancels the timer when startup
+// completes or the runtime is destroyed, whichever comes first.
+class WarmCodeCacheTimer final
+    : public std::enable_shared_from_this<WarmCodeCacheTimer> {
+ public:
+  WarmCodeCacheTimer(JsiRuntimeState *state, v8rt::TaskRunner *taskRunner)
+      : state_(state), taskRunner_(taskRunner) {}
+
+  void start(v8::Platform *platform, uint32_t delay_ms) {
+    platform->PostDelayedTaskOnWorkerThread(
+        v8::TaskPriority::kBestEffort,
+        std::make_unique<DelayTask>(weak_from_this()),
+        delay_ms / 1000.0);
+  }
+
+  // Runs on the JS thread.
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = nullptr;
+    taskRunner_ = nullptr;
+  }
+
+ private:
+  class DelayTask final : public v8::Task {
+   public:
+    explicit DelayTask(std::weak_ptr<WarmCodeCacheTimer> timer)
+        : timer_(std::move(timer)) {}
+    void Run() override {
+      if (std::shared_ptr<WarmCodeCacheTimer> timer = timer_.lock())
+        timer->fire();
+    }
+
+   private:
+    std::weak_ptr<WarmCodeCacheTimer> timer_;
+  };
+
+  class StoreTask final : public v8rt::TaskRunner::Task {
+   public:
+    explicit StoreTask(std::weak_ptr<WarmCodeCacheTimer> timer)
+        : timer_(std::move(timer)) {}
+    void run() override;
+
+   private:
+    std::weak_ptr<WarmCodeCacheTimer> timer_;
+  };
+
+  // Runs on a worker thread. The lock keeps the runtime from releasing the
+  // task runner while a task is posted to it.
+  void fire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (taskRunner_)
+      taskRunner_->postTask(std::make_unique<StoreTask>(weak_from_this()));
+  }
+
+  std::mutex mutex_;
+  JsiRuntimeState *state_;
+  v8rt::TaskRunner *taskRunner_;
+};
+
+void cancelWarmCodeCacheTimer(JsiRuntimeState *state) {
+  if (state->warmCodeCacheTimer) {
+    state->warmCodeCacheTimer->cancel();
+    state->warmCodeCacheTimer.reset();
+  }
+}
+
+// Remembers a script prepared before startup completed so that its warm code
+// cache is stored when it does. cache_size is the size of the code cache
+// loaded or stored for it.
+void trackWarmScript(JsiRuntimeState *state, const char *source_url,
+                     uint64_t source_hash,
+                     v8::Local<v8::UnboundScript> unbound, size_t cache_size) {
+  if (!state->warmCodeCache || state->startupComplete ||
+      !state->script_cache_store_cb)
+    return;
+  for (const JsiRuntimeState::WarmScript &warm : state->warmScripts)
+    if (warm.hash == source_hash && warm.url == source_url)
+      return;
+  state->warmScripts.push_back(JsiRuntimeState::WarmScript{
+      source_url, source_hash, cache_size,
+      v8::Global<v8::UnboundScript>(state->isolate, unbound)});
+
+  v8::Platform *platform = v8rt::V8PlatformHolder::platform();
+  std::shared_ptr<v8rt::TaskRunner> taskRunner =
+      state->isolateData->taskRunner();
+  if (state->warmCodeCacheDelayMs == 0 || state->warmCodeCacheTimer ||
+      !platform || !taskRunner)
+    return;
+  state->warmCodeCacheTimer =
+      std::make_shared<WarmCodeCacheTimer>(state, taskRunner.get());
+  state->warmCodeCacheTimer->start(platform, state->warmCodeCacheDelayMs);
+}
+
+// Ends startup: stores the warm code cache of each tracked script that has
+// grown enough since its cache was loaded or stored. Callers hold the
+// V8Scope.
+void storeWarmCodeCaches(JsiRuntimeState *state) {
+  if (state->startupComplete)
+    return;
+  state->startupComplete = true;
+  cancelWarmCodeCacheTimer(state);
+  for (JsiRuntimeState::WarmScript &warm : state->warmScripts) {
+    if (storeCodeCache(state, warm.url.c_str(), warm.hash,
+                       warm.script.Get(state->isolate),
+                       warm.cacheSize +
+                           warm.cacheSize / kWarmCodeCacheMinGrowth) != 0)
+      ++state->codeCacheStats.warm_stores;
+  }
+  state->warmScripts.clear();
+}
+
+void WarmCodeCacheTimer::StoreTask::run() {
+  std::shared_ptr<WarmCodeCacheTimer> timer = timer_.lock();
+  // Only the JS thread writes state_.
+  JsiRuntimeState *state = timer ? timer->state_ : nullptr;
+  if (!state)
+    return;
+  // The timer has fired, so there is nothing to cancel.
+  state->warmCodeCacheTimer.reset();
+  V8Scope scope(state);
+  storeWarmCodeCaches(state);
+}
+
+// Counts a code cache lookup for a compiled script. cache is what the load
+// callback returned; if V8 rejected it, tells the consumer why. Call before
+// cache is released.
+void recordCodeCacheLookup(JsiRuntimeState *state, const char *source_url,
+                           uint64_t source_hash, const uint8_t *cache,
+                           size_t cache_size, bool rejected) {
+  v8_jsi_code_cache_stats &stats = state->codeCacheStats;
+  if (!cache || cache_size == 0) {
+    if (state->script_cache_load_cb)
+      ++stats.misses;
+    return;
+  }
+  if (!rejected) {
+    ++stats.hits;
+    return;
+  }
+  ++stats.rejections;
+  if (!state->script_cache_reject_cb)
+    return;
+  // The header check cannot see the source, so a cache that passes it was
+  // rejected for being made from different source text.
+  v8::ScriptCompiler::CachedData data(cache, static_cast<int>(cache_size));
+  v8::ScriptCompiler::CachedData::CompatibilityCheckResult reason =
+      data.CompatibilityCheck(state->isolate);
+  if (reason == v8::ScriptCompiler::CachedData::kSuccess)
+    reason = v8::ScriptCompiler::CachedData::kSourceMismatch;
+  state->script_cache_reject_cb(
+      state->script_cache_data,
+      source_url,
+      source_hash,
+      kCodeCacheRuntimeName,
+      v8::ScriptCompiler::CachedDataVersionTag(),
+      kCodeCacheTag,
+      static_cast<int>(reason));
+}
+
+// Creates the source string (taking over buf, see newSourceString) and the
+// URL string of a script. Sets the native error and returns false on failure.
+// With a loader and a buffer that can be borrowed, an ASCII source becomes a
+// v8rt::ReloadableSource, set in *reloadable for the caller to park once the
+// script is compiled.
+bool newScriptStrings(JsiRuntimeState *state, jsi_buffer *buf,
+                      const SourceKey &key, const char *source_url,
+                      size_t source_url_len,
+                      v8::Local<v8::String> &sourceStr,
+                      v8::Local<v8::String> &urlStr,
+                      std::unique_ptr<v8rt::SourceLoader> loader = nullptr,
+                      v8rt::ReloadableSource **reloadable = nullptr) {
+  v8::Isolate *isolate = state->isolate;
+  const uint8_t *source_data = buf->data;
+  const size_t source_size = buf->size;
+  v8::MaybeLocal<v8::String> source =
+      loader && canBorrowSource(buf)
+          ? v8rt::newReloadableSourceString(
+                isolate, reinterpret_cast<const char *>(source_data),
+                source_size, releaseSourceBuffer, buf, std::move(loader),
+                reloadable, state->reloadedSources.get(), key.is_ascii)
+          : newSourceString(isolate, buf, key.is_ascii);
+  if (!source.ToLocal(&sourceStr)) {
     state->setNativeError("Failed to create source string");
-    return abi::create_prepared_javascript_or_error(jsi_error_native);
+    return false;
   }
+  if (key.hashed)
+    state->sourceHashCache.remember(isolate, source_data, source_size,
+                                    key.hash, sourceStr);
 
-  v8::Local<v8::String> urlV8Str;
   if (!v8::String::NewFromUtf8(isolate, source_url, v8::NewStringType::kNormal,
                                 static_cast<int>(source_url_len))
-           .ToLocal(&urlV8Str)) {
-    if (buf->vtable && buf->vtable->release)
-      buf->vtable->release(buf);
+           .ToLocal(&urlStr)) {
     state->setNativeError("Failed to create source URL string");
-    return abi::create_prepared_javascript_or_error(jsi_error_native);
+    return false;
   }
+  return true;
+}
 
-  if (buf->vtable && buf->vtable->release)
-    buf->vtable->release(buf);
+// Starts deserializing cache on a worker thread if the runtime is configured
+// to (v8_jsi_config_enable_background_code_cache). on_done is posted to the
+// runtime's task runner when it is done; it may be null for a caller that
+// waits in CodeCacheConsumeJob::finish.
+std::unique_ptr<v8rt::CodeCacheConsumeJob> startCodeCacheConsume(
+    JsiRuntimeState *state, const LoadedCodeCache &cache,
+    std::unique_ptr<v8rt::TaskRunner::Task> on_done = nullptr) {
+  if (!state->backgroundCodeCache || cache.empty())
+    return nullptr;
+  return v8rt::CodeCacheConsumeJob::start(
+      state->isolate, v8rt::V8PlatformHolder::platform(),
+      state->isolateData->taskRunner(), cache.data, cache.size,
+      std::move(on_done));
+}
+
+// Parks the sources in JsiRuntimeState::reloadedSources once the JS thread is
+// idle. Holds the set but not the runtime, like AsyncPrepareTask; a set still
+// alive means the runtime is too.
+class SourceParkTask final : public v8rt::TaskRunner::Task {
+ public:
+  SourceParkTask(JsiRuntimeState *state,
+                 std::weak_ptr<v8rt::ReloadedSources> sources)
+      : state_(state), sources_(std::move(sources)) {}
+
+  void run() override {
+    if (std::shared_ptr<v8rt::ReloadedSources> sources = sources_.lock()) {
+      // Keeps another thread of a multi-threaded runtime out of V8 while the
+      // bytes go away.
+      V8Scope scope(state_);
+      sources->parkAll();
+    }
+  }
+
+ private:
+  JsiRuntimeState *state_;
+  std::weak_ptr<v8rt::ReloadedSources> sources_;
+};
+
+// v8rt::ReloadedSources::ScheduleCallback. Runs on the thread V8 read the
+// source on. Without a task runner the next compile parks the sources.
+void scheduleSourcePark(void *data) noexcept {
+  auto *state = static_cast<JsiRuntimeState *>(data);
+  if (std::shared_ptr<v8rt::TaskRunner> taskRunner =
+          state->isolateData->taskRunner())
+    taskRunner->postTask(
+        std::make_unique<SourceParkTask>(state, state->reloadedSources));
+}
+
+// Parks the source compileScript just compiled, if reloadable, and the
+// sources V8 read again since they were last parked.
+void parkSources(JsiRuntimeState *state, v8rt::ReloadableSource *reloadable) {
+  if (reloadable)
+    reloadable->park();
+  if (state->reloadedSources)
+    state->reloadedSources->parkAll();
+}
+
+// Compiles buf on the calling thread, consuming cache if it holds an entry
+// and storing a new one if it does not or V8 rejects it. consume, if not null, is already
+// deserializing cache on a worker thread. With a loader, the source is
+// dropped once compiled and loaded again when V8 reads it. Takes over buf.
+// Callers hold the V8Scope and TryCatch.
+jsi_prepared_javascript_or_error compileScript(
+    JsiRuntimeState *state, jsi_buffer *buf, const SourceKey &key,
+    LoadedCodeCache &cache, const char *source_url, size_t source_url_len,
+    std::unique_ptr<v8rt::CodeCacheConsumeJob> consume = nullptr,
+    std::unique_ptr<v8rt::SourceLoader> loader = nullptr) {
+  v8::Local<v8::String> sourceStr;
+  v8::Local<v8::String> urlV8Str;
+  v8rt::ReloadableSource *reloadable = nullptr;
+  if (!newScriptStrings(state, buf, key, source_url, source_url_len,
+                        sourceStr, urlV8Str, std::move(loader), &reloadable))
+    return abi::create_prepared_javascript_or_error(jsi_error_native);
 
   v8::ScriptOrigin origin(urlV8Str);
 
-  // cache_tag = "perf" matches the legacy V8Runtime convention.
-  // runtime_name = "V8" likewise — preserves cache keys for deployed
-  // consumers whose stores already contain entries under that name.
-  static constexpr const char *kCacheTag = "perf";
-  static constexpr const char *kRuntimeName = "V8";
-  const uint64_t runtime_version = v8::ScriptCompiler::CachedDataVersionTag();
-
-  // try cache load.
-  v8::ScriptCompiler::CompileOptions options =
-      v8::ScriptCompiler::CompileOptions::kNoCompileOptions;
-  v8::ScriptCompiler::CachedData *cached_data = nullptr;
-  const uint8_t *cache_buffer = nullptr;
-  size_t cache_buffer_size = 0;
-  jsi_data_delete_cb cache_buffer_delete_cb = nullptr;
-  void *cache_buffer_deleter_data = nullptr;
-
-  if (state->script_cache_load_cb) {
-    state->script_cache_load_cb(
-        state->script_cache_data,
-        source_url,
-        source_hash,
-        kRuntimeName,
-        runtime_version,
-        kCacheTag,
-        &cache_buffer,
-        &cache_buffer_size,
-        &cache_buffer_delete_cb,
-        &cache_buffer_deleter_data);
-    if (cache_buffer && cache_buffer_size > 0) {
-      // BufferNotOwned: V8 does not free `cache_buffer`; we own it and
-      // release via cache_buffer_delete_cb after Compile returns.
+  v8::Local<v8::Script> compiled;
+  bool compile_ok;
+  bool rejected = false;
+  if (consume) {
+    compile_ok = consume->finish(state->getContextLocal(), sourceStr, origin,
+                                 &rejected)
+                     .ToLocal(&compiled);
+    consume.reset();
+  } else {
+    v8::ScriptCompiler::CompileOptions options =
+        v8::ScriptCompiler::CompileOptions::kNoCompileOptions;
+    v8::ScriptCompiler::CachedData *cached_data = nullptr;
+    if (!cache.empty()) {
+      // BufferNotOwned: V8 does not free the cache bytes; cache releases them
+      // after Compile returns.
       cached_data = new v8::ScriptCompiler::CachedData(
-          cache_buffer, static_cast<int>(cache_buffer_size));
+          cache.data, static_cast<int>(cache.size));
       options = v8::ScriptCompiler::CompileOptions::kConsumeCodeCache;
     }
+
+    v8::ScriptCompiler::Source script_source(sourceStr, origin, cached_data);
+    compile_ok =
+        v8::ScriptCompiler::Compile(state->getContextLocal(), &script_source,
+                                    options)
+            .ToLocal(&compiled);
+    rejected = cached_data && script_source.GetCachedData()->rejected;
   }
 
-  v8::ScriptCompiler::Source script_source(sourceStr, origin, cached_data);
+  // Compile is synchronous, so the consumer's bytes are no longer needed.
+  const bool cache_hit = !cache.empty() && !rejected;
+  size_t cache_size = cache_hit ? cache.size : 0;
+  if (compile_ok)
+    recordCodeCacheLookup(state, source_url, key.hash, cache.data, cache.size,
+                          rejected);
+  cache.release();
 
-  v8::Local<v8::Script> compiled;
-  bool compile_ok =
-      v8::ScriptCompiler::Compile(state->getContextLocal(), &script_source,
-                                  options)
-          .ToLocal(&compiled);
+  if (!compile_ok) {
+    parkSources(state, reloadable);
+    return abi::create_prepared_javascript_or_error(jsi_error_js);
+  }
+
+  v8::Local<v8::UnboundScript> unbound = compiled->GetUnboundScript();
+
+  // cache miss or rejected cache → produce code cache and hand it to the
+  // consumer, replacing a rejected entry.
+  if (!cache_hit)
+    cache_size = storeCodeCache(state, source_url, key.hash, unbound);
+  trackWarmScript(state, source_url, key.hash, unbound, cache_size);
+  state->compiledScripts.insert(state->isolate,
+                                std::string_view(source_url, source_url_len),
+                                key.hash, key.size, unbound);
+  parkSources(state, reloadable);
+
+  return abi::create_prepared_javascript_or_error(
+      new PreparedScriptImpl(state->isolate, unbound));
+}
 
-  // Release the consumer's cache buffer (if any) now that V8 is done with it.
-  // Compile is synchronous, so the bytes are no longer needed past this point.
-  if (cache_buffer_delete_cb) {
-    cache_buffer_delete_cb(const_cast<uint8_t *>(cache_buffer),
-                            cache_buffer_deleter_data);
+// Loads a script source dropped by v8rt::ReloadableSource::park from the
+// script store again (v8_jsi_config_enable_lazy_script_source). Holds the
+// store's data but not the runtime: the string may outlive the JS thread's
+// last call, and the store's deleter runs only after the isolate is disposed.
+class StoreSourceLoader final : public v8rt::SourceLoader {
+ public:
+  StoreSourceLoader(JsiRuntimeState *state, std::string source_url,
+                    uint64_t version)
+      : store_data_(state->script_store_data),
+        load_cb_(state->script_store_load_cb),
+        source_url_(std::move(source_url)), version_(version) {}
+
+  ~StoreSourceLoader() override { unload(); }
+
+  const char *load(size_t length) noexcept override {
+    uint64_t version = 0;
+    buf_ = load_cb_(store_data_, source_url_.c_str(), &version);
+    if (buf_ && (version != version_ || buf_->size != length))
+      unload();
+    return buf_ ? reinterpret_cast<const char *>(buf_->data) : nullptr;
   }
 
-  if (!compile_ok)
-    return abi::create_prepared_javascript_or_error(jsi_error_js);
+  void unload() noexcept override {
+    if (buf_)
+      releaseSourceBuffer(buf_);
+    buf_ = nullptr;
+  }
 
-  v8::Local<v8::UnboundScript> unbound = compiled->GetUnboundScript();
+ private:
+  void *store_data_;
+  v8_jsi_script_store_load_cb load_cb_;
+  std::string source_url_;
+  uint64_t version_;
+  jsi_buffer *buf_{nullptr};
+};
+
+// Compiles buf, consulting the script cache. source_version is the cache key
+// if non-zero (a script store version); otherwise the key is a hash of the
+// source. loader, if not null, loads the source again after compileScript
+// drops it. Takes over buf. Callers hold the V8Scope and TryCatch.
+jsi_prepared_javascript_or_error prepareScript(
+    JsiRuntimeState *state, jsi_buffer *buf, const char *source_url,
+    size_t source_url_len, uint64_t source_version,
+    std::unique_ptr<v8rt::SourceLoader> loader = nullptr) {
+  SourceKey key = keySource(state, buf, source_version);
+  // A script compiled earlier from the same source is reused as is; no code
+  // cache is loaded for it.
+  v8::Local<v8::UnboundScript> unbound;
+  if (state->compiledScripts.lookup(
+          state->isolate, std::string_view(source_url, source_url_len),
+          key.hash, unbound)) {
+    if (buf->vtable && buf->vtable->release)
+      buf->vtable->release(buf);
+    return abi::create_prepared_javascript_or_error(
+        new PreparedScriptImpl(state->isolate, unbound));
+  }
+  LoadedCodeCache cache;
+  loadCodeCache(state, source_url, key.hash, cache);
+  // Deserialization overlaps with creating the source string.
+  std::unique_ptr<v8rt::CodeCacheConsumeJob> consume =
+      startCodeCacheConsume(state, cache);
+  return compileScript(state, buf, key, cache, source_url, source_url_len,
+                       std::move(consume), std::move(loader));
+}
+
+jsi_prepared_javascript_or_error JSI_CDECL jsi_prepare_javascript(
+    jsi_runtime *rt, jsi_buffer *buf, const char *source_url,
+    size_t source_url_len) {
+  auto *state = getState(rt);
+  V8Scope scope(state);
+  TryCatch try_catch(state);
+  return prepareScript(state, buf, source_url, source_url_len,
+                       /*source_version:*/ 0);
+}
+
+jsi_prepared_javascript_or_error JSI_CDECL jsi_prepare_javascript_from_store(
+    jsi_runtime *rt, const char *source_url, size_t source_url_len) {
+  auto *state = getState(rt);
+  V8Scope scope(state);
+  TryCatch try_catch(state);
+
+  if (!state->script_store_load_cb) {
+    state->setNativeError("The runtime has no script store");
+    return abi::create_prepared_javascript_or_error(jsi_error_native);
+  }
+  uint64_t version = 0;
+  jsi_buffer *buf = state->script_store_load_cb(
+      state->script_store_data, source_url, &version);
+  if (!buf) {
+    state->setNativeError(std::string("The script store has no script for ") +
+                          std::string(source_url, source_url_len));
+    return abi::create_prepared_javascript_or_error(jsi_error_native);
+  }
+  // Only a version tells that the bytes loaded again are the same.
+  std::unique_ptr<v8rt::SourceLoader> loader;
+  if (state->lazyScriptSource && version != 0)
+    loader = std::make_unique<StoreSourceLoader>(
+        state, std::string(source_url, source_url_len), version);
+  return prepareScript(state, buf, source_url, source_url_len, version,
+                       std::move(loader));
+}
+
+// A prepare_javascript_async call in flight, owned by
+// JsiRuntimeState::asyncPrepares until its completion task runs on the JS
+// thread or the runtime is destroyed. Completion tasks hold weak references,
+// so a task runner that drops a task without running it leaves the prepare to
+// the runtime's destructor.
+//
+// Without a code cache entry, a source of at least kMinStreamedScriptSize is
+// parsed on a worker thread (v8rt::ScriptStreamingJob), which posts the
+// completion task; the JS thread then only finalizes the script. A code cache
+// entry is likewise deserialized on a worker (v8rt::CodeCacheConsumeJob) if
+// the runtime enables background_code_cache. Otherwise the completion task
+// compiles the script itself, so the callback still runs from the task
+// runner. A script found in the compiled script cache is not compiled at all.
+struct AsyncPrepare {
+  JsiRuntimeState *state;
+  jsi_buffer *buf;
+  std::string source_url;
+  SourceKey key;
+  LoadedCodeCache cache;
+  std::unique_ptr<v8rt::CodeCacheConsumeJob> consume;
+  std::unique_ptr<v8rt::ScriptStreamingJob> job;
+  // Set if the compiled script cache already holds the script.
+  v8::Global<v8::UnboundScript> compiled;
+  void *ctx;
+  jsi_prepare_javascript_cb cb;
+  std::list<std::shared_ptr<AsyncPrepare>>::iterator listIter;
+
+  AsyncPrepare(JsiRuntimeState *state, jsi_buffer *buf, const char *source_url,
+               size_t source_url_len, void *ctx, jsi_prepare_javascript_cb cb)
+      : state(state), buf(buf), source_url(source_url, source_url_len),
+        ctx(ctx), cb(cb) {}
+
+  ~AsyncPrepare() {
+    // The jobs read buf and cache until they are destroyed.
+    job.reset();
+    consume.reset();
+    if (buf && buf->vtable && buf->vtable->release)
+      buf->vtable->release(buf);
+  }
+
+  // Runs on the JS thread. Finishes the script, unlists it and invokes cb.
+  // The caller holds a reference.
+  void complete() {
+    jsi_prepared_javascript_or_error result;
+    {
+      V8Scope scope(state);
+      TryCatch try_catch(state);
+      if (!compiled.IsEmpty())
+        result = abi::create_prepared_javascript_or_error(
+            new PreparedScriptImpl(state->isolate,
+                                   compiled.Get(state->isolate)));
+      else
+        result = job ? finishStreamed()
+                     : compileScript(state, std::exchange(buf, nullptr), key,
+                                     cache, source_url.c_str(),
+                                     source_url.size(), std::move(consume));
+      job.reset();
+      compiled.Reset();
+    }
+    state->asyncPrepares.erase(listIter);
+    cb(ctx, state, result);
+  }
 
-  // cache miss → produce code cache and hand it to the consumer.
-  if (state->script_cache_store_cb &&
-      options != v8::ScriptCompiler::CompileOptions::kConsumeCodeCache) {
-    v8::ScriptCompiler::CachedData *codeCache =
-        v8::ScriptCompiler::CreateCodeCache(unbound);
-    if (codeCache) {
-      // The consumer reads codeCache->data and then calls our delete_cb,
-      // which deletes the V8 CachedData object (and its owned buffer) in the
-      // DLL's CRT — the same CRT that allocated it.
-      auto delete_cb = [](void * /*data*/, void *deleter_data) {
-        delete static_cast<v8::ScriptCompiler::CachedData *>(deleter_data);
-      };
-      state->script_cache_store_cb(
-          state->script_cache_data,
-          source_url,
-          source_hash,
-          kRuntimeName,
-          runtime_version,
-          kCacheTag,
-          codeCache->data,
-          static_cast<size_t>(codeCache->length),
-          delete_cb,
-          codeCache);
+  // Runs in ~JsiRuntimeState, before the isolate is disposed.
+  void abandon() {
+    if (job) {
+      job->cancel();
+      job.reset();
     }
+    consume.reset();
+    cache.release();
+    compiled.Reset();
+    cb(ctx, nullptr,
+       abi::create_prepared_javascript_or_error(jsi_error_native));
   }
 
-  return abi::create_prepared_javascript_or_error(
-      new PreparedScriptImpl(isolate, unbound));
+ private:
+  jsi_prepared_javascript_or_error finishStreamed() {
+    // The worker has finished reading buf, so the source string may release
+    // it.
+    v8::Local<v8::String> sourceStr;
+    v8::Local<v8::String> urlV8Str;
+    if (!newScriptStrings(state, std::exchange(buf, nullptr), key,
+                          source_url.c_str(), source_url.size(), sourceStr,
+                          urlV8Str))
+      return abi::create_prepared_javascript_or_error(jsi_error_native);
+
+    v8::ScriptOrigin origin(urlV8Str);
+    v8::Local<v8::Script> compiled;
+    if (!job->finish(state->getContextLocal(), sourceStr, origin)
+             .ToLocal(&compiled))
+      return abi::create_prepared_javascript_or_error(jsi_error_js);
+
+    recordCodeCacheLookup(state, source_url.c_str(), key.hash, nullptr, 0,
+                          /*rejected:*/ false);
+    v8::Local<v8::UnboundScript> unbound = compiled->GetUnboundScript();
+    size_t cache_size =
+        storeCodeCache(state, source_url.c_str(), key.hash, unbound);
+    trackWarmScript(state, source_url.c_str(), key.hash, unbound, cache_size);
+    state->compiledScripts.insert(state->isolate, source_url, key.hash,
+                                  key.size, unbound);
+    return abi::create_prepared_javascript_or_error(
+        new PreparedScriptImpl(state->isolate, unbound));
+  }
+};
+
+void abandonAsyncPrepares(JsiRuntimeState *state) {
+  for (const std::shared_ptr<AsyncPrepare> &prepare : state->asyncPrepares)
+    prepare->abandon();
+  state->asyncPrepares.clear();
+}
+
+class AsyncPrepareTask final : public v8rt::TaskRunner::Task {
+ public:
+  explicit AsyncPrepareTask(std::weak_ptr<AsyncPrepare> prepare)
+      : prepare_(std::move(prepare)) {}
+
+  void run() override {
+    if (std::shared_ptr<AsyncPrepare> prepare = prepare_.lock())
+      prepare->complete();
+  }
+
+ private:
+  std::weak_ptr<AsyncPrepare> prepare_;
+};
+
+void JSI_CDECL jsi_prepare_javascript_async(
+    jsi_runtime *rt, jsi_buffer *buf, const char *source_url,
+    size_t source_url_len, void *ctx, jsi_prepare_javascript_cb cb) {
+  auto *state = getState(rt);
+  std::shared_ptr<v8rt::TaskRunner> taskRunner =
+      state->isolateData->taskRunner();
+  if (!taskRunner) {
+    jsi_prepared_javascript_or_error result;
+    {
+      V8Scope scope(state);
+      TryCatch try_catch(state);
+      result = prepareScript(state, buf, source_url, source_url_len,
+                             /*source_version:*/ 0);
+    }
+    cb(ctx, rt, result);
+    return;
+  }
+
+  V8Scope scope(state);
+  auto prepare = std::make_shared<AsyncPrepare>(
+      state, buf, source_url, source_url_len, ctx, cb);
+  prepare->key = keySource(state, buf, /*source_version:*/ 0);
+  prepare->listIter =
+      state->asyncPrepares.insert(state->asyncPrepares.end(), prepare);
+
+  v8::Local<v8::UnboundScript> unbound;
+  if (state->compiledScripts.lookup(
+          state->isolate, std::string_view(source_url, source_url_len),
+          prepare->key.hash, unbound)) {
+    prepare->compiled.Reset(state->isolate, unbound);
+    taskRunner->postTask(std::make_unique<AsyncPrepareTask>(prepare));
+    return;
+  }
+  loadCodeCache(state, source_url, prepare->key.hash, prepare->cache);
+
+  if (!prepare->cache.empty()) {
+    prepare->consume = startCodeCacheConsume(
+        state, prepare->cache, std::make_unique<AsyncPrepareTask>(prepare));
+    if (prepare->consume)
+      return;
+  } else if (buf->size >= v8rt::kMinStreamedScriptSize) {
+    const char *data = reinterpret_cast<const char *>(buf->data);
+    if (!prepare->key.is_ascii)
+      prepare->key.is_ascii = v8rt::isAscii(data, buf->size);
+    prepare->job = v8rt::ScriptStreamingJob::start(
+        state->isolate, v8rt::V8PlatformHolder::platform(), taskRunner, data,
+        buf->size, *prepare->key.is_ascii,
+        std::make_unique<AsyncPrepareTask>(prepare));
+    if (prepare->job)
+      return;
+  }
+  taskRunner->postTask(std::make_unique<AsyncPrepareTask>(prepare));
+}
+
+void JSI_CDECL jsi_notify_startup_complete(jsi_runtime *rt) {
+  auto *state = getState(rt);
+  V8Scope scope(state);
+  storeWarmCodeCaches(state);
 }
 
 jsi_value_or_error JSI_CDECL
@@ -1594,7 +2830,6 @@ jsi_evaluate_prepared_javascript(jsi_runtime *rt,
                                   jsi_prepared_javascript *prepared) {
   auto *state = getState(rt);
   V8Scope scope(state);
-  v8::Isolate *isolate = state->isolate;
   TryCatch try_catch(state);
 
   auto *impl = static_cast<PreparedScriptImpl *>(prepared);
@@ -1605,7 +2840,7 @@ jsi_evaluate_prepared_javascript(jsi_runtime *rt,
   if (!script->Run(state->getContextLocal()).ToLocal(&resultValue))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(isolate, resultValue));
+  return abi::create_value_or_error(createJsiValue(state, resultValue));
 }
 
 //------------------------------------------------------------------------------
@@ -1646,7 +2881,7 @@ jsi_object JSI_CDECL jsi_get_global_object(jsi_runtime *rt) {
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::Object> global = state->getContextLocal()->Global();
-  return {new ObjectHandle(state->isolate, global)};
+  return {newHandle<ObjectHandle>(state, global)};
 }
 
 //------------------------------------------------------------------------------
@@ -1659,16 +2894,14 @@ jsi_string_or_error JSI_CDECL jsi_create_string_from_utf8(jsi_runtime *rt,
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::String> v8str;
-  if (!v8::String::NewFromUtf8(state->isolate,
-                                reinterpret_cast<const char *>(utf8),
-                                v8::NewStringType::kNormal,
-                                static_cast<int>(len))
+  if (!v8rt::newStringFromUtf8(state->isolate,
+                               reinterpret_cast<const char *>(utf8), len)
            .ToLocal(&v8str)) {
     state->setNativeError("Failed to create string");
     return abi::create_string_or_error(jsi_error_native);
   }
   return abi::create_string_or_error(
-      static_cast<jsi_pointer *>(new StringHandle(state->isolate, v8str)));
+      static_cast<jsi_pointer *>(newHandle<StringHandle>(state, v8str)));
 }
 
 jsi_string_or_error JSI_CDECL jsi_create_string_from_utf16(
@@ -1684,7 +2917,7 @@ jsi_string_or_error JSI_CDECL jsi_create_string_from_utf16(
     return abi::create_string_or_error(jsi_error_native);
   }
   return abi::create_string_or_error(
-      static_cast<jsi_pointer *>(new StringHandle(state->isolate, v8str)));
+      static_cast<jsi_pointer *>(newHandle<StringHandle>(state, v8str)));
 }
 
 void JSI_CDECL jsi_get_utf8_from_string(jsi_runtime *rt, jsi_string str,
@@ -1694,13 +2927,13 @@ void JSI_CDECL jsi_get_utf8_from_string(jsi_runtime *rt, jsi_string str,
   v8::Isolate *isolate = state->isolate;
   v8::Local<v8::String> v8str = toStringHandle(str)->get(state->isolate);
 
-  size_t utf8_len = v8str->Utf8LengthV2(isolate);
-  if (buf->size < utf8_len)
-    buf->vtable->try_grow_to(buf, utf8_len);
-  if (buf->size >= utf8_len) {
-    v8str->WriteUtf8V2(isolate, reinterpret_cast<char *>(buf->data),
-                        static_cast<int>(utf8_len));
-    buf->used = utf8_len;
+  v8rt::Utf8Size utf8 = v8rt::measureUtf8(isolate, v8str);
+  if (buf->size < utf8.length)
+    buf->vtable->try_grow_to(buf, utf8.length);
+  if (buf->size >= utf8.length) {
+    buf->used = v8rt::writeUtf8(isolate, v8str,
+                                reinterpret_cast<char *>(buf->data),
+                                utf8.length, utf8);
   }
 }
 
@@ -1722,6 +2955,18 @@ void JSI_CDECL jsi_get_utf16_from_string(jsi_runtime *rt, jsi_string str,
   }
 }
 
+void JSI_CDECL jsi_get_string_data(jsi_runtime *rt, jsi_string str,
+                                    void *ctx, jsi_string_data_cb cb) {
+  auto *state = getState(rt);
+  V8Scope scope(state);
+  v8::Local<v8::String> v8str = toStringHandle(str)->get(state->isolate);
+  v8rt_internal::visitStringData(
+      state->isolate, v8str,
+      [&](bool ascii, const void *data, size_t num) {
+        cb(ctx, ascii, data, num);
+      });
+}
+
 //------------------------------------------------------------------------------
 // Symbol Operations
 //------------------------------------------------------------------------------
@@ -1738,10 +2983,7 @@ void JSI_CDECL jsi_get_utf8_from_symbol(jsi_runtime *rt, jsi_symbol sym,
   std::string result_str = "Symbol(";
   if (descVal->IsString()) {
     v8::Local<v8::String> descStr = v8::Local<v8::String>::Cast(descVal);
-    size_t len = descStr->Utf8LengthV2(isolate);
-    std::string desc(len, '\0');
-    descStr->WriteUtf8V2(isolate, &desc[0], static_cast<int>(len));
-    result_str += desc;
+    result_str += v8rt::toUtf8String(isolate, descStr);
   }
   result_str += ")";
   writeToBuf(buf, result_str);
@@ -1756,16 +2998,20 @@ jsi_propnameid_or_error JSI_CDECL jsi_create_propnameid_from_utf8(
   auto *state = getState(rt);
   V8Scope scope(state);
   v8::Local<v8::String> v8str;
-  if (!v8::String::NewFromUtf8(state->isolate,
-                                reinterpret_cast<const char *>(utf8),
-                                v8::NewStringType::kInternalized,
-                                static_cast<int>(len))
+  if (!state->propNameInternTable
+           .get(state->isolate,
+                std::string_view(reinterpret_cast<const char *>(utf8), len),
+                [](v8::Isolate *isolate, std::string_view name) {
+                  return v8rt::newStringFromUtf8(
+                      isolate, name.data(), name.size(),
+                      v8::NewStringType::kInternalized);
+                })
            .ToLocal(&v8str)) {
     state->setNativeError("Failed to create property name");
     return abi::create_propnameid_or_error(jsi_error_native);
   }
   return abi::create_propnameid_or_error(
-      static_cast<jsi_pointer *>(new PropNameIdHandle(state->isolate, v8str)));
+      static_cast<jsi_pointer *>(newHandle<PropNameIdHandle>(state, v8str)));
 }
 
 jsi_propnameid_or_error JSI_CDECL
@@ -1774,7 +3020,7 @@ jsi_create_propnameid_from_string(jsi_runtime *rt, jsi_string str) {
   V8Scope scope(state);
   v8::Local<v8::String> v8str = toStringHandle(str)->get(state->isolate);
   return abi::create_propnameid_or_error(
-      static_cast<jsi_pointer *>(new PropNameIdHandle(state->isolate, v8str)));
+      static_cast<jsi_pointer *>(newHandle<PropNameIdHandle>(state, v8str)));
 }
 
 jsi_propnameid_or_error JSI_CDECL
@@ -1783,7 +3029,7 @@ jsi_create_propnameid_from_symbol(jsi_runtime *rt, jsi_symbol sym) {
   V8Scope scope(state);
   v8::Local<v8::Symbol> v8sym = toSymbolHandle(sym)->get(state->isolate);
   return abi::create_propnameid_or_error(
-      static_cast<jsi_pointer *>(new PropNameIdHandle(state->isolate, v8sym)));
+      static_cast<jsi_pointer *>(newHandle<PropNameIdHandle>(state, v8sym)));
 }
 
 bool JSI_CDECL jsi_prop_name_id_equals(jsi_runtime *rt, jsi_propnameid a,
@@ -1795,6 +3041,19 @@ bool JSI_CDECL jsi_prop_name_id_equals(jsi_runtime *rt, jsi_propnameid a,
   return va->StrictEquals(vb);
 }
 
+void JSI_CDECL jsi_get_propnameid_data(jsi_runtime *rt, jsi_propnameid name,
+                                        void *ctx, jsi_string_data_cb cb) {
+  auto *state = getState(rt);
+  V8Scope scope(state);
+  v8::Isolate *isolate = state->isolate;
+  v8::Local<v8::Value> v8val = toPropNameIdHandle(name)->get(isolate);
+  v8rt_internal::visitStringData(
+      isolate, v8rt_internal::propNameString(isolate, v8val),
+      [&](bool ascii, const void *data, size_t num) {
+        cb(ctx, ascii, data, num);
+      });
+}
+
 void JSI_CDECL jsi_get_utf8_from_propnameid(jsi_runtime *rt,
                                              jsi_propnameid name,
                                              jsi_growable_buffer *buf) {
@@ -1819,13 +3078,13 @@ void JSI_CDECL jsi_get_utf8_from_propnameid(jsi_runtime *rt,
     return;
   }
 
-  size_t utf8_len = v8str->Utf8LengthV2(isolate);
-  if (buf->size < utf8_len)
-    buf->vtable->try_grow_to(buf, utf8_len);
-  if (buf->size >= utf8_len) {
-    v8str->WriteUtf8V2(isolate, reinterpret_cast<char *>(buf->data),
-                        static_cast<int>(utf8_len));
-    buf->used = utf8_len;
+  v8rt::Utf8Size utf8 = v8rt::measureUtf8(isolate, v8str);
+  if (buf->size < utf8.length)
+    buf->vtable->try_grow_to(buf, utf8.length);
+  if (buf->size >= utf8.length) {
+    buf->used = v8rt::writeUtf8(isolate, v8str,
+                                reinterpret_cast<char *>(buf->data),
+                                utf8.length, utf8);
   }
 }
 
@@ -1838,7 +3097,7 @@ jsi_object_or_error JSI_CDECL jsi_create_object(jsi_runtime *rt) {
   V8Scope scope(state);
   v8::Local<v8::Object> obj = v8::Object::New(state->isolate);
   return abi::create_object_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(state->isolate, obj)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, obj)));
 }
 
 jsi_object_or_error JSI_CDECL
@@ -1857,7 +3116,7 @@ jsi_create_object_with_prototype(jsi_runtime *rt,
   v8::Local<v8::Object> obj =
       v8::Object::New(isolate, proto, nullptr, nullptr, 0);
   return abi::create_object_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(isolate, obj)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, obj)));
 }
 
 jsi_value_or_error JSI_CDECL jsi_get_prototype_of(jsi_runtime *rt,
@@ -1866,7 +3125,7 @@ jsi_value_or_error JSI_CDECL jsi_get_prototype_of(jsi_runtime *rt,
   V8Scope scope(state);
   v8::Local<v8::Object> v8obj = toObjectHandle(obj)->get(state->isolate);
   v8::Local<v8::Value> proto = v8obj->GetPrototypeV2();
-  return abi::create_value_or_error(createJsiValue(state->isolate, proto));
+  return abi::create_value_or_error(createJsiValue(state, proto));
 }
 
 jsi_error_code JSI_CDECL jsi_set_prototype_of(jsi_runtime *rt,
@@ -1921,7 +3180,7 @@ jsi_value_or_error JSI_CDECL jsi_get_object_property_from_propnameid(
   if (!v8obj->Get(state->getContextLocal(), v8name).ToLocal(&val))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(state->isolate, val));
+  return abi::create_value_or_error(createJsiValue(state, val));
 }
 
 jsi_error_code JSI_CDECL jsi_set_object_property_from_propnameid(
@@ -1985,7 +3244,7 @@ jsi_value_or_error JSI_CDECL jsi_get_object_property_from_value(
   if (!v8obj->Get(state->getContextLocal(), v8key).ToLocal(&val))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(state->isolate, val));
+  return abi::create_value_or_error(createJsiValue(state, val));
 }
 
 jsi_error_code JSI_CDECL jsi_set_object_property_from_value(
@@ -2041,15 +3300,19 @@ jsi_array_or_error JSI_CDECL jsi_get_object_property_names(jsi_runtime *rt,
     return abi::create_array_or_error(jsi_error_js);
 
   return abi::create_array_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(state->isolate, names)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, names)));
 }
 
 jsi_error_code JSI_CDECL jsi_set_object_external_memory_pressure(
-    jsi_runtime *rt, jsi_object /*obj*/, size_t amount) {
+    jsi_runtime *rt, jsi_object obj, size_t amount) {
   auto *state = getState(rt);
   V8Scope scope(state);
-  state->isolate->AdjustAmountOfExternalAllocatedMemory(
-      static_cast<int64_t>(amount));
+  TryCatch try_catch(state);
+
+  v8::Local<v8::Object> v8obj = toObjectHandle(obj)->get(state->isolate);
+  if (!state->externalMemoryTable.set(
+          state->isolate, state->getContextLocal(), v8obj, amount))
+    return jsi_error_js;
   return jsi_no_error;
 }
 
@@ -2076,7 +3339,7 @@ jsi_object_or_error JSI_CDECL jsi_create_error(jsi_runtime *rt,
 
   v8::Local<v8::Value> error = v8::Exception::Error(msgStr);
   return abi::create_object_or_error(static_cast<jsi_pointer *>(
-      new ObjectHandle(isolate, v8::Local<v8::Object>::Cast(error))));
+      newHandle<ObjectHandle>(state, v8::Local<v8::Object>::Cast(error))));
 }
 
 //------------------------------------------------------------------------------
@@ -2089,7 +3352,7 @@ jsi_array_or_error JSI_CDECL jsi_create_array(jsi_runtime *rt, size_t length) {
   v8::Local<v8::Array> arr =
       v8::Array::New(state->isolate, static_cast<int>(length));
   return abi::create_array_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(state->isolate, arr)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, arr)));
 }
 
 size_t JSI_CDECL jsi_get_array_length(jsi_runtime *rt, jsi_array arr) {
@@ -2114,7 +3377,7 @@ jsi_value_or_error JSI_CDECL jsi_get_array_element(jsi_runtime *rt,
            .ToLocal(&val))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(state->isolate, val));
+  return abi::create_value_or_error(createJsiValue(state, val));
 }
 
 jsi_error_code JSI_CDECL jsi_set_array_element(jsi_runtime *rt,
@@ -2146,7 +3409,7 @@ jsi_arraybuffer_or_error JSI_CDECL jsi_create_arraybuffer(jsi_runtime *rt,
   v8::Local<v8::ArrayBuffer> ab =
       v8::ArrayBuffer::New(state->isolate, byte_length);
   return abi::create_arraybuffer_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(state->isolate, ab)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, ab)));
 }
 
 jsi_arraybuffer_or_error JSI_CDECL jsi_create_arraybuffer_from_external_data(
@@ -2168,7 +3431,7 @@ jsi_arraybuffer_or_error JSI_CDECL jsi_create_arraybuffer_from_external_data(
   if (buf->vtable && buf->vtable->release)
     buf->vtable->release(buf);
   return abi::create_arraybuffer_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(isolate, ab)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, ab)));
 #else
   struct BufRef {
     jsi_mutable_buffer *buf;
@@ -2189,7 +3452,7 @@ jsi_arraybuffer_or_error JSI_CDECL jsi_create_arraybuffer_from_external_data(
   v8::Local<v8::ArrayBuffer> ab =
       v8::ArrayBuffer::New(isolate, std::move(backing_store));
   return abi::create_arraybuffer_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(isolate, ab)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, ab)));
 #endif  // V8_ENABLE_SANDBOX
 }
 
@@ -2248,10 +3511,7 @@ jsi_value_or_error JSI_CDECL jsi_call(jsi_runtime *rt, jsi_function fn,
       js_this ? toV8Value(isolate, js_this)
               : v8::Undefined(isolate).As<v8::Value>();
 
-  std::vector<v8::Local<v8::Value>> v8args;
-  v8args.reserve(arg_count);
-  for (size_t i = 0; i < arg_count; ++i)
-    v8args.push_back(toV8Value(isolate, &args[i]));
+  CallArgs v8args(isolate, args, arg_count);
 
   v8::Local<v8::Value> callResult;
   if (!v8func
@@ -2260,7 +3520,7 @@ jsi_value_or_error JSI_CDECL jsi_call(jsi_runtime *rt, jsi_function fn,
            .ToLocal(&callResult))
     return abi::create_value_or_error(jsi_error_js);
 
-  return abi::create_value_or_error(createJsiValue(isolate, callResult));
+  return abi::create_value_or_error(createJsiValue(state, callResult));
 }
 
 jsi_value_or_error JSI_CDECL jsi_call_as_constructor(jsi_runtime *rt,
@@ -2279,10 +3539,7 @@ jsi_value_or_error JSI_CDECL jsi_call_as_constructor(jsi_runtime *rt,
   }
   v8::Local<v8::Function> v8func = v8::Local<v8::Function>::Cast(v8obj);
 
-  std::vector<v8::Local<v8::Value>> v8args;
-  v8args.reserve(arg_count);
-  for (size_t i = 0; i < arg_count; ++i)
-    v8args.push_back(toV8Value(isolate, &args[i]));
+  CallArgs v8args(isolate, args, arg_count);
 
   v8::Local<v8::Object> constructed;
   if (!v8func
@@ -2292,7 +3549,7 @@ jsi_value_or_error JSI_CDECL jsi_call_as_constructor(jsi_runtime *rt,
     return abi::create_value_or_error(jsi_error_js);
 
   return abi::create_value_or_error(
-      abi::create_object_value(new ObjectHandle(isolate, constructed)));
+      abi::create_object_value(newHandle<ObjectHandle>(state, constructed)));
 }
 
 jsi_function_or_error JSI_CDECL jsi_create_function_from_host_function(
@@ -2329,7 +3586,7 @@ jsi_function_or_error JSI_CDECL jsi_create_function_from_host_function(
   }
 
   return abi::create_function_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(isolate, func)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, func)));
 }
 
 jsi_host_function *JSI_CDECL jsi_get_host_function(jsi_runtime *rt,
@@ -2375,7 +3632,7 @@ jsi_create_object_from_host_object(jsi_runtime *rt, jsi_host_object *ho) {
                         v8::External::New(isolate, proxy));
 
   return abi::create_object_or_error(
-      static_cast<jsi_pointer *>(new ObjectHandle(isolate, newObject)));
+      static_cast<jsi_pointer *>(newHandle<ObjectHandle>(state, newObject)));
 }
 
 jsi_host_object *JSI_CDECL jsi_get_host_object(jsi_runtime *rt,
@@ -2478,7 +3735,8 @@ jsi_weak_object_or_error JSI_CDECL jsi_create_weak_object(jsi_runtime *rt,
   V8Scope scope(state);
   v8::Local<v8::Object> v8obj = toObjectHandle(obj)->get(state->isolate);
   return abi::create_weak_object_or_error(
-      static_cast<jsi_pointer *>(new WeakObjectHandle(state->isolate, v8obj)));
+      static_cast<jsi_pointer *>(
+          state->handlePool.create<WeakObjectHandle>(state->isolate, v8obj)));
 }
 
 jsi_value JSI_CDECL jsi_lock_weak_object(jsi_runtime *rt,
@@ -2488,7 +3746,7 @@ jsi_value JSI_CDECL jsi_lock_weak_object(jsi_runtime *rt,
   v8::Local<v8::Object> v8obj = toWeakObjectHandle(wo)->get(state->isolate);
   if (v8obj.IsEmpty())
     return abi::create_undefined_value();
-  return abi::create_object_value(new ObjectHandle(state->isolate, v8obj));
+  return abi::create_object_value(newHandle<ObjectHandle>(state, v8obj));
 }
 
 //------------------------------------------------------------------------------
@@ -2549,7 +3807,7 @@ jsi_bigint_or_error JSI_CDECL jsi_create_bigint_from_int64(jsi_runtime *rt,
   V8Scope scope(state);
   v8::Local<v8::BigInt> bi = v8::BigInt::New(state->isolate, value);
   return abi::create_bigint_or_error(
-      static_cast<jsi_pointer *>(new BigIntHandle(state->isolate, bi)));
+      static_cast<jsi_pointer *>(newHandle<BigIntHandle>(state, bi)));
 }
 
 jsi_bigint_or_error JSI_CDECL jsi_create_bigint_from_uint64(jsi_runtime *rt,
@@ -2559,7 +3817,7 @@ jsi_bigint_or_error JSI_CDECL jsi_create_bigint_from_uint64(jsi_runtime *rt,
   v8::Local<v8::BigInt> bi =
       v8::BigInt::NewFromUnsigned(state->isolate, value);
   return abi::create_bigint_or_error(
-      static_cast<jsi_pointer *>(new BigIntHandle(state->isolate, bi)));
+      static_cast<jsi_pointer *>(newHandle<BigIntHandle>(state, bi)));
 }
 
 bool JSI_CDECL jsi_bigint_is_int64(jsi_runtime *rt, jsi_bigint bigint) {
@@ -2646,7 +3904,7 @@ jsi_string_or_error JSI_CDECL jsi_bigint_to_string(jsi_runtime *rt,
   }
 
   return abi::create_string_or_error(static_cast<jsi_pointer *>(
-      new StringHandle(isolate, v8::Local<v8::String>::Cast(resultValue))));
+      newHandle<StringHandle>(state, v8::Local<v8::String>::Cast(resultValue))));
 }
 
 //==============================================================================
@@ -2767,6 +4025,12 @@ const jsi_runtime_vtable g_vtable = {
     /* bigint_to_int64 */ jsi_bigint_to_int64,
     /* bigint_to_uint64 */ jsi_bigint_to_uint64,
     /* bigint_to_string */ jsi_bigint_to_string,
+
+    /* get_string_data */ jsi_get_string_data,
+    /* get_propnameid_data */ jsi_get_propnameid_data,
+    /* prepare_javascript_from_store */ jsi_prepare_javascript_from_store,
+    /* prepare_javascript_async */ jsi_prepare_javascript_async,
+    /* notify_startup_complete */ jsi_notify_startup_complete,
 };
 
 } // anonymous namespace
@@ -2776,8 +4040,8 @@ const jsi_runtime_vtable g_vtable = {
 //==============================================================================
 //
 // These are internal-coupling accessors exposed to other TUs compiled into
-// v8jsi.dll (currently node-api/v8_api_abi.cpp). They reach into the
-// anonymous-namespaced JsiRuntimeState without leaking its layout.
+// v8jsi.dll (node-api/v8_api_abi.cpp, jsi_abi/V8DirectRuntime.cpp). They
+// reach into the anonymous-namespaced JsiRuntimeState without leaking its layout.
 
 namespace v8rt_internal {
 
@@ -2803,6 +4067,22 @@ bool getEnableMultiThread(jsi_runtime *runtime) noexcept {
   return toState(runtime)->enableMultiThread;
 }
 
+PropNameInternTable &getPropNameInternTable(jsi_runtime *runtime) noexcept {
+  return toState(runtime)->propNameInternTable;
+}
+
+ExternalMemoryTable &getExternalMemoryTable(jsi_runtime *runtime) noexcept {
+  return toState(runtime)->externalMemoryTable;
+}
+
+SourceHashCache &getSourceHashCache(jsi_runtime *runtime) noexcept {
+  return toState(runtime)->sourceHashCache;
+}
+
+CompiledScriptCache &getCompiledScriptCache(jsi_runtime *runtime) noexcept {
+  return toState(runtime)->compiledScripts;
+}
+
 bool hasUnhandledPromiseRejection(jsi_runtime *runtime) noexcept {
   return !!toState(runtime)->last_unhandled_promise;
 }
@@ -2820,6 +4100,13 @@ ScriptCacheCallbacks getScriptCacheCallbacks(jsi_runtime *runtime) noexcept {
       state->script_cache_store_cb};
 }
 
+void recordCodeCacheLookup(jsi_runtime *runtime, const char *source_url,
+                           uint64_t source_hash, const uint8_t *cache,
+                           size_t cache_size, bool rejected) noexcept {
+  ::recordCodeCacheLookup(toState(runtime), source_url, source_hash, cache,
+                          cache_size, rejected);
+}
+
 void setAttachedOwner(jsi_runtime *runtime,
                       void *attached,
                       RuntimeAttachedDestroyCb destroy_cb) noexcept {
@@ -2834,6 +4121,15 @@ void clearAttachedOwner(jsi_runtime *runtime) noexcept {
   state->attached_owner_destroy = nullptr;
 }
 
+void addTeardownHook(jsi_runtime *runtime, RuntimeTeardownCb cb, void *data) {
+  toState(runtime)->teardown_hooks.emplace_back(cb, data);
+}
+
+v8::Local<v8::Value> toV8Value(jsi_runtime *runtime,
+                               const jsi_value &value) noexcept {
+  return ::toV8Value(toState(runtime)->isolate, &value);
+}
+
 }  // namespace v8rt_internal
 
 //==============================================================================
@@ -3057,6 +4353,62 @@ JSI_API void JSI_CDECL v8_open_inspector(jsi_runtime *runtime) {
 #endif
 }
 
+JSI_API void JSI_CDECL
+v8_jsi_get_handle_stats(jsi_runtime *runtime, v8_jsi_handle_stats *stats) {
+  if (!stats)
+    return;
+  *stats = v8_jsi_handle_stats{};
+  if (!runtime)
+    return;
+  auto *state = static_cast<JsiRuntimeState *>(runtime);
+  stats->live_handles = state->handleCounters.live;
+  stats->peak_handles = state->handleCounters.peak;
+  stats->pool_slabs = state->handlePool.slabCount();
+  stats->pool_slots_per_slab = HandlePool::kSlotsPerSlab;
+}
+
+JSI_API void JSI_CDECL v8_jsi_get_propname_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_propname_cache_stats *stats) {
+  if (!stats)
+    return;
+  *stats = v8_jsi_propname_cache_stats{};
+  if (!runtime)
+    return;
+  auto *state = static_cast<JsiRuntimeState *>(runtime);
+  stats->hits = state->propNameInternTable.hits();
+  stats->misses = state->propNameInternTable.misses();
+  stats->capacity = v8rt_internal::PropNameInternTable::kSlotCount;
+}
+
+JSI_API void JSI_CDECL v8_jsi_get_code_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_code_cache_stats *stats) {
+  if (!stats)
+    return;
+  *stats = v8_jsi_code_cache_stats{};
+  if (!runtime)
+    return;
+  *stats = static_cast<JsiRuntimeState *>(runtime)->codeCacheStats;
+}
+
+JSI_API void JSI_CDECL v8_jsi_get_compiled_script_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_compiled_script_cache_stats *stats) {
+  if (!stats)
+    return;
+  *stats = v8_jsi_compiled_script_cache_stats{};
+  if (!runtime)
+    return;
+  const v8rt_internal::CompiledScriptCache &compiledScripts =
+      static_cast<JsiRuntimeState *>(runtime)->compiledScripts;
+  stats->hits = compiledScripts.hits();
+  stats->misses = compiledScripts.misses();
+  stats->bytes = compiledScripts.bytes();
+  stats->entries = compiledScripts.entries();
+  stats->max_bytes = compiledScripts.maxBytes();
+}
+
 // test-only hook: post a synthetic task to the runtime's foreground task
 // runner. Gated behind JSI_TESTING_ONLY (gyp variable v8jsi_test_hooks) so
 // release builds can drop it. Not declared in any public header; the test
@@ -3143,6 +4495,31 @@ v8_jsi_config_enable_multi_thread(jsi_config config, bool value) {
   if (config) config->enable_multi_thread = value;
 }
 
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_background_code_cache(jsi_config config, bool value) {
+  if (config) config->background_code_cache = value;
+}
+
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_warm_code_cache(jsi_config config, bool value) {
+  if (config) config->warm_code_cache = value;
+}
+
+JSI_API void JSI_CDECL
+v8_jsi_config_set_warm_code_cache_delay(jsi_config config, uint32_t delay_ms) {
+  if (config) config->warm_code_cache_delay_ms = delay_ms;
+}
+
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_lazy_script_source(jsi_config config, bool value) {
+  if (config) config->lazy_script_source = value;
+}
+
+JSI_API void JSI_CDECL v8_jsi_config_set_compiled_script_cache_size(
+    jsi_config config, size_t max_bytes) {
+  if (config) config->compiled_script_cache_size = max_bytes;
+}
+
 JSI_API void JSI_CDECL
 v8_jsi_config_enable_jit_tracing(jsi_config config, bool value) {
   if (config) config->enable_jit_tracing = value;
@@ -3188,6 +4565,35 @@ JSI_API void JSI_CDECL v8_jsi_config_set_script_cache(
   config->script_cache_deleter_data = deleter_data;
 }
 
+JSI_API void JSI_CDECL v8_jsi_config_set_script_cache_reject_cb(
+    jsi_config config,
+    v8_jsi_script_cache_reject_cb reject_cb) {
+  if (config) config->script_cache_reject_cb = reject_cb;
+}
+
+JSI_API void JSI_CDECL v8_jsi_config_set_script_store(
+    jsi_config config,
+    void *script_store_data,
+    v8_jsi_script_store_load_cb load_cb,
+    jsi_data_delete_cb script_store_data_delete_cb,
+    void *deleter_data) {
+  if (!config) {
+    // Nothing owns script_store_data; release it immediately.
+    if (script_store_data_delete_cb)
+      script_store_data_delete_cb(script_store_data, deleter_data);
+    return;
+  }
+  // Release any previously-set store before overwriting.
+  if (config->script_store_data_delete_cb) {
+    config->script_store_data_delete_cb(
+        config->script_store_data, config->script_store_deleter_data);
+  }
+  config->script_store_data = script_store_data;
+  config->script_store_load_cb = load_cb;
+  config->script_store_data_delete_cb = script_store_data_delete_cb;
+  config->script_store_deleter_data = deleter_data;
+}
+
 JSI_API void JSI_CDECL v8_jsi_config_set_task_runner(
     jsi_config config,
     void *task_runner_data,
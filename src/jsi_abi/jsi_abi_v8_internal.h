@@ -2,7 +2,8 @@
 // Licensed under the MIT license.
 //
 // Internal accessor functions for JsiRuntimeState. Used only by code
-// compiled into v8jsi.dll (currently jsi_abi_v8.cpp + node-api/v8_api_abi.cpp).
+// compiled into v8jsi.dll (currently jsi_abi_v8.cpp, node-api/v8_api_abi.cpp
+// and jsi_abi/V8DirectRuntime.cpp).
 // JsiRuntimeState's full layout is anonymous-namespaced inside
 // jsi_abi_v8.cpp; these free functions expose the bits the Node-API surface
 // needs without leaking the struct shape (host-object proxies, host-function
@@ -12,6 +13,10 @@
 
 #pragma once
 
+#include "jsi_abi/CompiledScriptCache.h"
+#include "jsi_abi/ExternalMemoryTable.h"
+#include "jsi_abi/PropNameInternTable.h"
+#include "jsi_abi/SourceHashCache.h"
 #include "jsi_abi/jsi_abi.h"
 #include "jsi_abi/v8_jsi_config.h"
 #include "../v8_core.h"
@@ -34,6 +39,21 @@ v8::Local<v8::Context> getContextLocal(jsi_runtime *runtime) noexcept;
 /// Used to decide whether v8::Locker should be acquired around scoped work.
 bool getEnableMultiThread(jsi_runtime *runtime) noexcept;
 
+/// The runtime's property-name intern table. Callers must hold the isolate.
+PropNameInternTable &getPropNameInternTable(jsi_runtime *runtime) noexcept;
+
+/// The runtime's per-object external memory accounting. Callers must hold the
+/// isolate.
+ExternalMemoryTable &getExternalMemoryTable(jsi_runtime *runtime) noexcept;
+
+/// Hashes of script sources the runtime still wraps in place. Callers must
+/// hold the isolate.
+SourceHashCache &getSourceHashCache(jsi_runtime *runtime) noexcept;
+
+/// Scripts the runtime keeps for repeat prepares. Callers must hold the
+/// isolate.
+CompiledScriptCache &getCompiledScriptCache(jsi_runtime *runtime) noexcept;
+
 /// True if a previous unhandled promise rejection has been recorded and
 /// not yet cleared.
 bool hasUnhandledPromiseRejection(jsi_runtime *runtime) noexcept;
@@ -53,6 +73,14 @@ struct ScriptCacheCallbacks {
 };
 ScriptCacheCallbacks getScriptCacheCallbacks(jsi_runtime *runtime) noexcept;
 
+/// Counts a code cache lookup in v8_jsi_get_code_cache_stats and, if V8
+/// rejected the cache bytes the load callback returned, reports why to the
+/// consumer's reject callback. The caller then stores a fresh cache. Call
+/// with the isolate entered, before the cache bytes are released.
+void recordCodeCacheLookup(jsi_runtime *runtime, const char *source_url,
+                           uint64_t source_hash, const uint8_t *cache,
+                           size_t cache_size, bool rejected) noexcept;
+
 /// Type for the attached-Node-API teardown callback. Called from
 /// ~JsiRuntimeState before any V8 state is freed.
 typedef void (*RuntimeAttachedDestroyCb)(void *attached);
@@ -71,4 +99,21 @@ void setAttachedOwner(jsi_runtime *runtime,
 /// double-fire the destroy callback.
 void clearAttachedOwner(jsi_runtime *runtime) noexcept;
 
+/// Type for a runtime teardown hook. See addTeardownHook.
+typedef void (*RuntimeTeardownCb)(void *data);
+
+/// Register a hook that ~JsiRuntimeState runs once the last reference to the
+/// runtime is released, after the attached owner is torn down and before any
+/// V8 state is freed. Hooks run newest first. Used by the direct runtime to
+/// keep the contexts of its host functions and host objects alive for as long
+/// as JS can reach them.
+void addTeardownHook(jsi_runtime *runtime, RuntimeTeardownCb cb, void *data);
+
+/// Resolve a jsi_value produced by this runtime to a V8 local. Pointer kinds
+/// are read through their ABI handle without changing its ownership; the
+/// caller must have a HandleScope open. Used by the direct runtime to adopt
+/// results of the ABI entry points it delegates to (script evaluation).
+v8::Local<v8::Value> toV8Value(jsi_runtime *runtime,
+                               const jsi_value &value) noexcept;
+
 }  // namespace v8rt_internal
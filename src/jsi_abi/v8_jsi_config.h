@@ -306,6 +306,120 @@ JSI_API void JSI_CDECL v8_jsi_config_set_script_cache(
     jsi_data_delete_cb script_cache_data_delete_cb,
     void *deleter_data);
 
+/* Why V8 rejected a code cache returned by the load callback. The values are
+ * those of v8::ScriptCompiler::CachedData::CompatibilityCheckResult. */
+typedef enum {
+  v8_jsi_code_cache_reject_magic_number_mismatch = 1, /* not a code cache */
+  v8_jsi_code_cache_reject_version_mismatch = 2,      /* another V8 version */
+  v8_jsi_code_cache_reject_source_mismatch = 3,       /* another source */
+  v8_jsi_code_cache_reject_flags_mismatch = 5,        /* other V8 flags */
+  v8_jsi_code_cache_reject_checksum_mismatch = 6,     /* corrupt payload */
+  v8_jsi_code_cache_reject_invalid_header = 7,
+  v8_jsi_code_cache_reject_length_mismatch = 8,       /* truncated */
+  v8_jsi_code_cache_reject_snapshot_mismatch = 9      /* another snapshot */
+} v8_jsi_code_cache_reject_reason;
+
+typedef void (JSI_CDECL *v8_jsi_script_cache_reject_cb)(
+    void *script_cache_data,
+    const char *source_url,
+    uint64_t source_hash,
+    const char *runtime_name,
+    uint64_t runtime_version,
+    const char *cache_tag,
+    int reason); /* v8_jsi_code_cache_reject_reason */
+
+/* Called when V8 rejects the code cache returned by the load callback for a
+ * script, with the same key. V8 then compiles the source instead, and the
+ * runtime passes a fresh code cache to the store callback right after this
+ * returns, so the entry heals on the next run. Optional; takes effect only
+ * with v8_jsi_config_set_script_cache, and receives its script_cache_data. */
+JSI_API void JSI_CDECL v8_jsi_config_set_script_cache_reject_cb(
+    jsi_config config,
+    v8_jsi_script_cache_reject_cb reject_cb);
+
+/* If true, a code cache returned by the load callback is deserialized on a V8
+ * worker thread as soon as it is loaded, and the JS thread only finalizes the
+ * script. prepare_javascript overlaps the deserialization with creating the
+ * source string; prepare_javascript_async keeps the JS thread free until its
+ * callback runs. Default is false (deserialize on the JS thread). */
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_background_code_cache(jsi_config config, bool value);
+
+/* V8 compiles functions lazily, so the code cache stored right after a script
+ * is compiled holds little more than its top level. If true, the runtime
+ * stores the code cache of each script prepared before startup completes a
+ * second time once it does, now including every function compiled since. A
+ * warm cache is stored only if it is at least 1/8 larger than the code cache
+ * loaded or stored for the script in this run, so a script whose warm cache
+ * is already in the store is not written again on every start.
+ *
+ * Startup completes when the host calls notify_startup_complete
+ * (jsi_runtime_vtable), or delay_ms after the first script is prepared if
+ * v8_jsi_config_set_warm_code_cache_delay sets a non-zero delay and the
+ * runtime has a task runner. Default is false. */
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_warm_code_cache(jsi_config config, bool value);
+
+JSI_API void JSI_CDECL
+v8_jsi_config_set_warm_code_cache_delay(jsi_config config, uint32_t delay_ms);
+
+/* Keeps the scripts that prepare_javascript, prepare_javascript_async and
+ * prepare_javascript_from_store compile, keyed on source URL and source hash
+ * (or store version). Preparing the same source again returns the script
+ * already compiled, without loading or deserializing its code cache. Each
+ * cached script keeps its source alive; the least recently used scripts are
+ * dropped once their sources add up to more than max_bytes, and a source
+ * larger than max_bytes is never cached. Default is 0 (no cache). */
+JSI_API void JSI_CDECL v8_jsi_config_set_compiled_script_cache_size(
+    jsi_config config,
+    size_t max_bytes);
+
+/*============================================================================
+ * Script store (versioned script sources)
+ *
+ * Mirrors facebook::jsi::ScriptStore (src/public/ScriptStore.h). The store
+ * maps a source URL to the script's bytes and an embedder-assigned version.
+ * prepare_javascript_from_store (jsi_runtime_vtable) loads scripts through
+ * it, and the version keys the script cache in place of a hash of the
+ * source, so a cached script is compiled without hashing its bytes.
+ *
+ * load_cb returns a jsi_buffer the runtime takes over (as with
+ * prepare_javascript), or NULL if the store has no script for source_url.
+ * *version is 0 when the store cannot version the script; the source is then
+ * hashed as usual.
+ *
+ * Lifetime: the same contract as the script cache above. The config owns
+ * script_store_data from the setter call, the runtime takes it over on
+ * creation, and script_store_data_delete_cb(script_store_data, deleter_data)
+ * runs exactly once.
+ *============================================================================*/
+
+typedef struct jsi_buffer *(JSI_CDECL *v8_jsi_script_store_load_cb)(
+    void *script_store_data,
+    const char *source_url,
+    uint64_t *version); /* out */
+
+JSI_API void JSI_CDECL v8_jsi_config_set_script_store(
+    jsi_config config,
+    void *script_store_data,
+    v8_jsi_script_store_load_cb load_cb,
+    jsi_data_delete_cb script_store_data_delete_cb,
+    void *deleter_data);
+
+/* If true, a script prepare_javascript_from_store loads with a non-zero
+ * version does not keep its source once it is compiled. The runtime calls
+ * load_cb again when V8 next reads the source (lazy compilation of a function
+ * the code cache does not cover, Function.prototype.toString, the debugger),
+ * possibly from a V8 worker thread, and drops that buffer again once V8 is
+ * done with it: from a task posted to the foreground task runner, or without
+ * one at the next compile. The store must then return the same version and
+ * bytes; if it cannot, V8 sees blanks in their place, so code compiled from
+ * them throws a SyntaxError, and the next read tries the store again. Only
+ * ASCII sources are dropped; others are transcoded on the V8 side anyway.
+ * Default is false. */
+JSI_API void JSI_CDECL
+v8_jsi_config_enable_lazy_script_source(jsi_config config, bool value);
+
 /*============================================================================
  * Task runner (foreground-thread dispatch)
  *
@@ -358,6 +472,70 @@ JSI_API void JSI_CDECL v8_jsi_config_set_task_runner(
 
 JSI_API void JSI_CDECL v8_open_inspector(jsi_runtime *runtime);
 
+/*============================================================================
+ * Diagnostics
+ *
+ * Every object, string, symbol, bigint, propnameid and weak-object handle the
+ * runtime returns is a small wrapper allocated from a per-runtime slab pool
+ * (inside push_scope/pop_scope, through that scope's free list). The counters
+ * below make allocator traffic and leaked handles visible.
+ *
+ * Must be called on the runtime's JS thread. NULL runtime zero-fills *stats.
+ *============================================================================*/
+
+typedef struct v8_jsi_handle_stats {
+  size_t live_handles;        /* wrappers created and not yet invalidated */
+  size_t peak_handles;        /* high-water mark of live_handles */
+  size_t pool_slabs;          /* slabs currently held by the wrapper pool */
+  size_t pool_slots_per_slab; /* wrapper slots per pool slab */
+} v8_jsi_handle_stats;
+
+JSI_API void JSI_CDECL
+v8_jsi_get_handle_stats(jsi_runtime *runtime, v8_jsi_handle_stats *stats);
+
+/* Property names created from bytes (create_propnameid_from_utf8, and the
+ * direct runtime's PropNameID::forAscii / forUtf8) go through a bounded
+ * per-runtime intern table of internalized strings. A hit skips the V8 string
+ * allocation and the string-table lookup. */
+typedef struct v8_jsi_propname_cache_stats {
+  uint64_t hits;     /* names served from the intern table */
+  uint64_t misses;   /* names created in V8 (including uncacheable ones) */
+  size_t capacity;   /* intern table slots */
+} v8_jsi_propname_cache_stats;
+
+JSI_API void JSI_CDECL v8_jsi_get_propname_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_propname_cache_stats *stats);
+
+/* Code cache lookups by script preparation (prepare_javascript and Node-API's
+ * prepared scripts) when the runtime has a script cache. A rejected entry is
+ * compiled from source and stored again. */
+typedef struct v8_jsi_code_cache_stats {
+  uint64_t hits;       /* code caches V8 accepted */
+  uint64_t misses;     /* scripts the load callback had no code cache for */
+  uint64_t rejections; /* code caches V8 rejected (see the reject callback) */
+  uint64_t warm_stores; /* warm code caches stored (enable_warm_code_cache) */
+} v8_jsi_code_cache_stats;
+
+JSI_API void JSI_CDECL v8_jsi_get_code_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_code_cache_stats *stats);
+
+/* Lookups of prepared scripts in the compiled script cache
+ * (v8_jsi_config_set_compiled_script_cache_size). All zero if it is
+ * disabled. */
+typedef struct v8_jsi_compiled_script_cache_stats {
+  uint64_t hits;     /* prepares that reused a compiled script */
+  uint64_t misses;   /* prepares that compiled the script */
+  size_t bytes;      /* source bytes of the cached scripts */
+  size_t entries;    /* cached scripts */
+  size_t max_bytes;  /* bound on bytes */
+} v8_jsi_compiled_script_cache_stats;
+
+JSI_API void JSI_CDECL v8_jsi_get_compiled_script_cache_stats(
+    jsi_runtime *runtime,
+    v8_jsi_compiled_script_cache_stats *stats);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
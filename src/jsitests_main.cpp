@@ -4,14 +4,32 @@
 // JSI tests main file - uses V8JsiRuntime without Node-API
 
 #include <gtest/gtest.h>
+#include <jsi/instrumentation.h>
 #include <jsi/jsi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 #include "jsi/test/testlib.h"
+#include "public/FileScriptStore.h"
 #include "public/ScriptStore.h"
 #include "public/V8JsiRuntime.h"
+#include "jsi_abi/AsyncPrepareRuntime.h"
+#include "jsi_abi/IndexedHostObject.h"
+#include "jsi_abi/PreparedCall.h"
+#include "jsi_abi/ScriptStoreRuntime.h"
+#include "jsi_abi/StartupCompleteRuntime.h"
 #include "jsi_abi/JsiAbiRuntime.h"
 #include "jsi_abi/jsi_abi_helpers.h"
 #include "jsi_abi/v8_jsi_config.h"
@@ -33,6 +51,7 @@ namespace facebook::jsi {
 // Runtime index constants for identifying which runtime is being tested
 constexpr size_t kDirectRuntimeIndex = 0;
 constexpr size_t kAbiRuntimeIndex = 1;
+constexpr size_t kInProcessRuntimeIndex = 2;
 
 std::vector<facebook::jsi::RuntimeFactory> runtimeGenerators() {
   return std::vector<facebook::jsi::RuntimeFactory>{
@@ -47,6 +66,14 @@ std::vector<facebook::jsi::RuntimeFactory> runtimeGenerators() {
       []() -> std::shared_ptr<facebook::jsi::Runtime> {
         return ::jsi::abi::makeJsiAbiRuntime(&v8_create_runtime);
       },
+      // Index 2: In-process V8DirectRuntime (flags.directRuntime), no ABI hop
+      []() -> std::shared_ptr<facebook::jsi::Runtime> {
+        v8runtime::V8RuntimeArgs args;
+        args.flags.explicitMicrotaskPolicy = true;
+        args.flags.enableGCApi = true;
+        args.flags.directRuntime = true;
+        return v8runtime::makeV8Runtime(std::move(args));
+      },
   };
 }
 
@@ -69,6 +96,24 @@ bool isAbiRuntime() {
 
 using namespace facebook::jsi;
 
+namespace {
+
+// A runtime with the explicit microtask policy, in-process (V8DirectRuntime)
+// if direct. customize, if not null, sets further arguments.
+std::unique_ptr<Runtime> makeRuntime(
+    bool direct,
+    const std::function<void(v8runtime::V8RuntimeArgs &)> &customize =
+        nullptr) {
+  v8runtime::V8RuntimeArgs args;
+  args.flags.explicitMicrotaskPolicy = true;
+  args.flags.directRuntime = direct;
+  if (customize)
+    customize(args);
+  return v8runtime::makeV8Runtime(std::move(args));
+}
+
+} // namespace
+
 TEST(Basic, CreateOneRuntimes) {
   v8runtime::V8RuntimeArgs args;
   args.flags.enableInspector = false;  // Inspector disabled for now
@@ -248,6 +293,7 @@ class StubPreparedScriptStore final
       const facebook::jsi::JSRuntimeSignature & /*runtimeSignature*/,
       const char * /*prepareTag*/) noexcept override {
     ++loadCount;
+    lastLoadedVersion = scriptSignature.version;
     auto it = entries.find(makeKey(scriptSignature));
     if (it == entries.end())
       return nullptr;
@@ -267,9 +313,18 @@ class StubPreparedScriptStore final
     entries[makeKey(scriptMetadata)] = std::move(copy);
   }
 
+  // Overwrites the first byte of every entry, where V8 keeps the magic
+  // number of a code cache.
+  void corruptEntries() {
+    for (auto &entry : entries)
+      if (!entry.second.empty())
+        entry.second[0] ^= 0xff;
+  }
+
   int loadCount{0};
   int storeCount{0};
   size_t lastPersistedSize{0};
+  uint64_t lastLoadedVersion{0};
 
  private:
   static std::string makeKey(
@@ -331,6 +386,359 @@ TEST(JsiAbiScriptCache, LoadStoreRoundtrip) {
       << "persistPreparedScript must NOT be called on a cache hit";
 }
 
+// A code cache that V8 rejects is reported to the rejection listener and
+// replaced with a fresh one, which the next run consumes, whether the cache
+// is deserialized on the JS thread or on a worker.
+namespace {
+
+class RecordingRejectionListener final
+    : public v8runtime::PreparedScriptRejectionListener {
+ public:
+  void onPreparedScriptRejected(
+      const facebook::jsi::ScriptSignature &scriptSignature,
+      const facebook::jsi::JSRuntimeSignature & /*runtimeSignature*/,
+      const char * /*prepareTag*/,
+      v8runtime::PreparedScriptRejectReason reason) noexcept override {
+    ++rejectCount;
+    lastUrl = scriptSignature.url;
+    lastReason = reason;
+  }
+
+  int rejectCount{0};
+  std::string lastUrl;
+  v8runtime::PreparedScriptRejectReason lastReason{};
+};
+
+} // namespace
+
+TEST(JsiAbiScriptCache, RejectedCacheIsReportedAndReplaced) {
+  const std::string source = "var healed = 40 + 2; healed";
+  for (bool direct : {false, true}) {
+    for (bool background : {false, true}) {
+      auto store = std::make_shared<StubPreparedScriptStore>();
+      auto listener = std::make_shared<RecordingRejectionListener>();
+      auto run = [&] {
+        auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+          args.flags.backgroundCodeCache = background;
+          args.preparedScriptStore = store;
+          args.preparedScriptRejectionListener = listener;
+        });
+        auto prepared = rt->prepareJavaScript(
+            std::make_shared<StringBuffer>(source), "healed.js");
+        EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 42);
+      };
+
+      run();
+      EXPECT_EQ(store->storeCount, 1);
+
+      store->corruptEntries();
+      run();
+      EXPECT_EQ(listener->rejectCount, 1);
+      EXPECT_EQ(listener->lastUrl, "healed.js");
+      EXPECT_EQ(listener->lastReason,
+                v8runtime::PreparedScriptRejectReason::MagicNumberMismatch);
+      EXPECT_EQ(store->storeCount, 2);
+
+      run();
+      EXPECT_EQ(listener->rejectCount, 1);
+      EXPECT_EQ(store->storeCount, 2);
+    }
+  }
+}
+
+// MappedFileBuffer exposes a file's bytes from an offset on, and fails for a
+// missing file or an offset past its end.
+TEST(MappedFileBuffer, MapsFileFromOffset) {
+  const auto path =
+      std::filesystem::temp_directory_path() / "v8jsi_mapped_file_test.js";
+  { std::ofstream(path, std::ios::binary) << "header;6 * 7"; }
+
+  auto whole = v8runtime::MappedFileBuffer::open(path);
+  ASSERT_NE(whole, nullptr);
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(whole->data()),
+                        whole->size()),
+            "header;6 * 7");
+  auto tail = v8runtime::MappedFileBuffer::open(path, 7);
+  ASSERT_NE(tail, nullptr);
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(tail->data()),
+                        tail->size()),
+            "6 * 7");
+  EXPECT_EQ(v8runtime::MappedFileBuffer::open(path, 13), nullptr);
+  EXPECT_EQ(v8runtime::MappedFileBuffer::open(path.string() + ".missing"),
+            nullptr);
+
+  auto rt = makeV8Runtime(v8runtime::V8RuntimeArgs{});
+  EXPECT_EQ(rt->evaluateJavaScript(tail, "tail.js").getNumber(), 42);
+  whole.reset();
+  tail.reset();
+  rt.reset();
+  std::filesystem::remove(path);
+}
+
+// FilePreparedScriptStore hands back the bytes it persisted under exactly the
+// same key, deletes an entry that fails its checksum the first time a store
+// loads it, and trims to its size limit, least recently used first.
+TEST(FilePreparedScriptStore, PersistsVerifiesAndTrims) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "v8jsi_file_store_test";
+  std::filesystem::remove_all(dir);
+  const JSRuntimeSignature v8{"V8", 11};
+  auto payload = [](char fill) {
+    return std::make_shared<StringBuffer>(std::string(1000, fill));
+  };
+  auto load = [&](v8runtime::FilePreparedScriptStore &store, const char *url) {
+    return store.tryGetPreparedScript({url, 1}, v8, "perf");
+  };
+  auto ageEntries = [&] {
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+      std::filesystem::last_write_time(
+          entry.path(),
+          std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+  };
+
+  {
+    v8runtime::FilePreparedScriptStore store(dir);
+    store.persistPreparedScript(payload('a'), {"a.js", 1}, v8, "perf");
+    auto loaded = load(store, "a.js");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(loaded->data()),
+                          loaded->size()),
+              std::string(1000, 'a'));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(loaded->data()) % 16, 0u);
+    EXPECT_EQ(store.tryGetPreparedScript({"a.js", 2}, v8, "perf"), nullptr);
+    EXPECT_EQ(store.tryGetPreparedScript({"a.js", 1}, {"V8", 12}, "perf"),
+              nullptr);
+    EXPECT_EQ(store.tryGetPreparedScript({"a.js", 1}, v8, nullptr), nullptr);
+    loaded.reset();
+
+    for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+      std::fstream file(
+          entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(-1, std::ios::end);
+      file.put('b');
+    }
+    // The store wrote the entry, so it does not read the payload again.
+    EXPECT_NE(load(store, "a.js"), nullptr);
+    v8runtime::FilePreparedScriptStore nextRun(dir);
+    EXPECT_EQ(load(nextRun, "a.js"), nullptr);
+    EXPECT_EQ(nextRun.sizeOnDisk(), 0u);
+  }
+
+  {
+    v8runtime::FilePreparedScriptStore store(dir, 2500);
+    store.persistPreparedScript(payload('x'), {"x.js", 1}, v8, "perf");
+    store.persistPreparedScript(payload('y'), {"y.js", 1}, v8, "perf");
+    EXPECT_GT(store.sizeOnDisk(), 2000u);
+    ageEntries();
+    EXPECT_NE(load(store, "y.js"), nullptr);
+
+    store.persistPreparedScript(payload('z'), {"z.js", 1}, v8, "perf");
+    EXPECT_LE(store.sizeOnDisk(), 2500u);
+    EXPECT_EQ(load(store, "x.js"), nullptr);
+    EXPECT_NE(load(store, "y.js"), nullptr);
+    EXPECT_NE(load(store, "z.js"), nullptr);
+  }
+  std::filesystem::remove_all(dir);
+}
+
+// An entry that is still mapped can be replaced and evicted; the mapping keeps
+// the bytes it was opened with (on Windows the store moves the file aside).
+TEST(FilePreparedScriptStore, ReplacesAndEvictsMappedEntries) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "v8jsi_file_store_mapped_test";
+  std::filesystem::remove_all(dir);
+  const JSRuntimeSignature v8{"V8", 11};
+  auto payload = [](char fill) {
+    return std::make_shared<StringBuffer>(std::string(1000, fill));
+  };
+  auto text = [](const std::shared_ptr<const Buffer> &buffer) {
+    return std::string(reinterpret_cast<const char *>(buffer->data()),
+                       buffer->size());
+  };
+  {
+    v8runtime::FilePreparedScriptStore store(dir, 2500);
+    store.persistPreparedScript(payload('a'), {"a.js", 1}, v8, "perf");
+    auto first = store.tryGetPreparedScript({"a.js", 1}, v8, "perf");
+    ASSERT_NE(first, nullptr);
+
+    store.persistPreparedScript(payload('b'), {"a.js", 1}, v8, "perf");
+    auto second = store.tryGetPreparedScript({"a.js", 1}, v8, "perf");
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(text(first), std::string(1000, 'a'));
+    EXPECT_EQ(text(second), std::string(1000, 'b'));
+
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+      std::filesystem::last_write_time(
+          entry.path(),
+          std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    store.persistPreparedScript(payload('x'), {"x.js", 1}, v8, "perf");
+    store.persistPreparedScript(payload('y'), {"y.js", 1}, v8, "perf");
+    EXPECT_LE(store.sizeOnDisk(), 2500u);
+    EXPECT_EQ(store.tryGetPreparedScript({"a.js", 1}, v8, "perf"), nullptr);
+    EXPECT_EQ(text(second), std::string(1000, 'b'));
+  }
+  std::filesystem::remove_all(dir);
+}
+
+// Scripts loaded by URL from a ScriptStore use the store's version as the
+// code cache key, through both the ABI-wrapped and the direct runtime.
+namespace {
+
+class StubScriptStore final : public facebook::jsi::ScriptStore {
+ public:
+  facebook::jsi::VersionedBuffer getVersionedScript(
+      const std::string &url) noexcept override {
+    if (url != "app.js")
+      return {nullptr, 0};
+    return {std::make_shared<facebook::jsi::StringBuffer>("6 * 7"), 7};
+  }
+
+  facebook::jsi::ScriptVersion_t getScriptVersion(
+      const std::string &url) noexcept override {
+    return url == "app.js" ? 7 : 0;
+  }
+};
+
+} // namespace
+
+TEST(JsiAbiScriptStore, EvaluateByUrlKeysCacheOnVersion) {
+  for (bool direct : {false, true}) {
+    auto cache = std::make_shared<StubPreparedScriptStore>();
+    for (int run = 0; run < 2; ++run) {
+      auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+        args.preparedScriptStore = cache;
+        args.scriptStore = std::make_shared<StubScriptStore>();
+      });
+
+      EXPECT_EQ(
+          jsi::abi::evaluateJavaScriptFromStore(*rt, "app.js").getNumber(),
+          42);
+      EXPECT_EQ(cache->lastLoadedVersion, 7u);
+      EXPECT_THROW(
+          jsi::abi::evaluateJavaScriptFromStore(*rt, "missing.js"),
+          facebook::jsi::JSINativeException);
+    }
+    EXPECT_EQ(cache->loadCount, 2);
+    EXPECT_EQ(cache->storeCount, 1);
+  }
+
+  // Without a ScriptStore the runtime reports an error.
+  auto rt = ::jsi::abi::makeJsiAbiRuntime(&v8_create_runtime);
+  EXPECT_THROW(
+      jsi::abi::evaluateJavaScriptFromStore(*rt, "app.js"),
+      facebook::jsi::JSINativeException);
+}
+
+namespace {
+
+// Foreground task runner that queues tasks for the test thread to run, like a
+// real JS thread's message loop.
+class QueueTaskRunner final : public v8runtime::JSITaskRunner {
+ public:
+  void postTask(std::unique_ptr<v8runtime::JSITask> task) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    posted_.notify_one();
+  }
+
+  // Time spent running tasks, i.e. JS thread time.
+  std::chrono::steady_clock::duration busy{};
+
+  // Runs posted tasks on the calling thread until done() holds. Returns false
+  // if no task arrives for ten seconds.
+  bool runUntil(const std::function<bool()> &done) {
+    while (!done()) {
+      std::unique_ptr<v8runtime::JSITask> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!posted_.wait_for(lock, std::chrono::seconds(10), [this] {
+              return !tasks_.empty();
+            }))
+          return false;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      auto start = std::chrono::steady_clock::now();
+      task->run();
+      busy += std::chrono::steady_clock::now() - start;
+    }
+    return true;
+  }
+
+  // Runs the tasks posted so far on the calling thread.
+  void runPending() {
+    std::deque<std::unique_ptr<v8runtime::JSITask>> tasks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks.swap(tasks_);
+    }
+    for (auto &task : tasks)
+      task->run();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable posted_;
+  std::deque<std::unique_ptr<v8runtime::JSITask>> tasks_;
+};
+
+
+class CountingScriptStore final : public facebook::jsi::ScriptStore {
+ public:
+  facebook::jsi::VersionedBuffer getVersionedScript(
+      const std::string & /*url*/) noexcept override {
+    ++loads;
+    return {std::make_shared<facebook::jsi::StringBuffer>(
+                "function answer() { return 6 * 7; } answer"),
+            3};
+  }
+
+  facebook::jsi::ScriptVersion_t getScriptVersion(
+      const std::string & /*url*/) noexcept override {
+    return 3;
+  }
+
+  std::atomic<int> loads{0};
+};
+
+} // namespace
+
+// With lazyScriptSource, a versioned script from the store drops its source
+// once compiled; each time V8 reads the source again (here, to compile answer
+// lazily and for toString) it is loaded from the store again, and a task on
+// the foreground runner drops it again once V8 is done.
+TEST(JsiAbiScriptStore, LazySourceIsLoadedAgainOnDemand) {
+  for (bool direct : {false, true}) {
+    auto store = std::make_shared<CountingScriptStore>();
+    auto queue = std::make_shared<QueueTaskRunner>();
+    auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+      args.flags.lazyScriptSource = true;
+      args.scriptStore = store;
+      args.foreground_task_runner = queue;
+    });
+
+    auto answer = jsi::abi::evaluateJavaScriptFromStore(*rt, "lazy.js")
+                      .asObject(*rt)
+                      .asFunction(*rt);
+    EXPECT_EQ(store->loads, 1);
+
+    EXPECT_EQ(answer.call(*rt).getNumber(), 42);
+    EXPECT_EQ(store->loads, 2);
+    queue->runPending();
+    auto toString = rt->global()
+                        .getPropertyAsObject(*rt, "Function")
+                        .getPropertyAsObject(*rt, "prototype")
+                        .getPropertyAsFunction(*rt, "toString");
+    EXPECT_EQ(toString.callWithThis(*rt, answer).getString(*rt).utf8(*rt),
+              "function answer() { return 6 * 7; }");
+    EXPECT_EQ(store->loads, 3);
+    queue->runPending();
+    EXPECT_EQ(toString.callWithThis(*rt, answer).getString(*rt).utf8(*rt),
+              "function answer() { return 6 * 7; }");
+    EXPECT_EQ(store->loads, 4);
+  }
+}
+
 // lifecycle + post-task test. Confirms:
 //   1. A foreground_task_runner supplied via V8RuntimeArgs reaches the runtime.
 //   2. Posting a task through the foreground runner round-trips through both
@@ -611,6 +1019,1042 @@ TEST(JsiAbiQueryInterface, UnknownIidReturnsError) {
   rt->vt->release(rt);
 }
 
+// A source buffer without a release callback may be freed as soon as
+// evaluate_javascript_source returns, so the runtime must not keep reading
+// it: overwriting the bytes afterwards leaves the function's text intact.
+TEST(JsiAbiScriptSource, BufferWithoutReleaseIsCopied) {
+  jsi_runtime *rt = v8_create_runtime(JSI_ABI_VERSION, nullptr, nullptr);
+  ASSERT_NE(rt, nullptr);
+  const jsi_runtime_vtable *vt = rt->vt;
+  auto evaluate = [&](std::string &source) {
+    static const jsi_buffer_vtable unowned{/*release:*/ nullptr};
+    jsi_buffer buf{
+        &unowned, reinterpret_cast<const uint8_t *>(source.data()),
+        source.size()};
+    jsi_value_or_error result =
+        vt->evaluate_javascript_source(rt, &buf, "src.js", 6);
+    EXPECT_FALSE(::jsi::abi::is_error(result));
+    return ::jsi::abi::get_value(result);
+  };
+
+  std::string source = "var f = function f() { return 'original'; };";
+  evaluate(source);
+  std::fill(source.begin(), source.end(), ' ');
+
+  std::string check =
+      "f.toString() === \"function f() { return 'original'; }\"";
+  jsi_value same = evaluate(check);
+  ASSERT_TRUE(::jsi::abi::is_bool_value(same));
+  EXPECT_TRUE(::jsi::abi::get_bool_value(same));
+
+  rt->vt->release(rt);
+}
+
+// handle-scope test. Pointers created inside push_scope/pop_scope are tracked
+// by a per-scope frame. Confirms that scopes nest, that a pointer which outlives
+// its scope stays usable until invalidated, and that out-of-order pops are
+// rejected with jsi_error_native.
+TEST(JsiAbiScope, NestedScopesAndEscapingHandles) {
+  jsi_runtime *rt = v8_create_runtime(JSI_ABI_VERSION, nullptr, nullptr);
+  ASSERT_NE(rt, nullptr);
+  const jsi_runtime_vtable *vt = rt->vt;
+
+  auto makeName = [&](const char *text) {
+    jsi_propnameid_or_error r = vt->create_propnameid_from_utf8(
+        rt, reinterpret_cast<const uint8_t *>(text), std::strlen(text));
+    EXPECT_FALSE(::jsi::abi::is_error(r));
+    return ::jsi::abi::get_propnameid(r);
+  };
+
+  void *outer = nullptr;
+  ASSERT_EQ(vt->push_scope(rt, &outer), jsi_no_error);
+  jsi_propnameid escaped = makeName("escaped");
+
+  void *inner = nullptr;
+  ASSERT_EQ(vt->push_scope(rt, &inner), jsi_no_error);
+  for (int i = 0; i < 1000; ++i) {
+    jsi_propnameid temp = makeName("temp");
+    temp.pointer->vtable->invalidate(temp.pointer);
+  }
+  jsi_propnameid innerName = makeName("escaped");
+
+  // Popping the outer scope while the inner one is open is out of order.
+  EXPECT_EQ(vt->pop_scope(rt, outer), jsi_error_native);
+  EXPECT_EQ(vt->pop_scope(rt, inner), jsi_no_error);
+  EXPECT_EQ(vt->pop_scope(rt, outer), jsi_no_error);
+
+  // Both names outlived their scopes and are still valid.
+  EXPECT_TRUE(vt->prop_name_id_equals(rt, escaped, innerName));
+  innerName.pointer->vtable->invalidate(innerName.pointer);
+  escaped.pointer->vtable->invalidate(escaped.pointer);
+
+  // No scope is open anymore.
+  EXPECT_EQ(vt->pop_scope(rt, nullptr), jsi_error_native);
+
+  rt->vt->release(rt);
+}
+
+// A scope that keeps creating and invalidating pointers cycles through the
+// same slots instead of growing the pool, and a later scope at the same depth
+// reuses the frame of an earlier one.
+TEST(JsiAbiScope, ChurnInsideAScopeReusesSlots) {
+  jsi_runtime *rt = v8_create_runtime(JSI_ABI_VERSION, nullptr, nullptr);
+  ASSERT_NE(rt, nullptr);
+  const jsi_runtime_vtable *vt = rt->vt;
+
+  void *first = nullptr;
+  ASSERT_EQ(vt->push_scope(rt, &first), jsi_no_error);
+  v8_jsi_handle_stats base{};
+  v8_jsi_get_handle_stats(rt, &base);
+  for (int i = 0; i < 100000; ++i) {
+    jsi_string_or_error r = vt->create_string_from_utf8(
+        rt, reinterpret_cast<const uint8_t *>("temp"), 4);
+    ASSERT_FALSE(::jsi::abi::is_error(r));
+    jsi_string temp = ::jsi::abi::get_string(r);
+    temp.pointer->vtable->invalidate(temp.pointer);
+  }
+  v8_jsi_handle_stats after{};
+  v8_jsi_get_handle_stats(rt, &after);
+  EXPECT_EQ(after.live_handles, base.live_handles);
+  EXPECT_LE(after.pool_slabs, base.pool_slabs + 1);
+  EXPECT_EQ(vt->pop_scope(rt, first), jsi_no_error);
+
+  void *second = nullptr;
+  ASSERT_EQ(vt->push_scope(rt, &second), jsi_no_error);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(vt->pop_scope(rt, second), jsi_no_error);
+
+  rt->vt->release(rt);
+}
+
+// handle-pool counters. Wrappers are recycled through the runtime's slab
+// pool, so live returns to the baseline after invalidation while peak keeps
+// the high-water mark, and reusing freed slots does not grow the pool.
+TEST(JsiAbiHandleStats, LiveAndPeakTrackPoolTraffic) {
+  jsi_runtime *rt = v8_create_runtime(JSI_ABI_VERSION, nullptr, nullptr);
+  ASSERT_NE(rt, nullptr);
+  const jsi_runtime_vtable *vt = rt->vt;
+
+  v8_jsi_handle_stats base{};
+  v8_jsi_get_handle_stats(rt, &base);
+
+  constexpr size_t kCount = 1000;
+  std::vector<jsi_string> strings;
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < kCount; ++i) {
+      jsi_string_or_error r = vt->create_string_from_utf8(
+          rt, reinterpret_cast<const uint8_t *>("pooled"), 6);
+      ASSERT_FALSE(::jsi::abi::is_error(r));
+      strings.push_back(::jsi::abi::get_string(r));
+    }
+
+    v8_jsi_handle_stats stats{};
+    v8_jsi_get_handle_stats(rt, &stats);
+    EXPECT_EQ(stats.live_handles, base.live_handles + kCount);
+    EXPECT_GE(stats.peak_handles, stats.live_handles);
+    EXPECT_GE(stats.pool_slabs * stats.pool_slots_per_slab, kCount);
+
+    for (jsi_string s : strings)
+      s.pointer->vtable->invalidate(s.pointer);
+    strings.clear();
+  }
+
+  v8_jsi_handle_stats after{};
+  v8_jsi_get_handle_stats(rt, &after);
+  EXPECT_EQ(after.live_handles, base.live_handles);
+  EXPECT_GE(after.peak_handles, base.live_handles + kCount);
+  // The second round reused the slots freed by the first one.
+  EXPECT_LE(after.pool_slabs * after.pool_slots_per_slab,
+            base.pool_slabs * base.pool_slots_per_slab + kCount +
+                after.pool_slots_per_slab);
+
+  rt->vt->release(rt);
+}
+
+// Repeated property names are served from the runtime's intern table: the
+// first creation misses, later ones hit and return the same internalized
+// string.
+TEST(JsiAbiPropNameCache, RepeatedNamesHitTheInternTable) {
+  jsi_runtime *rt = v8_create_runtime(JSI_ABI_VERSION, nullptr, nullptr);
+  ASSERT_NE(rt, nullptr);
+  const jsi_runtime_vtable *vt = rt->vt;
+  auto create = [&](const char *name) {
+    jsi_propnameid_or_error r = vt->create_propnameid_from_utf8(
+        rt, reinterpret_cast<const uint8_t *>(name), std::strlen(name));
+    EXPECT_FALSE(::jsi::abi::is_error(r));
+    return ::jsi::abi::get_propnameid(r);
+  };
+
+  v8_jsi_propname_cache_stats base{};
+  v8_jsi_get_propname_cache_stats(rt, &base);
+  EXPECT_GT(base.capacity, 0u);
+
+  jsi_propnameid first = create("interned");
+  jsi_propnameid second = create("interned");
+  jsi_propnameid other = create("another");
+
+  v8_jsi_propname_cache_stats stats{};
+  v8_jsi_get_propname_cache_stats(rt, &stats);
+  EXPECT_EQ(stats.hits, base.hits + 1);
+  EXPECT_EQ(stats.misses, base.misses + 2);
+
+  EXPECT_TRUE(vt->prop_name_id_equals(rt, first, second));
+  EXPECT_FALSE(vt->prop_name_id_equals(rt, first, other));
+
+  for (jsi_propnameid id : {first, second, other})
+    id.pointer->vtable->invalidate(id.pointer);
+  rt->vt->release(rt);
+}
+
+namespace {
+
+// Average wall-clock cost of one call to op, in nanoseconds. Used by the
+// DISABLED_ benchmarks below; run them with --gtest_also_run_disabled_tests.
+double measureNsPerOp(size_t iterations, const std::function<void()> &op) {
+  for (size_t i = 0; i < iterations / 10; ++i)
+    op();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    op();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+      static_cast<double>(iterations);
+}
+
+} // namespace
+
+// flags.directRuntime hands out the in-process runtime, which still shares
+// script evaluation with the ABI runtime underneath and reports the same
+// host function errors.
+TEST(V8DirectRuntime, HostFunctionRoundtripAndErrors) {
+  auto rt = makeRuntime(/*direct:*/ true);
+  EXPECT_EQ(rt->evaluateJavaScript(std::make_shared<StringBuffer>("6 * 7"), "")
+                .getNumber(),
+            42);
+
+  Function add = Function::createFromHostFunction(
+      *rt, PropNameID::forAscii(*rt, "add"), 2,
+      [](Runtime &, const Value &, const Value *args, size_t count) {
+        return Value(args[0].getNumber() + args[count - 1].getNumber());
+      });
+  Function fail = Function::createFromHostFunction(
+      *rt, PropNameID::forAscii(*rt, "fail"), 0,
+      [](Runtime &, const Value &, const Value *, size_t) -> Value {
+        throw std::runtime_error("boom");
+      });
+  rt->global().setProperty(*rt, "add", add);
+  rt->global().setProperty(*rt, "fail", fail);
+
+  EXPECT_EQ(
+      rt->evaluateJavaScript(std::make_shared<StringBuffer>("add(40, 2)"), "")
+          .getNumber(),
+      42);
+  EXPECT_TRUE(add.isHostFunction(*rt));
+  try {
+    rt->evaluateJavaScript(std::make_shared<StringBuffer>("fail()"), "");
+    FAIL() << "expected a JSError";
+  } catch (const JSError &e) {
+    EXPECT_NE(
+        e.getMessage().find("Exception in HostFunction: boom"),
+        std::string::npos)
+        << e.getMessage();
+  }
+}
+
+// Host object trackers are unlinked as their objects are collected, so the
+// count in getHeapInfo follows the live objects rather than every object the
+// runtime ever created.
+TEST(V8DirectRuntime, HostObjectTrackersArePrunedByGC) {
+  auto rt = makeRuntime(/*direct:*/ true);
+  Instrumentation &instrumentation = rt->instrumentation();
+  auto trackers = [&] {
+    return instrumentation.getHeapInfo(false).at("hostObjectTrackers");
+  };
+  int64_t base = trackers();
+
+  constexpr int64_t kCount = 1000;
+  {
+    std::vector<Object> objects;
+    for (int64_t i = 0; i < kCount; ++i)
+      objects.push_back(
+          Object::createFromHostObject(*rt, std::make_shared<HostObject>()));
+    EXPECT_EQ(trackers(), base + kCount);
+  }
+
+  instrumentation.collectGarbage("test");
+  EXPECT_LT(trackers(), base + kCount);
+}
+
+// External memory is a per-object amount: a later call replaces it, zero
+// detaches it, and collecting the object returns it.
+TEST(V8DirectRuntime, ExternalMemoryPressureIsTrackedPerObject) {
+  auto rt = makeRuntime(/*direct:*/ true);
+  Instrumentation &instrumentation = rt->instrumentation();
+  auto heapInfo = [&](const char *key) {
+    return instrumentation.getHeapInfo(false).at(key);
+  };
+
+  Object buffer(*rt);
+  buffer.setExternalMemoryPressure(*rt, 1000);
+  buffer.setExternalMemoryPressure(*rt, 400);
+  EXPECT_EQ(heapInfo("externalMemoryBytes"), 400);
+  EXPECT_EQ(heapInfo("externalMemoryObjects"), 1);
+  buffer.setExternalMemoryPressure(*rt, 0);
+  EXPECT_EQ(heapInfo("externalMemoryBytes"), 0);
+  EXPECT_EQ(heapInfo("externalMemoryObjects"), 0);
+
+  constexpr int64_t kCount = 100;
+  constexpr size_t kBytes = 1 << 20;
+  {
+    std::vector<Object> images;
+    for (int64_t i = 0; i < kCount; ++i) {
+      images.emplace_back(*rt);
+      images.back().setExternalMemoryPressure(*rt, kBytes);
+    }
+    EXPECT_EQ(heapInfo("externalMemoryBytes"), kCount * int64_t{kBytes});
+  }
+
+  instrumentation.collectGarbage("test");
+  EXPECT_LT(heapInfo("externalMemoryObjects"), kCount);
+  EXPECT_LT(heapInfo("externalMemoryBytes"), kCount * int64_t{kBytes});
+}
+
+// Collecting an object returns its external memory from the second weak
+// callback pass, on the ABI-wrapped runtime as on the in-process one.
+namespace {
+
+struct ExternalMemoryImage : HostObject {
+  explicit ExternalMemoryImage(std::shared_ptr<int> freed)
+      : freed(std::move(freed)) {}
+  ~ExternalMemoryImage() override {
+    ++*freed;
+  }
+  std::shared_ptr<int> freed;
+};
+
+constexpr int kExternalMemoryImages = 100;
+constexpr size_t kExternalMemoryImageBytes = 1 << 20;
+
+// Attaches external memory to kExternalMemoryImages host objects, drops them
+// and collects. Returns the number of images freed.
+int collectExternalMemoryImages(Runtime &rt) {
+  auto freed = std::make_shared<int>(0);
+  {
+    std::vector<Object> images;
+    for (int i = 0; i < kExternalMemoryImages; ++i) {
+      images.push_back(Object::createFromHostObject(
+          rt, std::make_shared<ExternalMemoryImage>(freed)));
+      images.back().setExternalMemoryPressure(rt, kExternalMemoryImageBytes);
+    }
+  }
+  rt.global().getPropertyAsFunction(rt, "gc").call(rt);
+  return *freed;
+}
+
+} // namespace
+
+TEST(V8JsiRuntime, ExternalMemoryPressureIsReleasedOnCollection) {
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    EXPECT_GT(collectExternalMemoryImages(*rt), 0);
+
+    // The table still accepts new objects after a collection.
+    Object survivor(*rt);
+    survivor.setExternalMemoryPressure(*rt, kExternalMemoryImageBytes);
+    survivor.setExternalMemoryPressure(*rt, 0);
+  }
+}
+
+// V8DirectRuntime reports the external memory table through getHeapInfo.
+TEST(V8DirectRuntime, ExternalMemoryTableShrinksOnCollection) {
+  std::shared_ptr<Runtime> rt = runtimeGenerators()[kInProcessRuntimeIndex]();
+  EXPECT_GT(collectExternalMemoryImages(*rt), 0);
+
+  auto heapInfo = rt->instrumentation().getHeapInfo(false);
+  ASSERT_EQ(heapInfo.count("externalMemoryObjects"), 1u);
+  ASSERT_EQ(heapInfo.count("externalMemoryBytes"), 1u);
+  EXPECT_LT(heapInfo.at("externalMemoryObjects"), kExternalMemoryImages);
+  EXPECT_LT(heapInfo.at("externalMemoryBytes"),
+            kExternalMemoryImages * int64_t{kExternalMemoryImageBytes});
+}
+
+// Preparing a buffer that is still wrapped in place reuses its hash; a copy
+// of the same bytes is hashed again (in parallel, at this size) and yields
+// the same code cache key.
+TEST(V8DirectRuntime, SourceHashCacheSkipsRehashingLiveBuffers) {
+  auto store = std::make_shared<StubPreparedScriptStore>();
+  auto rt =
+      makeRuntime(/*direct:*/ true, [&](v8runtime::V8RuntimeArgs &args) {
+        args.preparedScriptStore = store;
+      });
+  auto heapInfo = [&](const char *key) {
+    return rt->instrumentation().getHeapInfo(false).at(key);
+  };
+
+  const std::string source =
+      "/*" + std::string(5 << 20, 'x') + "*/ 6 * 7";
+  auto buffer = std::make_shared<StringBuffer>(source);
+  auto first = rt->prepareJavaScript(buffer, "bundle.js");
+  auto second = rt->prepareJavaScript(buffer, "bundle.js");
+  EXPECT_EQ(heapInfo("sourceHashCacheMisses"), 1);
+  EXPECT_EQ(heapInfo("sourceHashCacheHits"), 1);
+
+  auto copy = rt->prepareJavaScript(
+      std::make_shared<StringBuffer>(source), "bundle.js");
+  EXPECT_EQ(heapInfo("sourceHashCacheMisses"), 2);
+  EXPECT_EQ(store->loadCount, 3);
+  EXPECT_EQ(store->storeCount, 1);
+
+  for (const auto &prepared : {first, second, copy})
+    EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 42);
+}
+
+// A source prepared again under the same URL reuses the script compiled the
+// first time, without a code cache load; a changed source or a source larger
+// than the cache is compiled again.
+TEST(V8DirectRuntime, CompiledScriptCacheReusesScripts) {
+  for (size_t maxBytes : {size_t{1} << 20, size_t{4}}) {
+    auto store = std::make_shared<StubPreparedScriptStore>();
+    auto rt =
+        makeRuntime(/*direct:*/ true, [&](v8runtime::V8RuntimeArgs &args) {
+          args.preparedScriptStore = store;
+          args.compiledScriptCacheBytes = maxBytes;
+        });
+    auto heapInfo = [&](const char *key) {
+      return rt->instrumentation().getHeapInfo(false).at(key);
+    };
+    const bool cached = maxBytes > 4;
+
+    auto first = rt->prepareJavaScript(
+        std::make_shared<StringBuffer>("var calls = (globalThis.calls | 0) + 1;"
+                                       " globalThis.calls = calls; calls"),
+        "module.js");
+    auto second = rt->prepareJavaScript(
+        std::make_shared<StringBuffer>("var calls = (globalThis.calls | 0) + 1;"
+                                       " globalThis.calls = calls; calls"),
+        "module.js");
+    EXPECT_EQ(store->loadCount, cached ? 1 : 2);
+    EXPECT_EQ(heapInfo("compiledScriptCacheHits"), cached ? 1 : 0);
+    EXPECT_EQ(heapInfo("compiledScriptCacheBytes"), cached ? 71 : 0);
+
+    // Each evaluation binds the script to the context and runs it again.
+    EXPECT_EQ(rt->evaluatePreparedJavaScript(first).getNumber(), 1);
+    EXPECT_EQ(rt->evaluatePreparedJavaScript(second).getNumber(), 2);
+    EXPECT_EQ(rt->evaluatePreparedJavaScript(first).getNumber(), 3);
+
+    auto changed = rt->prepareJavaScript(
+        std::make_shared<StringBuffer>("6 * 7"), "module.js");
+    EXPECT_EQ(store->loadCount, cached ? 2 : 3);
+    EXPECT_EQ(rt->evaluatePreparedJavaScript(changed).getNumber(), 42);
+    EXPECT_EQ(store->storeCount, 2);
+  }
+}
+
+// Element accesses on an IndexedHostObject reach getIndex/setIndex with the
+// integer key; the named get/set never see the stringified index.
+TEST(IndexedHostObject, IntegerKeysBypassNamedAccessors) {
+  class Vector : public ::jsi::abi::IndexedHostObject {
+   public:
+    std::vector<double> items{1, 2, 3, 4};
+    size_t namedGets{0};
+    std::string lastNamedGet;
+
+    Value get(Runtime &rt, const PropNameID &name) override {
+      ++namedGets;
+      lastNamedGet = name.utf8(rt);
+      if (lastNamedGet == "length")
+        return Value(static_cast<double>(items.size()));
+      return Value::undefined();
+    }
+    Value getIndex(Runtime &, uint32_t index) override {
+      return index < items.size() ? Value(items[index]) : Value::undefined();
+    }
+    void setIndex(Runtime &, uint32_t index, const Value &value) override {
+      if (index >= items.size())
+        throw std::out_of_range("index out of range");
+      items[index] = value.getNumber();
+    }
+    uint32_t length(Runtime &) override {
+      return static_cast<uint32_t>(items.size());
+    }
+  };
+
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    auto vec = std::make_shared<Vector>();
+    rt->global().setProperty(
+        *rt, "vec", ::jsi::abi::createIndexedHostObject(*rt, vec));
+
+    Value sum = rt->evaluateJavaScript(
+        std::make_shared<StringBuffer>(
+            "vec[1] = 20;"
+            "let s = 0; for (let i = 0; i < vec.length; ++i) s += vec[i];"
+            "s + Object.keys(vec).length"),
+        "");
+    EXPECT_EQ(sum.getNumber(), 1 + 20 + 3 + 4 + 4);
+    EXPECT_EQ(vec->items[1], 20);
+    EXPECT_EQ(vec->lastNamedGet, "length");
+    EXPECT_EQ(vec->namedGets, 5u);
+
+    EXPECT_THROW(
+        rt->evaluateJavaScript(
+            std::make_shared<StringBuffer>("vec[10] = 1"), ""),
+        JSError);
+    EXPECT_EQ(
+        std::static_pointer_cast<Vector>(
+            rt->global().getPropertyAsObject(*rt, "vec").getHostObject(*rt)),
+        vec);
+  }
+}
+
+// A PreparedCall reuses one argument frame: slots keep their values between
+// calls and the pinned receiver is passed as `this`.
+TEST(PreparedCall, ReusesFrameAcrossCalls) {
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    Object target = rt->evaluateJavaScript(
+                          std::make_shared<StringBuffer>(
+                              "({ base: 100, add(a, b, c) {"
+                              "  return this.base + a + b + (c ?? 0); } })"),
+                          "")
+                        .getObject(*rt);
+    Function add = target.getPropertyAsFunction(*rt, "add");
+
+    ::jsi::abi::PreparedCall call(*rt, std::move(add), std::move(target), 3);
+    EXPECT_EQ(call.argCount(), 3u);
+    EXPECT_EQ(call(1, 2, 3).getNumber(), 106);
+    EXPECT_EQ(call(10).getNumber(), 115);
+    call.arg(2) = Value(1000);
+    EXPECT_EQ(call.call().getNumber(), 1112);
+    EXPECT_THROW(call(1, 2, 3, 4), JSINativeException);
+    EXPECT_THROW(call.arg(3), std::out_of_range);
+
+    call.clearArgs();
+    EXPECT_TRUE(call.arg(0).isUndefined());
+
+    // The receiver is undefined: strict code sees it as is, where sloppy code
+    // would see the global object.
+    Function sum = rt->evaluateJavaScript(
+                         std::make_shared<StringBuffer>(
+                             "'use strict'; (function(...args) {"
+                             "  return this === undefined ? args.length : -1; })"),
+                         "")
+                       .getObject(*rt)
+                       .getFunction(*rt);
+    ::jsi::abi::PreparedCall unbound(*rt, std::move(sum), 12);
+    EXPECT_EQ(unbound.call().getNumber(), 12);
+  }
+}
+
+// getStringData / getPropNameIdData hand out the string's own storage: pure
+// ASCII arrives as ASCII chunks, and Latin-1 or two-byte content as UTF-16.
+TEST(StringData, ChunksReassembleToUtf16) {
+  struct Collected {
+    std::u16string text;
+    size_t chunks{0};
+    bool nonAsciiInAsciiChunk{false};
+  };
+  auto collect = [](Collected &out) {
+    return [&out](bool ascii, const void *data, size_t num) {
+      ++out.chunks;
+      if (ascii) {
+        auto *chars = static_cast<const char *>(data);
+        for (size_t i = 0; i < num; ++i) {
+          out.nonAsciiInAsciiChunk |= static_cast<unsigned char>(chars[i]) > 0x7f;
+          out.text.push_back(static_cast<char16_t>(chars[i]));
+        }
+      } else {
+        out.text.append(static_cast<const char16_t *>(data), num);
+      }
+    };
+  };
+
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    for (const char *source :
+         {"''", "'plain ascii'", "'caf\\u00e9 cr\\u00e8me'", "'\\u65e5\\u672c'",
+          "'x'.repeat(300) + '\\u00ff'.repeat(300)"}) {
+      String str = rt->evaluateJavaScript(
+                         std::make_shared<StringBuffer>(source), "")
+                       .getString(*rt);
+      Collected data;
+      auto cb = collect(data);
+      str.getStringData(*rt, cb);
+      EXPECT_EQ(data.text, str.utf16(*rt)) << source;
+      EXPECT_GE(data.chunks, 1u) << source;
+      EXPECT_FALSE(data.nonAsciiInAsciiChunk) << source;
+    }
+
+    Collected name;
+    auto cb = collect(name);
+    PropNameID::forUtf8(*rt, "na\xc3\xafve").getPropNameIdData(*rt, cb);
+    EXPECT_EQ(name.text, u"naïve");
+  }
+}
+
+// UTF-8 conversions agree with JS for one-byte, two-byte and astral strings;
+// lone surrogates come out as U+FFFD.
+TEST(StringTranscoding, Utf8RoundTrip) {
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    auto evalString = [&](const char *source) {
+      return rt->evaluateJavaScript(std::make_shared<StringBuffer>(source), "")
+          .getString(*rt)
+          .utf8(*rt);
+    };
+    EXPECT_EQ(evalString("''"), "");
+    EXPECT_EQ(evalString("'ascii'"), "ascii");
+    EXPECT_EQ(evalString("'caf\\u00e9'"), "caf\xc3\xa9");
+    EXPECT_EQ(evalString("'\\u65e5\\u672c'"), "\xe6\x97\xa5\xe6\x9c\xac");
+    EXPECT_EQ(evalString("'\\u{1F600}'"), "\xf0\x9f\x98\x80");
+    EXPECT_EQ(evalString("'a\\uD800b'"), "a\xef\xbf\xbd" "b");
+    EXPECT_EQ(evalString("'x'.repeat(100000)"), std::string(100000, 'x'));
+
+    rt->global().setProperty(
+        *rt, "plain", String::createFromUtf8(*rt, std::string("plain")));
+    rt->global().setProperty(
+        *rt, "accented", String::createFromUtf8(*rt, std::string("\xc3\xa9t\xc3\xa9")));
+    EXPECT_TRUE(rt->evaluateJavaScript(
+                      std::make_shared<StringBuffer>(
+                          "plain === 'plain' && accented === '\\u00e9t\\u00e9'"),
+                      "")
+                    .getBool());
+  }
+}
+
+// Script sources with raw (unescaped) Latin-1 and CJK characters evaluate the
+// same whether run directly or prepared first, and their text survives
+// Function.prototype.toString.
+TEST(StringTranscoding, NonAsciiScriptSources) {
+  const std::string latin1 = "(function f() { return 'caf\xc3\xa9'; })";
+  const std::string twoByte = "(function g() { return '\xe6\x97\xa5\xe6\x9c\xac'; })";
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    std::shared_ptr<Runtime> rt = factory();
+    for (const std::string &source : {latin1, twoByte}) {
+      Function fn = rt->evaluateJavaScript(std::make_shared<StringBuffer>(source), "src.js")
+                        .getObject(*rt)
+                        .getFunction(*rt);
+      std::string expected = source.substr(source.find('\'') + 1);
+      expected = expected.substr(0, expected.find('\''));
+      EXPECT_EQ(fn.call(*rt).getString(*rt).utf8(*rt), expected);
+
+      auto prepared = rt->prepareJavaScript(std::make_shared<StringBuffer>(source), "prepared.js");
+      Function preparedFn = rt->evaluatePreparedJavaScript(prepared).getObject(*rt).getFunction(*rt);
+      EXPECT_EQ(preparedFn.call(*rt).getString(*rt).utf8(*rt), expected);
+
+      Function toString = rt->global()
+                              .getPropertyAsObject(*rt, "Function")
+                              .getPropertyAsObject(*rt, "prototype")
+                              .getPropertyAsFunction(*rt, "toString");
+      EXPECT_EQ(toString.callWithThis(*rt, preparedFn).getString(*rt).utf8(*rt), source.substr(1, source.size() - 2));
+    }
+  }
+}
+
+namespace {
+
+// A script of about size bytes of top-level functions whose completion value
+// is the sum of the first ten, 45.
+std::string makeBundle(size_t size) {
+  std::string source;
+  for (size_t i = 0; source.size() < size; ++i)
+    source += "function f" + std::to_string(i) + "(a, b) { var s = a; " +
+        "for (var j = 0; j < b; ++j) s += j * " + std::to_string(i) +
+        "; return s + " + std::to_string(i) + "; }\n";
+  return source + "f0(0, 0) + f1(0, 0) + f2(0, 0) + f3(0, 0) + f4(0, 0) + " +
+      "f5(0, 0) + f6(0, 0) + f7(0, 0) + f8(0, 0) + f9(0, 0)";
+}
+
+} // namespace
+
+// prepareJavaScriptAsync returns before the script is compiled and calls back
+// from the foreground task runner, for sources parsed on a worker thread and
+// for small ones compiled on the JS thread alike. Syntax errors arrive as
+// JSError; a runtime destroyed mid-parse drops the callback.
+TEST(AsyncPrepare, CompletesOnForegroundTaskRunner) {
+  const std::string bundle = makeBundle(1 << 20);
+  struct Case {
+    std::string source;
+    bool valid;
+  };
+  const Case cases[] = {
+      {bundle, true},
+      {"40 + 5", true},
+      {bundle + "\n}(", false},
+      {"}(", false},
+  };
+
+  for (bool direct : {false, true}) {
+    auto queue = std::make_shared<QueueTaskRunner>();
+    auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+      args.foreground_task_runner = queue;
+    });
+
+    for (const Case &c : cases) {
+      bool called = false;
+      std::shared_ptr<const PreparedJavaScript> prepared;
+      std::exception_ptr error;
+      jsi::abi::prepareJavaScriptAsync(
+          *rt,
+          std::make_shared<StringBuffer>(c.source),
+          "bundle.js",
+          [&](Runtime &cbRt,
+              std::shared_ptr<const PreparedJavaScript> result,
+              std::exception_ptr err) {
+            EXPECT_EQ(&cbRt, rt.get());
+            called = true;
+            prepared = std::move(result);
+            error = err;
+          });
+      EXPECT_FALSE(called);
+      ASSERT_TRUE(queue->runUntil([&] { return called; }));
+
+      if (c.valid) {
+        ASSERT_TRUE(prepared);
+        EXPECT_FALSE(error);
+        EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+      } else {
+        EXPECT_FALSE(prepared);
+        EXPECT_THROW(std::rethrow_exception(error), JSError);
+      }
+    }
+
+    bool called = false;
+    jsi::abi::prepareJavaScriptAsync(
+        *rt,
+        std::make_shared<StringBuffer>(bundle),
+        "abandoned.js",
+        [&](Runtime &, std::shared_ptr<const PreparedJavaScript>,
+            std::exception_ptr) { called = true; });
+    rt.reset();
+    EXPECT_FALSE(called);
+  }
+}
+
+// With backgroundCodeCache, a code cache hit is deserialized on a worker
+// thread for both synchronous and asynchronous prepares, and the script it
+// yields runs the same as one compiled from source.
+TEST(AsyncPrepare, ConsumesCodeCacheOffThread) {
+  const std::string bundle = makeBundle(256 << 10);
+  for (bool direct : {false, true}) {
+    for (bool async : {false, true}) {
+      auto store = std::make_shared<StubPreparedScriptStore>();
+      for (int run = 0; run < 2; ++run) {
+        auto queue = std::make_shared<QueueTaskRunner>();
+        auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+          args.flags.backgroundCodeCache = true;
+          args.preparedScriptStore = store;
+          if (async)
+            args.foreground_task_runner = queue;
+        });
+
+        auto buffer = std::make_shared<StringBuffer>(bundle);
+        std::shared_ptr<const PreparedJavaScript> prepared;
+        if (async) {
+          jsi::abi::prepareJavaScriptAsync(
+              *rt,
+              buffer,
+              "cached.js",
+              [&](Runtime &,
+                  std::shared_ptr<const PreparedJavaScript> result,
+                  std::exception_ptr) { prepared = std::move(result); });
+          ASSERT_TRUE(queue->runUntil([&] { return prepared != nullptr; }));
+        } else {
+          prepared = rt->prepareJavaScript(buffer, "cached.js");
+        }
+        EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+      }
+      EXPECT_EQ(store->loadCount, 2);
+      EXPECT_EQ(store->storeCount, 1);
+    }
+  }
+}
+
+// With warmCodeCache, the code cache stored after startup completes covers
+// the functions startup ran, so it is larger than the one stored at compile
+// time. A warm cache that is already stored is not written again. Startup
+// completes at notifyStartupComplete or, with a delay, from a task.
+TEST(WarmCodeCache, StoredOnceAfterStartup) {
+  const std::string bundle = makeBundle(64 << 10);
+  const std::string runAll =
+      "for (var i = 0; typeof globalThis['f' + i] === 'function'; ++i) "
+      "globalThis['f' + i](1, 2);";
+  for (bool direct : {false, true}) {
+    for (bool delayed : {false, true}) {
+      auto store = std::make_shared<StubPreparedScriptStore>();
+      size_t coldSize = 0;
+      for (int run = 0; run < 2; ++run) {
+        auto queue = std::make_shared<QueueTaskRunner>();
+        auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+          args.flags.warmCodeCache = true;
+          args.preparedScriptStore = store;
+          if (delayed) {
+            args.warmCodeCacheDelayMs = 1;
+            args.foreground_task_runner = queue;
+          }
+        });
+
+        auto prepared = rt->prepareJavaScript(
+            std::make_shared<StringBuffer>(bundle), "warm.js");
+        if (run == 0)
+          coldSize = store->lastPersistedSize;
+        EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+        rt->evaluateJavaScript(std::make_shared<StringBuffer>(runAll), "");
+
+        if (delayed && run == 0) {
+          ASSERT_TRUE(queue->runUntil([&] { return store->storeCount == 2; }));
+        } else {
+          jsi::abi::notifyStartupComplete(*rt);
+          jsi::abi::notifyStartupComplete(*rt);
+        }
+      }
+      EXPECT_EQ(store->loadCount, 2);
+      EXPECT_EQ(store->storeCount, 2);
+      EXPECT_GT(store->lastPersistedSize, coldSize);
+    }
+  }
+}
+
+// Per-call cost of the ABI-wrapped and in-process runtimes for a JS function
+// call from C++ and a host function call from JS. Asserts only correctness;
+// the timings are printed for comparison.
+TEST(V8JsiBenchmark, DISABLED_CallOverheadDirectVsAbi) {
+  constexpr size_t kIterations = 200000;
+  for (bool direct : {false, true}) {
+    auto rt = makeRuntime(direct);
+    Function jsAdd = rt->evaluateJavaScript(
+                         std::make_shared<StringBuffer>(
+                             "(function(a, b) { return a + b; })"),
+                         "")
+                         .getObject(*rt)
+                         .getFunction(*rt);
+    double sum = 0;
+    double jsCallNs = measureNsPerOp(kIterations, [&] {
+      sum += jsAdd.call(*rt, 1, 2).getNumber();
+    });
+    EXPECT_GT(sum, 0);
+
+    Function hostAdd = Function::createFromHostFunction(
+        *rt, PropNameID::forAscii(*rt, "hostAdd"), 2,
+        [](Runtime &, const Value &, const Value *args, size_t) {
+          return Value(args[0].getNumber() + args[1].getNumber());
+        });
+    Function loop = rt->evaluateJavaScript(
+                          std::make_shared<StringBuffer>(
+                              "(function(f, n) { let s = 0;"
+                              " for (let i = 0; i < n; ++i) s += f(i, 1);"
+                              " return s; })"),
+                          "")
+                        .getObject(*rt)
+                        .getFunction(*rt);
+    // One JS loop making kIterations host calls; amortize over the calls.
+    double loopNs = measureNsPerOp(1, [&] {
+      sum += loop.call(*rt, hostAdd, static_cast<double>(kIterations))
+                 .getNumber();
+    });
+    double hostCallNs = loopNs / static_cast<double>(kIterations);
+
+    std::printf(
+        "[%s] JS call from C++: %.1f ns/op, host call from JS: %.1f ns/op\n",
+        direct ? "direct" : "abi", jsCallNs, hostCallNs);
+  }
+}
+
+// Native-to-JS call latency for named, anonymous and constructor calls on
+// every runtime generator, i.e. the JsiAbiRuntime and V8DirectRuntime call
+// paths. None of them resolves the function name for tracing, so the name of
+// the callee must not change the cost of a call.
+TEST(V8JsiBenchmark, DISABLED_NativeToJsCallLatency) {
+  constexpr size_t kIterations = 200000;
+  size_t index = 0;
+  for (const RuntimeFactory &factory : runtimeGenerators()) {
+    auto rt = factory();
+    Object fns = rt->evaluateJavaScript(
+                       std::make_shared<StringBuffer>(
+                           "({ named: function add(a, b) { return a + b; },"
+                           "   anonymous: (a, b) => a + b,"
+                           "   ctor: function Point(x) { this.x = x; } })"),
+                       "")
+                     .getObject(*rt);
+    Function named = fns.getPropertyAsFunction(*rt, "named");
+    Function anonymous = fns.getPropertyAsFunction(*rt, "anonymous");
+    Function ctor = fns.getPropertyAsFunction(*rt, "ctor");
+
+    double sum = 0;
+    double namedNs = measureNsPerOp(kIterations, [&] {
+      sum += named.call(*rt, 1, 2).getNumber();
+    });
+    double anonymousNs = measureNsPerOp(kIterations, [&] {
+      sum += anonymous.call(*rt, 1, 2).getNumber();
+    });
+    double ctorNs = measureNsPerOp(kIterations, [&] {
+      sum += ctor.callAsConstructor(*rt, 1).isObject() ? 1 : 0;
+    });
+    EXPECT_GT(sum, 0);
+
+    std::printf(
+        "[runtime %zu] named call: %.1f ns/op, anonymous call: %.1f ns/op, "
+        "construct: %.1f ns/op\n",
+        index++, namedNs, anonymousNs, ctorNs);
+  }
+}
+
+// String conversion throughput from 8 B to 8 MB for ASCII, Latin-1 and
+// two-byte content: String::utf8 (JS to native) and createFromUtf8 (native to
+// JS).
+TEST(V8JsiBenchmark, DISABLED_Utf8Transcoding) {
+  struct Kind {
+    const char *name;
+    const char *unit; // JS string literal repeated to build the input
+    size_t utf8Bytes; // UTF-8 size of one unit
+  };
+  const Kind kinds[] = {
+      {"ascii", "'abcdefgh'", 8},
+      {"latin1", "'abc\\u00e9defg'", 9},
+      {"two-byte", "'abc\\u65e5defg'", 10},
+  };
+  constexpr size_t kBytesPerRun = 64 << 20;
+
+  for (bool direct : {false, true}) {
+    auto rt = makeRuntime(direct);
+    for (const Kind &kind : kinds) {
+      for (size_t size = 8; size <= (8u << 20); size *= 8) {
+        size_t repeat = std::max<size_t>(1, size / kind.utf8Bytes);
+        std::string source = std::string(kind.unit) + ".repeat(" +
+            std::to_string(repeat) + ")";
+        String str = rt->evaluateJavaScript(
+                           std::make_shared<StringBuffer>(source), "")
+                         .getString(*rt);
+        std::string utf8 = str.utf8(*rt);
+        ASSERT_EQ(utf8.size(), repeat * kind.utf8Bytes);
+
+        size_t iterations = std::max<size_t>(4, kBytesPerRun / utf8.size());
+        size_t total = 0;
+        double toUtf8Ns = measureNsPerOp(iterations, [&] {
+          total += str.utf8(*rt).size();
+        });
+        double fromUtf8Ns = measureNsPerOp(iterations, [&] {
+          String created = String::createFromUtf8(*rt, utf8);
+          ++total;
+        });
+        EXPECT_GT(total, 0u);
+
+        auto mbPerSec = [&](double ns) {
+          return static_cast<double>(utf8.size()) / ns * 1e9 / (1 << 20);
+        };
+        std::printf(
+            "[%s] %-8s %8zu B: utf8 %10.1f ns (%8.1f MB/s), "
+            "createFromUtf8 %10.1f ns (%8.1f MB/s)\n",
+            direct ? "direct" : "abi", kind.name, utf8.size(), toUtf8Ns,
+            mbPerSec(toUtf8Ns), fromUtf8Ns, mbPerSec(fromUtf8Ns));
+      }
+    }
+  }
+}
+
+// Cold-start cost of preparing a bundle without a code cache: synchronous
+// prepareJavaScript against prepareJavaScriptAsync, which parses on a worker
+// thread. "js thread" is the time the JS thread is blocked; for the async
+// path, the call itself plus the completion task. Each run uses a fresh
+// runtime so that V8's in-isolate compilation cache stays cold.
+TEST(V8JsiBenchmark, DISABLED_ColdStartPrepare) {
+  constexpr int kRuns = 5;
+  auto ms = [](std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+
+  for (size_t size : {size_t{1} << 20, size_t{4} << 20, size_t{16} << 20}) {
+    auto buffer = std::make_shared<StringBuffer>(makeBundle(size));
+    for (bool direct : {false, true}) {
+      std::chrono::steady_clock::duration syncTime{};
+      std::chrono::steady_clock::duration asyncBlocked{};
+      std::chrono::steady_clock::duration asyncLatency{};
+      for (int run = 0; run < kRuns; ++run) {
+        {
+          auto rt = makeRuntime(direct);
+          auto start = std::chrono::steady_clock::now();
+          auto prepared = rt->prepareJavaScript(buffer, "bundle.js");
+          syncTime += std::chrono::steady_clock::now() - start;
+          EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+        }
+        {
+          auto queue = std::make_shared<QueueTaskRunner>();
+          auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+            args.foreground_task_runner = queue;
+          });
+
+          std::shared_ptr<const PreparedJavaScript> prepared;
+          auto start = std::chrono::steady_clock::now();
+          jsi::abi::prepareJavaScriptAsync(
+              *rt,
+              buffer,
+              "bundle.js",
+              [&](Runtime &,
+                  std::shared_ptr<const PreparedJavaScript> result,
+                  std::exception_ptr) { prepared = std::move(result); });
+          asyncBlocked += std::chrono::steady_clock::now() - start;
+          ASSERT_TRUE(queue->runUntil([&] { return prepared != nullptr; }));
+          asyncLatency += std::chrono::steady_clock::now() - start;
+          asyncBlocked += queue->busy;
+          EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+        }
+      }
+      std::printf(
+          "[%s] %5zu KB: sync %8.2f ms | async: js thread %8.2f ms, "
+          "ready after %8.2f ms\n",
+          direct ? "direct" : "abi", buffer->size() >> 10,
+          ms(syncTime) / kRuns, ms(asyncBlocked) / kRuns,
+          ms(asyncLatency) / kRuns);
+    }
+  }
+}
+
+// Start of a bundle mapped with MappedFileBuffer, with its code cache in a
+// FilePreparedScriptStore. A cold start finds the store directory empty and
+// writes the cache; a warm start maps the cache the cold start left behind.
+// Each start uses a fresh runtime and store, as a new process would.
+TEST(V8JsiBenchmark, DISABLED_FileStoreColdWarmStart) {
+  constexpr int kRuns = 5;
+  auto ms = [](std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+  const auto dir =
+      std::filesystem::temp_directory_path() / "v8jsi_file_store_benchmark";
+  const auto bundlePath = dir / "bundle.js";
+  const auto storeDir = dir / "cache";
+
+  for (size_t size : {size_t{1} << 20, size_t{4} << 20, size_t{16} << 20}) {
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    { std::ofstream(bundlePath, std::ios::binary) << makeBundle(size); }
+    for (bool direct : {false, true}) {
+      std::chrono::steady_clock::duration coldTime{};
+      std::chrono::steady_clock::duration warmTime{};
+      for (int run = 0; run < kRuns; ++run) {
+        std::filesystem::remove_all(storeDir);
+        for (bool warm : {false, true}) {
+          auto start = std::chrono::steady_clock::now();
+          auto rt = makeRuntime(direct, [&](v8runtime::V8RuntimeArgs &args) {
+            args.preparedScriptStore =
+                std::make_shared<v8runtime::FilePreparedScriptStore>(storeDir);
+          });
+          auto bundle = v8runtime::MappedFileBuffer::open(bundlePath);
+          ASSERT_NE(bundle, nullptr);
+          auto prepared = rt->prepareJavaScript(bundle, "bundle.js");
+          EXPECT_EQ(rt->evaluatePreparedJavaScript(prepared).getNumber(), 45);
+          (warm ? warmTime : coldTime) +=
+              std::chrono::steady_clock::now() - start;
+        }
+      }
+      std::printf(
+          "[%s] %5zu KB: cold %8.2f ms | warm %8.2f ms\n",
+          direct ? "direct" : "abi", size >> 10, ms(coldTime) / kRuns,
+          ms(warmTime) / kRuns);
+    }
+  }
+  std::filesystem::remove_all(dir);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -8,8 +8,11 @@
 #include <jsi/instrumentation.h>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <fstream>
-#include <mutex>
+#include <list>
 #include <optional>
 #include <sstream>
 #include <string_view>
@@ -191,13 +194,68 @@ class BasicStringKey {
 using StringKey = BasicStringKey<char>;
 using Utf16StringKey = BasicStringKey<char16_t>;
 
+// Size- and age-bounded least recently used cache keyed by BasicStringKey.
+// When the cache is full, insert() evicts the least recently used entry.
+// sweep() evicts entries that were not used for longer than maxAge; the age
+// resolution is the interval between sweep() calls.
+// It must be used from a single thread.
+template <typename TKey, typename TValue>
+class LruCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Stats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+  };
+
+  LruCache(size_t capacity, Clock::duration maxAge) noexcept;
+
+  // Returns the cached value or nullptr.
+  TValue *find(const TKey &key);
+
+  // Adds value for a key that is not in the cache.
+  void insert(TKey key, TValue value);
+
+  // Evicts entries that were last used before now - maxAge.
+  void sweep(Clock::time_point now) noexcept;
+
+  size_t size() const noexcept;
+  const Stats &stats() const noexcept;
+
+ private:
+  using LruList = std::list<const TKey *>;
+
+  struct Entry {
+    TValue value;
+    Clock::time_point lastUsed;
+    typename LruList::iterator lruPosition;
+  };
+
+  void evictLeastRecentlyUsed() noexcept;
+
+ private:
+  std::unordered_map<TKey, Entry, typename TKey::Hash, typename TKey::EqualTo> entries_;
+  // Keys owned by entries_, the most recently used first.
+  LruList lru_;
+  size_t capacity_;
+  Clock::duration maxAge_;
+  Clock::time_point now_{Clock::now()};
+  Stats stats_;
+};
+
 struct NodeApiAttachTag {
 } attachTag;
 
 // Implementation of N-API JSI Runtime
 class NodeApiJsiInstrumentation : public facebook::jsi::Instrumentation {
  public:
-  NodeApiJsiInstrumentation(napi_env env, JSRuntimeApi *jsrApi) : env_(env), jsrApi_(jsrApi) {}
+  // Adds runtime-side counters to the heap info reported by the engine.
+  using HeapInfoExtension = std::function<void(std::unordered_map<std::string, int64_t> &)>;
+
+  NodeApiJsiInstrumentation(napi_env env, JSRuntimeApi *jsrApi, HeapInfoExtension heapInfoExtension)
+      : env_(env), jsrApi_(jsrApi), heapInfoExtension_(std::move(heapInfoExtension)) {}
 
   std::string getRecordedGCStats() override {
     std::string result;
@@ -212,6 +270,9 @@ class NodeApiJsiInstrumentation : public facebook::jsi::Instrumentation {
       map->try_emplace(key, value);
     };
     jsrApi_->jsr_instrumentation_get_heap_info(env_, includeExpensive, cb, &result);
+    if (heapInfoExtension_) {
+      heapInfoExtension_(result);
+    }
     return result;
   }
 
@@ -286,6 +347,7 @@ class NodeApiJsiInstrumentation : public facebook::jsi::Instrumentation {
  private:
   napi_env env_;
   JSRuntimeApi *jsrApi_;
+  HeapInfoExtension heapInfoExtension_;
 };
 
 class NodeApiJsiRuntime : public jsi::Runtime {
@@ -311,7 +373,10 @@ class NodeApiJsiRuntime : public jsi::Runtime {
 
   facebook::jsi::Instrumentation &instrumentation() override {
     if (!instrumentation_) {
-      instrumentation_ = std::make_unique<NodeApiJsiInstrumentation>(env_, jsrApi_);
+      instrumentation_ = std::make_unique<NodeApiJsiInstrumentation>(
+          env_, jsrApi_, [this](std::unordered_map<std::string, int64_t> &heapInfo) {
+            addRuntimeHeapInfo(heapInfo);
+          });
     }
     return *instrumentation_;
   }
@@ -605,12 +670,56 @@ class NodeApiJsiRuntime : public jsi::Runtime {
   using NodeApiStackValuePtr = std::unique_ptr<NodeApiRefCountedPointerValue, NodeApiStackValueDeleter>;
   using NodeApiRefPtr = std::unique_ptr<NodeApiRefCountedPointerValue, NodeApiRefDeleter>;
 
+  // NodeApiPointerValuePool allocates memory for NodeApiRefCountedPointerValue instances from fixed-size slabs.
+  // Freed slots are kept in an intrusive free list and reused by the next allocation, so that the values created and
+  // deleted in each NodeApiPointerValueScope do not touch the heap in a steady state. Slabs are returned to the heap
+  // only when the pool is destroyed.
+  // The pool is owned by NodeApiPendingDeletions because every NodeApiRefCountedPointerValue already keeps it alive.
+  // It must be used from the JS thread, or by the last owner of NodeApiPendingDeletions after the runtime is gone.
+  class NodeApiPointerValuePool {
+   public:
+    struct Stats {
+      uint64_t allocations{}; // Total number of allocated slots.
+      size_t live{}; // Slots in use.
+      size_t peak{}; // High-water mark of live.
+      size_t slabs{}; // Slabs held by the pool.
+    };
+
+    constexpr static size_t SlotsPerSlab = 256;
+
+    NodeApiPointerValuePool() noexcept = default;
+
+    void *allocate();
+    void free(void *slot) noexcept;
+    const Stats &stats() const noexcept;
+
+    NodeApiPointerValuePool(const NodeApiPointerValuePool &) = delete;
+    NodeApiPointerValuePool &operator=(const NodeApiPointerValuePool &) = delete;
+
+   private:
+    struct FreeSlot {
+      FreeSlot *next;
+    };
+
+    static size_t slotSize() noexcept;
+
+   private:
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    FreeSlot *freeList_{};
+    Stats stats_;
+  };
+
   // NodeApiPendingDeletions helps to delete PointerValues in a thread safe way from the JS thread.
   // According to JSI spec the PointerValue's release method can be called from any thread, while Node-API can only
   // manage objects in the JS thread. So, when a PointerValue's ref count goes to zero after calling the release method,
-  // the PointerValue is added into the pointerValuesToDelete_ vector, and then NodeApiJsiRuntime deletes them later
+  // the PointerValue is pushed to the lock-free pendingHead_ list, and then NodeApiJsiRuntime deletes them later
   // from the JS thread. Note that the napi_delete_reference can only be called before the napi_env is destroyed. Thus,
   // we remove the pointer to napi_env as soon as NodeApiJsiRuntime destructor starts.
+  //
+  // The list is an intrusive multi-producer single-consumer stack linked through
+  // NodeApiRefCountedPointerValue::nextPendingDeletion_: releasing threads push with a CAS loop, and the JS thread
+  // detaches the whole list with a single exchange. Neither side takes a lock, and the JS thread only does an atomic
+  // load when there is nothing to delete.
   class NodeApiPendingDeletions {
    public:
     // Create new instance of NodeApiPendingDeletions.
@@ -620,29 +729,29 @@ class NodeApiJsiRuntime : public jsi::Runtime {
 
     // Add PointerValues to delete from JS thread. The method can be called from any thread.
     void addPointerValueToDelete(NodeApiRefPtr pointerValueToDelete) noexcept {
-      std::scoped_lock lock{mutex_};
-      pointerValuesToDeletePool_[poolSelector_].push_back(std::move(pointerValueToDelete));
+      NodeApiRefCountedPointerValue *pointerValue = pointerValueToDelete.release();
+      NodeApiRefCountedPointerValue *head = pendingHead_.load(std::memory_order_relaxed);
+      do {
+        pointerValue->nextPendingDeletion_ = head;
+      } while (!pendingHead_.compare_exchange_weak(
+          head, pointerValue, std::memory_order_release, std::memory_order_relaxed));
     }
 
     // Delete all PointerValues scheduled for deletion along with their napi_ref instances.
     // It must be called from a JS thread.
     void deletePointerValues(NodeApiJsiRuntime &runtime) noexcept {
-      {
-        // TODO: Does it affect the performance to take the lock every time? Should we use an atomic variable?
-        std::scoped_lock lock{mutex_};
-        if (pointerValuesToDeletePool_[poolSelector_].empty()) {
-          return;
-        }
-
-        // Switch the pool entries.
-        poolSelector_ = poolSelector_ ^ 1;
+      if (pendingHead_.load(std::memory_order_relaxed) == nullptr) {
+        return;
       }
 
-      std::vector<NodeApiRefPtr> &deleteInJSThread = pointerValuesToDeletePool_[poolSelector_ ^ 1];
-      for (auto &pointerValue : deleteInJSThread) {
-        pointerValue.release()->deleteNodeApiRef(runtime);
+      NodeApiRefCountedPointerValue *pointerValue = pendingHead_.exchange(nullptr, std::memory_order_acquire);
+      while (pointerValue != nullptr) {
+        std::exchange(pointerValue, pointerValue->nextPendingDeletion_)->deleteNodeApiRef(runtime);
       }
-      deleteInJSThread.resize(0);
+    }
+
+    NodeApiPointerValuePool &pointerValuePool() noexcept {
+      return pointerValuePool_;
     }
 
    private:
@@ -650,6 +759,13 @@ class NodeApiJsiRuntime : public jsi::Runtime {
 
     NodeApiPendingDeletions() noexcept = default;
 
+    ~NodeApiPendingDeletions() {
+      NodeApiRefCountedPointerValue *pointerValue = pendingHead_.exchange(nullptr, std::memory_order_acquire);
+      while (pointerValue != nullptr) {
+        NodeApiRefDeleter{}(std::exchange(pointerValue, pointerValue->nextPendingDeletion_));
+      }
+    }
+
     void incRefCount() noexcept {
       NodeApiRefCount::incRefCount(refCount_);
     }
@@ -662,15 +778,9 @@ class NodeApiJsiRuntime : public jsi::Runtime {
 
    private:
     mutable std::atomic<int32_t> refCount_{1};
-    std::recursive_mutex mutex_;
-    // One of the vectors is used from different threads under the mutex_ lock to add items, while another is from JS
-    // thread to remove items. Since we never change the capacity of the vectors, it should help avoiding memory
-    // allocations at some point.
-    std::vector<NodeApiRefPtr> pointerValuesToDeletePool_[2]{
-        std::vector<NodeApiRefPtr>(),
-        std::vector<NodeApiRefPtr>()};
-    // Index of the pool to access under mutex.
-    int32_t poolSelector_{0};
+    NodeApiPointerValuePool pointerValuePool_;
+    // Most recently released PointerValue. The list continues through nextPendingDeletion_.
+    std::atomic<NodeApiRefCountedPointerValue *> pendingHead_{nullptr};
   };
 
   // NodeApiPointerValue is used by jsi::Pointer derived classes.
@@ -701,8 +811,6 @@ class NodeApiJsiRuntime : public jsi::Runtime {
     NodeApiPointerValueKind pointerKind_{NodeApiPointerValueKind::Object};
   };
 
-  // TODO: Use arena allocator for NodeApiRefCountedPointerValue.
-
   // NodeApiRefCountedPointerValue is a ref counted implementation of PointerValue that is allocated in the heap.
   //
   // Its lifetime is controlled by the atomic `refCount_` field. Since the `refCount_` can be changed from any thread,
@@ -726,6 +834,7 @@ class NodeApiJsiRuntime : public jsi::Runtime {
   class NodeApiRefCountedPointerValue final : public NodeApiPointerValue {
     friend class NodeApiStackValueDeleter;
     friend class NodeApiRefDeleter;
+    friend class NodeApiPendingDeletions;
     friend class NodeApiRefCountedPtr<NodeApiRefCountedPointerValue>;
 
    public:
@@ -771,11 +880,16 @@ class NodeApiJsiRuntime : public jsi::Runtime {
     void incRefCount() const noexcept;
     void decRefCount() const noexcept;
 
+    // Destroys the instance and returns its memory to the pool it was allocated from.
+    static void destroy(NodeApiRefCountedPointerValue *ptr) noexcept;
+
     // Creates `napi_ref ref_` field for the `napi_value value_` field.
     NodeApiRefCountedPointerValue *createNodeApiRef(NodeApiJsiRuntime &runtime);
 
    private:
     NodeApiRefCountedPtr<NodeApiPendingDeletions> pendingDeletions_;
+    // Next PointerValue in the NodeApiPendingDeletions list after the ref count drops to zero.
+    NodeApiRefCountedPointerValue *nextPendingDeletion_{};
     napi_value value_{};
     napi_ref ref_{};
     mutable std::atomic<int32_t> refCount_{1};
@@ -1023,6 +1137,12 @@ class NodeApiJsiRuntime : public jsi::Runtime {
   void pushPointerValueScope() noexcept;
   void popPointerValueScope() noexcept;
 
+  void sweepPropNameIDCaches(std::chrono::steady_clock::time_point now) noexcept;
+  friend void Microsoft::NodeApiJsi::sweepNodeApiJsiPropNameIDCaches(
+      jsi::Runtime &runtime,
+      std::chrono::steady_clock::duration elapsed) noexcept;
+  void addRuntimeHeapInfo(std::unordered_map<std::string, int64_t> &heapInfo) const;
+
   napi_env getEnv() const noexcept {
     return env_;
   }
@@ -1073,9 +1193,16 @@ class NodeApiJsiRuntime : public jsi::Runtime {
   std::vector<size_t> stackScopes_;
   std::vector<NodeApiStackValuePtr> stackValues_;
 
-  // TODO: implement GC for propNameIDs_
-  std::unordered_map<StringKey, NodeApiRefHolder, StringKey::Hash, StringKey::EqualTo> propNameIDs_;
-  std::unordered_map<Utf16StringKey, NodeApiRefHolder, Utf16StringKey::Hash, Utf16StringKey::EqualTo> utf16PropNameIDs_;
+  // Property names created from strings are cached to avoid creating the same property key again.
+  // Each cache keeps at most PropNameIDCacheCapacity names. Names that were not used for PropNameIDMaxAge are
+  // evicted by a sweep that runs every PropNameIDSweepInterval pointer value scopes, so that dynamically built
+  // names, such as JSON keys, do not stay pinned in the heap for the life of the runtime.
+  constexpr static size_t PropNameIDCacheCapacity = 4096;
+  constexpr static std::chrono::seconds PropNameIDMaxAge{60};
+  constexpr static uint32_t PropNameIDSweepInterval = 1024;
+  LruCache<StringKey, NodeApiRefHolder> propNameIDs_{PropNameIDCacheCapacity, PropNameIDMaxAge};
+  LruCache<Utf16StringKey, NodeApiRefHolder> utf16PropNameIDs_{PropNameIDCacheCapacity, PropNameIDMaxAge};
+  uint32_t scopesSinceSweep_{0};
 
   NodeApiJsiRuntime &runtime{*this};
   NodeApiRefCountedPtr<NodeApiPendingDeletions> pendingDeletions_{NodeApiPendingDeletions::create()};
@@ -1153,6 +1280,72 @@ bool BasicStringKey<TChar>::EqualTo::operator()(const BasicStringKey<TChar> &lef
   return left.equalTo(right);
 }
 
+//=====================================================================================================================
+// LruCache implementation
+//=====================================================================================================================
+
+template <typename TKey, typename TValue>
+LruCache<TKey, TValue>::LruCache(size_t capacity, Clock::duration maxAge) noexcept
+    : capacity_(capacity), maxAge_(maxAge) {}
+
+template <typename TKey, typename TValue>
+TValue *LruCache<TKey, TValue>::find(const TKey &key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  ++stats_.hits;
+  Entry &entry = it->second;
+  entry.lastUsed = now_;
+  lru_.splice(lru_.begin(), lru_, entry.lruPosition);
+  return &entry.value;
+}
+
+template <typename TKey, typename TValue>
+void LruCache<TKey, TValue>::insert(TKey key, TValue value) {
+  if (entries_.size() >= capacity_) {
+    evictLeastRecentlyUsed();
+  }
+
+  auto [it, inserted] = entries_.try_emplace(std::move(key), Entry{std::move(value), now_, {}});
+  if (inserted) {
+    lru_.push_front(&it->first);
+    it->second.lruPosition = lru_.begin();
+  }
+}
+
+template <typename TKey, typename TValue>
+void LruCache<TKey, TValue>::sweep(Clock::time_point now) noexcept {
+  now_ = now;
+  while (!lru_.empty() && now - entries_.find(*lru_.back())->second.lastUsed > maxAge_) {
+    evictLeastRecentlyUsed();
+  }
+}
+
+template <typename TKey, typename TValue>
+size_t LruCache<TKey, TValue>::size() const noexcept {
+  return entries_.size();
+}
+
+template <typename TKey, typename TValue>
+const typename LruCache<TKey, TValue>::Stats &LruCache<TKey, TValue>::stats() const noexcept {
+  return stats_;
+}
+
+template <typename TKey, typename TValue>
+void LruCache<TKey, TValue>::evictLeastRecentlyUsed() noexcept {
+  if (lru_.empty()) {
+    return;
+  }
+
+  const TKey *key = lru_.back();
+  lru_.pop_back();
+  entries_.erase(*key);
+  ++stats_.evictions;
+}
+
 //=====================================================================================================================
 // NodeApiJsiRuntime implementation
 //=====================================================================================================================
@@ -1294,9 +1487,8 @@ jsi::Runtime::PointerValue *NodeApiJsiRuntime::clonePropNameID(const jsi::Runtim
 jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromAscii(const char *str, size_t length) {
   NodeApiScope scope{*this};
   StringKey keyName{str, length};
-  auto it = propNameIDs_.find(keyName);
-  if (it != propNameIDs_.end()) {
-    return make<jsi::PropNameID>(it->second->clone(*this));
+  if (NodeApiRefHolder *cached = propNameIDs_.find(keyName)) {
+    return make<jsi::PropNameID>((*cached)->clone(*this));
   }
 
   napi_value obj = createNodeApiObject();
@@ -1309,16 +1501,15 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromAscii(const char *str, si
   napi_value propNameId = getElement(props, 0);
   NodeApiRefHolder propNameRef = makeNodeApiRef(propNameId, NodeApiPointerValueKind::StringPropNameID, 2);
   jsi::PropNameID result = make<jsi::PropNameID>(propNameRef.get());
-  propNameIDs_.try_emplace(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
+  propNameIDs_.insert(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
   return result;
 }
 
 jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromUtf8(const uint8_t *utf8, size_t length) {
   NodeApiScope scope{*this};
   StringKey keyName{reinterpret_cast<const char *>(utf8), length};
-  auto it = propNameIDs_.find(keyName);
-  if (it != propNameIDs_.end()) {
-    return make<jsi::PropNameID>(it->second->clone(*this));
+  if (NodeApiRefHolder *cached = propNameIDs_.find(keyName)) {
+    return make<jsi::PropNameID>((*cached)->clone(*this));
   }
 
   napi_value obj = createNodeApiObject();
@@ -1331,7 +1522,7 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromUtf8(const uint8_t *utf8,
   napi_value propNameId = getElement(props, 0);
   NodeApiRefHolder propNameRef = makeNodeApiRef(propNameId, NodeApiPointerValueKind::StringPropNameID, 2);
   jsi::PropNameID result = make<jsi::PropNameID>(propNameRef.get());
-  propNameIDs_.try_emplace(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
+  propNameIDs_.insert(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
   return result;
 }
 
@@ -1339,9 +1530,8 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromUtf8(const uint8_t *utf8,
 jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromUtf16(const char16_t *utf16, size_t length) {
   NodeApiScope scope{*this};
   Utf16StringKey keyName{utf16, length};
-  auto it = utf16PropNameIDs_.find(keyName);
-  if (it != utf16PropNameIDs_.end()) {
-    return make<jsi::PropNameID>(it->second->clone(*this));
+  if (NodeApiRefHolder *cached = utf16PropNameIDs_.find(keyName)) {
+    return make<jsi::PropNameID>((*cached)->clone(*this));
   }
 
   napi_value obj = createNodeApiObject();
@@ -1354,7 +1544,7 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromUtf16(const char16_t *utf
   napi_value propNameId = getElement(props, 0);
   NodeApiRefHolder propNameRef = makeNodeApiRef(propNameId, NodeApiPointerValueKind::StringPropNameID, 2);
   jsi::PropNameID result = make<jsi::PropNameID>(propNameRef.get());
-  utf16PropNameIDs_.try_emplace(Utf16StringKey(std::u16string(keyName.getStringView())), std::move(propNameRef));
+  utf16PropNameIDs_.insert(Utf16StringKey(std::u16string(keyName.getStringView())), std::move(propNameRef));
   return result;
 }
 #endif
@@ -1367,9 +1557,8 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromString(const jsi::String
   }
 
   StringKey keyName(utf8(str));
-  auto it = propNameIDs_.find(keyName);
-  if (it != propNameIDs_.end()) {
-    return make<jsi::PropNameID>(it->second->clone(*this));
+  if (NodeApiRefHolder *cached = propNameIDs_.find(keyName)) {
+    return make<jsi::PropNameID>((*cached)->clone(*this));
   }
 
   napi_value napiStr = const_cast<NodeApiPointerValue *>(pv)->getValue(*this);
@@ -1382,7 +1571,7 @@ jsi::PropNameID NodeApiJsiRuntime::createPropNameIDFromString(const jsi::String
   napi_value propNameId = getElement(props, 0);
   NodeApiRefHolder propNameRef = makeNodeApiRef(propNameId, NodeApiPointerValueKind::StringPropNameID, 2);
   jsi::PropNameID result = make<jsi::PropNameID>(propNameRef.get());
-  propNameIDs_.try_emplace(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
+  propNameIDs_.insert(StringKey(std::string(keyName.getStringView())), std::move(propNameRef));
   return result;
 }
 
@@ -2048,7 +2237,9 @@ NodeApiJsiRuntime::NodeApiRefCountedPointerValue::NodeApiRefCountedPointerValue(
     napi_value value,
     NodeApiJsiRuntime::NodeApiPointerValueKind pointerKind,
     int32_t initialRefCount) {
-  NodeApiRefHolder result{new NodeApiRefCountedPointerValue(runtime, value, pointerKind, initialRefCount), attachTag};
+  void *slot = runtime.pendingDeletions_->pointerValuePool().allocate();
+  NodeApiRefHolder result{
+      ::new (slot) NodeApiRefCountedPointerValue(runtime, value, pointerKind, initialRefCount), attachTag};
   runtime.addStackValue(NodeApiStackValuePtr{result.get()});
   return result;
 }
@@ -2110,7 +2301,8 @@ bool NodeApiJsiRuntime::NodeApiRefCountedPointerValue::usedByJsiPointer() const
 void NodeApiJsiRuntime::NodeApiRefCountedPointerValue::deleteStackValue(NodeApiJsiRuntime &runtime) noexcept {
   CHECK_ELSE_CRASH(value_, "value_ must not be null");
   if (canBeDeletedFromStack_) {
-    delete this;
+    destroy(this);
+    return;
   }
 
   if (usedByJsiPointer() && ref_ == nullptr) {
@@ -2129,7 +2321,7 @@ void NodeApiJsiRuntime::NodeApiRefCountedPointerValue::deleteNodeApiRef(NodeApiJ
   if (value_ != nullptr) {
     canBeDeletedFromStack_ = true;
   } else {
-    delete this;
+    destroy(this);
   }
 }
 
@@ -2140,7 +2332,7 @@ void NodeApiJsiRuntime::NodeApiStackValueDeleter::operator()(NodeApiRefCountedPo
 
   ptr->value_ = nullptr;
   if (ptr->canBeDeletedFromStack_) {
-    delete ptr;
+    NodeApiRefCountedPointerValue::destroy(ptr);
   }
 }
 
@@ -2152,7 +2344,7 @@ void NodeApiJsiRuntime::NodeApiRefDeleter::operator()(NodeApiRefCountedPointerVa
   if (ptr->value_ != nullptr) {
     ptr->canBeDeletedFromStack_ = true;
   } else {
-    delete ptr;
+    NodeApiRefCountedPointerValue::destroy(ptr);
   }
 }
 
@@ -2166,6 +2358,13 @@ void NodeApiJsiRuntime::NodeApiRefCountedPointerValue::decRefCount() const noexc
   }
 }
 
+/*static*/ void NodeApiJsiRuntime::NodeApiRefCountedPointerValue::destroy(NodeApiRefCountedPointerValue *ptr) noexcept {
+  // Keep the pool alive until the memory is returned: the instance may hold the last reference to it.
+  NodeApiRefCountedPtr<NodeApiPendingDeletions> owner = std::move(ptr->pendingDeletions_);
+  ptr->~NodeApiRefCountedPointerValue();
+  owner->pointerValuePool().free(ptr);
+}
+
 NodeApiJsiRuntime::NodeApiRefCountedPointerValue *NodeApiJsiRuntime::NodeApiRefCountedPointerValue::createNodeApiRef(
     NodeApiJsiRuntime &runtime) {
   JSRuntimeApi *jsrApi = JSRuntimeApi::current();
@@ -2184,6 +2383,45 @@ NodeApiJsiRuntime::NodeApiRefCountedPointerValue *NodeApiJsiRuntime::NodeApiRefC
   return this;
 }
 
+//=====================================================================================================================
+// NodeApiJsiRuntime::NodeApiPointerValuePool implementation
+//=====================================================================================================================
+
+void *NodeApiJsiRuntime::NodeApiPointerValuePool::allocate() {
+  if (freeList_ == nullptr) {
+    size_t size = slotSize();
+    std::byte *slab = slabs_.emplace_back(std::make_unique<std::byte[]>(size * SlotsPerSlab)).get();
+    for (size_t i = SlotsPerSlab; i > 0; --i) {
+      freeList_ = ::new (slab + (i - 1) * size) FreeSlot{freeList_};
+    }
+    stats_.slabs = slabs_.size();
+  }
+
+  FreeSlot *slot = std::exchange(freeList_, freeList_->next);
+  ++stats_.allocations;
+  if (++stats_.live > stats_.peak) {
+    stats_.peak = stats_.live;
+  }
+  return slot;
+}
+
+void NodeApiJsiRuntime::NodeApiPointerValuePool::free(void *slot) noexcept {
+  freeList_ = ::new (slot) FreeSlot{freeList_};
+  --stats_.live;
+}
+
+const NodeApiJsiRuntime::NodeApiPointerValuePool::Stats &NodeApiJsiRuntime::NodeApiPointerValuePool::stats()
+    const noexcept {
+  return stats_;
+}
+
+/*static*/ size_t NodeApiJsiRuntime::NodeApiPointerValuePool::slotSize() noexcept {
+  // Slabs are allocated with operator new[], which aligns them for any fundamental type.
+  constexpr size_t alignment = alignof(std::max_align_t);
+  constexpr size_t size = std::max(sizeof(NodeApiRefCountedPointerValue), sizeof(FreeSlot));
+  return (size + alignment - 1) / alignment * alignment;
+}
+
 //=====================================================================================================================
 // NodeApiJsiRuntime::SmallBuffer implementation
 //=====================================================================================================================
@@ -3169,9 +3407,34 @@ void NodeApiJsiRuntime::popPointerValueScope() noexcept {
       beginIterator, stackValues_.end(), [this](NodeApiStackValuePtr &ptr) { ptr.release()->deleteStackValue(*this); });
   stackValues_.resize(newStackSize);
 
+  if (++scopesSinceSweep_ >= PropNameIDSweepInterval) {
+    sweepPropNameIDCaches(std::chrono::steady_clock::now());
+  }
+
   pendingDeletions_->deletePointerValues(*this);
 }
 
+void NodeApiJsiRuntime::sweepPropNameIDCaches(std::chrono::steady_clock::time_point now) noexcept {
+  scopesSinceSweep_ = 0;
+  propNameIDs_.sweep(now);
+  utf16PropNameIDs_.sweep(now);
+}
+
+void NodeApiJsiRuntime::addRuntimeHeapInfo(std::unordered_map<std::string, int64_t> &heapInfo) const {
+  const auto &stats = propNameIDs_.stats();
+  const auto &utf16Stats = utf16PropNameIDs_.stats();
+  heapInfo["propNameIDCacheHits"] = static_cast<int64_t>(stats.hits + utf16Stats.hits);
+  heapInfo["propNameIDCacheMisses"] = static_cast<int64_t>(stats.misses + utf16Stats.misses);
+  heapInfo["propNameIDCacheEvictions"] = static_cast<int64_t>(stats.evictions + utf16Stats.evictions);
+  heapInfo["propNameIDCacheSize"] = static_cast<int64_t>(propNameIDs_.size() + utf16PropNameIDs_.size());
+
+  const auto &poolStats = pendingDeletions_->pointerValuePool().stats();
+  heapInfo["pointerValueAllocations"] = static_cast<int64_t>(poolStats.allocations);
+  heapInfo["pointerValuesLive"] = static_cast<int64_t>(poolStats.live);
+  heapInfo["pointerValuesPeak"] = static_cast<int64_t>(poolStats.peak);
+  heapInfo["pointerValueSlabs"] = static_cast<int64_t>(poolStats.slabs);
+}
+
 } // namespace
 
 std::unique_ptr<jsi::Runtime>
@@ -3179,6 +3442,12 @@ makeNodeApiJsiRuntime(napi_env env, JSRuntimeApi *jsrApi, std::function<void()>
   return std::make_unique<NodeApiJsiRuntime>(env, jsrApi, std::move(onDelete));
 }
 
+void sweepNodeApiJsiPropNameIDCaches(jsi::Runtime &runtime, std::chrono::steady_clock::duration elapsed) noexcept {
+  NodeApiJsiRuntime &nodeApiRuntime = static_cast<NodeApiJsiRuntime &>(runtime);
+  NodeApiJsiRuntime::NodeApiScope scope{nodeApiRuntime};
+  nodeApiRuntime.sweepPropNameIDCaches(std::chrono::steady_clock::now() + elapsed);
+}
+
 } // namespace Microsoft::NodeApiJsi
 
 EXTERN_C_START
@@ -6,6 +6,7 @@
 #define NODEAPIJSIRUNTIME_H_
 
 #include <jsi/jsi.h>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include "ApiLoaders/JSRuntimeApi.h"
@@ -15,6 +16,12 @@ namespace Microsoft::NodeApiJsi {
 std::unique_ptr<facebook::jsi::Runtime>
 makeNodeApiJsiRuntime(napi_env env, JSRuntimeApi *jsrApi, std::function<void()> onDelete) noexcept;
 
+// Runs the age sweep of the property name caches of a runtime created by makeNodeApiJsiRuntime as if elapsed had
+// passed since the last sweep. Lets tests check the sweep without waiting for the cache's maximum age.
+void sweepNodeApiJsiPropNameIDCaches(
+    facebook::jsi::Runtime &runtime,
+    std::chrono::steady_clock::duration elapsed) noexcept;
+
 struct NodeApiEnvScope {
   NodeApiEnvScope(napi_env env) : env_(env) {
     JSRuntimeApi::current()->jsr_open_napi_env_scope(env, &scope_);
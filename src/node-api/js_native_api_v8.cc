@@ -6,6 +6,7 @@
 #include "js_native_api.h"
 #include "js_native_api_v8.h"
 #include "util-inl.h"
+#include "../v8_string.h"
 
 #define CHECK_MAYBE_NOTHING(env, maybe, status)                                \
   RETURN_STATUS_IF_FALSE((env), !((maybe).IsNothing()), (status))
@@ -1629,8 +1630,8 @@ napi_status NAPI_CDECL napi_create_string_utf8(napi_env env,
                                                size_t length,
                                                napi_value* result) {
   return v8impl::NewString(env, str, length, result, [&](v8::Isolate* isolate) {
-    return v8::String::NewFromUtf8(
-        isolate, str, v8::NewStringType::kNormal, static_cast<int>(length));
+    return v8rt::newStringFromUtf8(
+        isolate, str, length == NAPI_AUTO_LENGTH ? strlen(str) : length);
   });
 }
 
@@ -2463,14 +2464,10 @@ napi_status NAPI_CDECL napi_get_value_string_utf8(
 
   if (!buf) {
     CHECK_ARG(env, result);
-    *result = val.As<v8::String>()->Utf8Length(env->isolate);
+    *result = v8rt::utf8Length(env->isolate, val.As<v8::String>());
   } else if (bufsize != 0) {
-    int copied = val.As<v8::String>()->WriteUtf8(
-        env->isolate,
-        buf,
-        bufsize - 1,
-        nullptr,
-        v8::String::REPLACE_INVALID_UTF8 | v8::String::NO_NULL_TERMINATION);
+    size_t copied =
+        v8rt::writeUtf8(env->isolate, val.As<v8::String>(), buf, bufsize - 1);
 
     buf[copied] = '\0';
     if (result != nullptr) {
@@ -39,16 +39,18 @@
 
 #include "js_native_api_v8.h"
 
-#include "MurmurHash.h"
 #include "V8Instrumentation.h"
 #include "jsi_abi/jsi_abi_v8_internal.h"
 #include "jsi_abi/v8_jsi_config.h"
 #include "jsi_abi/v8_node_api_attach.h"
 #include "v8_core.h"
+#include "v8_source_hash.h"
+#include "v8_string.h"
 
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -438,21 +440,63 @@ class NodeApiEnv : public napi_env__ {
 
     auto cache = v8rt_internal::getScriptCacheCallbacks(m_runtime->abiRuntime());
 
+    // The hash pass also tells whether the source is ASCII. Bytes still
+    // wrapped in place by an earlier call are not hashed again.
+    auto& sourceHashes =
+        v8rt_internal::getSourceHashCache(m_runtime->abiRuntime());
     uint64_t source_hash = 0;
+    std::optional<bool> isAscii;
+    bool hashed = false;
     if (cache.load_cb || cache.store_cb) {
-      murmurhash(scriptData, scriptLength, source_hash);
+      if (sourceHashes.lookup(scriptData, scriptLength, source_hash)) {
+        isAscii = true;
+      } else {
+        isAscii = v8rt::hashSource(scriptData,
+                                   scriptLength,
+                                   source_hash,
+                                   v8rt::V8PlatformHolder::platform());
+        hashed = true;
+      }
     }
 
-    v8::Local<v8::String> sourceV8String =
-        v8::String::NewFromUtf8(isolate,
-                                 reinterpret_cast<const char*>(scriptData),
-                                 v8::NewStringType::kNormal,
-                                 static_cast<int>(scriptLength))
-            .ToLocalChecked();
-
+    v8::Local<v8::String> sourceV8String;
     if (scriptDeleteCallback != nullptr) {
-      // The buffer was copied into V8 by NewFromUtf8 above; release it.
-      scriptDeleteCallback(const_cast<uint8_t*>(scriptData), deleterData);
+      // We own the bytes: an ASCII source is wrapped in place and released
+      // when V8 collects the string; anything else is transcoded off-heap
+      // and released right away.
+      struct SourceOwner {
+        const uint8_t* data;
+        jsr_data_delete_cb deleteCallback;
+        void* deleterData;
+      };
+      auto* owner =
+          new SourceOwner{scriptData, scriptDeleteCallback, deleterData};
+      sourceV8String =
+          v8rt::newExternalSourceString(
+              isolate,
+              reinterpret_cast<const char*>(scriptData),
+              scriptLength,
+              [](void* data) {
+                auto* source = static_cast<SourceOwner*>(data);
+                source->deleteCallback(const_cast<uint8_t*>(source->data),
+                                       source->deleterData);
+                delete source;
+              },
+              owner,
+              isAscii)
+              .ToLocalChecked();
+      if (hashed) {
+        sourceHashes.remember(
+            isolate, scriptData, scriptLength, source_hash, sourceV8String);
+      }
+    } else {
+      // The caller keeps the bytes, so V8 needs its own copy.
+      sourceV8String =
+          v8::String::NewFromUtf8(isolate,
+                                   reinterpret_cast<const char*>(scriptData),
+                                   v8::NewStringType::kNormal,
+                                   static_cast<int>(scriptLength))
+              .ToLocalChecked();
     }
 
     v8::Local<v8::String> urlV8String =
@@ -496,6 +540,16 @@ class NodeApiEnv : public napi_env__ {
     bool compile_ok =
         v8::ScriptCompiler::Compile(env->context(), &script_source, options)
             .ToLocal(&compiled);
+    const bool rejected =
+        cached_data && script_source.GetCachedData()->rejected;
+    if (compile_ok && cache.load_cb) {
+      v8rt_internal::recordCodeCacheLookup(m_runtime->abiRuntime(),
+                                           sourceUrl,
+                                           source_hash,
+                                           cache_buffer,
+                                           cache_buffer_size,
+                                           rejected);
+    }
 
     if (cache_buffer_delete_cb) {
       cache_buffer_delete_cb(const_cast<uint8_t*>(cache_buffer),
@@ -509,8 +563,10 @@ class NodeApiEnv : public napi_env__ {
 
     v8::Local<v8::UnboundScript> unbound = compiled->GetUnboundScript();
 
+    // A rejected cache is replaced, so the next run can use it again.
     if (cache.store_cb &&
-        options != v8::ScriptCompiler::CompileOptions::kConsumeCodeCache) {
+        (options != v8::ScriptCompiler::CompileOptions::kConsumeCodeCache ||
+         rejected)) {
       v8::ScriptCompiler::CachedData* codeCache =
           v8::ScriptCompiler::CreateCodeCache(unbound);
       if (codeCache) {
@@ -0,0 +1,405 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// Consumer-side definition of MappedFileBuffer and FilePreparedScriptStore.
+// See FileScriptStore.h.
+
+#include "FileScriptStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace v8runtime {
+
+//==============================================================================
+// MappedFileBuffer
+//==============================================================================
+
+std::shared_ptr<MappedFileBuffer> MappedFileBuffer::open(
+    const std::filesystem::path &path,
+    size_t offset) noexcept {
+  const uint8_t *mapping = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  // FILE_SHARE_DELETE lets FilePreparedScriptStore rename an entry that is
+  // still mapped. Windows still refuses to delete or replace it while the view
+  // is open, so the store moves such an entry aside instead (discardEntry).
+  HANDLE file = ::CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_DELETE,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return nullptr;
+  LARGE_INTEGER fileSize{};
+  if (::GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (HANDLE section = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+      mapping = static_cast<const uint8_t *>(::MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0));
+      // The view keeps the section alive.
+      ::CloseHandle(section);
+    }
+  }
+  ::CloseHandle(file);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return nullptr;
+  struct stat fileInfo;
+  if (::fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0) {
+    size = static_cast<size_t>(fileInfo.st_size);
+    void *result = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (result != MAP_FAILED)
+      mapping = static_cast<const uint8_t *>(result);
+  }
+  // The mapping keeps the file alive.
+  ::close(fd);
+#endif
+  if (!mapping) {
+    // An empty file has nothing to map.
+    static const uint8_t empty = 0;
+    if (size != 0 || offset != 0)
+      return nullptr;
+    return std::shared_ptr<MappedFileBuffer>(new MappedFileBuffer(&empty, 0, 0));
+  }
+  std::shared_ptr<MappedFileBuffer> buffer(new MappedFileBuffer(mapping, size, 0));
+  if (offset > size)
+    return nullptr;
+  buffer->offset_ = offset;
+  return buffer;
+}
+
+MappedFileBuffer::~MappedFileBuffer() {
+  if (mappingSize_ == 0)
+    return;
+#ifdef _WIN32
+  ::UnmapViewOfFile(mapping_);
+#else
+  ::munmap(const_cast<uint8_t *>(mapping_), mappingSize_);
+#endif
+}
+
+//==============================================================================
+// FilePreparedScriptStore
+//==============================================================================
+
+namespace {
+
+constexpr const char *kEntryExtension = ".v8cache";
+// Follows kEntryExtension in the name of an entry discardEntry could not delete.
+constexpr const char *kStaleInfix = ".stale";
+constexpr uint32_t kEntryMagic = 0x434a3856; // "V8JC"
+constexpr uint32_t kEntryFormatVersion = 1;
+// V8 copies a code cache that is not pointer-aligned before deserializing it.
+constexpr size_t kPayloadAlignment = 16;
+
+// Precedes the key and the payload in every entry file.
+struct EntryHeader {
+  uint32_t magic;
+  uint32_t formatVersion;
+  uint64_t payloadSize;
+  uint64_t payloadChecksum;
+  uint32_t keySize;
+  uint32_t reserved;
+};
+
+// 64-bit FNV-1a over 8-byte words, with the tail folded in a byte at a time.
+// Catches torn and bit-flipped files; not meant to resist tampering.
+uint64_t checksum(const uint8_t *data, size_t size) noexcept {
+  constexpr uint64_t kPrime = 0x100000001b3ull;
+  uint64_t hash = 0xcbf29ce484222325ull ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; ++i)
+    hash = (hash ^ data[i]) * kPrime;
+  return hash ^ (hash >> 32);
+}
+
+std::string entryKey(
+    const facebook::jsi::ScriptSignature &scriptSignature,
+    const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) {
+  return scriptSignature.url + '\n' + std::to_string(scriptSignature.version) + '\n' + runtimeSignature.runtimeName +
+      '\n' + std::to_string(runtimeSignature.version) + '\n' + (prepareTag ? prepareTag : "");
+}
+
+std::filesystem::path entryPath(const std::filesystem::path &directory, const std::string &key) {
+  char name[17];
+  std::snprintf(
+      name,
+      sizeof(name),
+      "%016llx",
+      static_cast<unsigned long long>(checksum(reinterpret_cast<const uint8_t *>(key.data()), key.size())));
+  return directory / (std::string(name) + kEntryExtension);
+}
+
+size_t payloadOffset(size_t keySize) noexcept {
+  size_t end = sizeof(EntryHeader) + keySize;
+  return (end + kPayloadAlignment - 1) / kPayloadAlignment * kPayloadAlignment;
+}
+
+// Identifies the payload of the entry at path for FilePreparedScriptStore's
+// set of verified entries. An entry rewritten with another payload gets
+// another id.
+std::string verificationId(const std::filesystem::path &path, const EntryHeader &header) {
+  return path.filename().string() + ':' + std::to_string(header.payloadSize) + ':' +
+      std::to_string(header.payloadChecksum);
+}
+
+// A name next to path, unique to this process and call, made of path, infix
+// and a counter.
+std::filesystem::path siblingPath(const std::filesystem::path &path, const char *infix) {
+  static std::atomic<uint32_t> next{0};
+#ifdef _WIN32
+  const unsigned long processId = ::GetCurrentProcessId();
+#else
+  const unsigned long processId = static_cast<unsigned long>(::getpid());
+#endif
+  std::filesystem::path result = path;
+  result += infix + std::to_string(processId) + "-" + std::to_string(next++);
+  return result;
+}
+
+// Deletes the entry at path. Windows refuses while a MappedFileBuffer still
+// maps it; the entry is then renamed to a stale name, so that it is no longer
+// loaded, and removeStaleFiles deletes it once it is unmapped. Returns true if
+// the entry is gone from disk.
+bool discardEntry(const std::filesystem::path &path) {
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  if (!ec)
+    return true;
+  std::filesystem::rename(path, siblingPath(path, kStaleInfix), ec);
+  return false;
+}
+
+// Deletes the entries discardEntry renamed, unless they are still mapped.
+void removeStaleFiles(const std::filesystem::path &directory) {
+  std::vector<std::filesystem::path> stale;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+    if (it->path().filename().string().find(kStaleInfix) != std::string::npos)
+      stale.push_back(it->path());
+  }
+  for (const std::filesystem::path &path : stale)
+    std::filesystem::remove(path, ec);
+}
+
+} // namespace
+
+FilePreparedScriptStore::FilePreparedScriptStore(std::filesystem::path directory, uint64_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  removeStaleFiles(directory_);
+}
+
+std::shared_ptr<const facebook::jsi::Buffer> FilePreparedScriptStore::tryGetPreparedScript(
+    const facebook::jsi::ScriptSignature &scriptSignature,
+    const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) noexcept {
+  try {
+    const std::string key = entryKey(scriptSignature, runtimeSignature, prepareTag);
+    const std::filesystem::path path = entryPath(directory_, key);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec))
+      return nullptr;
+
+    // The header and the key precede the payload in the mapping.
+    const size_t offset = payloadOffset(key.size());
+    std::shared_ptr<MappedFileBuffer> file = MappedFileBuffer::open(path, offset);
+    bool valid = file != nullptr;
+    std::string verifiedId;
+    if (valid) {
+      const uint8_t *start = file->data() - offset;
+      EntryHeader header;
+      std::memcpy(&header, start, sizeof(header));
+      valid = header.magic == kEntryMagic && header.formatVersion == kEntryFormatVersion &&
+          header.keySize == key.size() && header.payloadSize == file->size() &&
+          std::memcmp(start + sizeof(header), key.data(), key.size()) == 0;
+      // Reading the whole payload would page in the mapping before V8 needs
+      // it, so it is checked only the first time this store loads the entry.
+      if (valid) {
+        verifiedId = verificationId(path, header);
+        if (!isVerified(verifiedId)) {
+          valid = header.payloadChecksum == checksum(file->data(), file->size());
+          if (valid)
+            markVerified(verifiedId);
+        }
+      }
+    }
+    if (!valid) {
+      // A torn or corrupted entry (or a hash collision) is replaced on the
+      // next persist.
+      file.reset();
+      discardEntry(path);
+      return nullptr;
+    }
+
+    // The modification time orders entries for trim().
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return file;
+  } catch (const std::exception &) {
+    // Out of memory, or a path the file system cannot represent.
+    return nullptr;
+  }
+}
+
+void FilePreparedScriptStore::persistPreparedScript(
+    std::shared_ptr<const facebook::jsi::Buffer> preparedScript,
+    const facebook::jsi::ScriptSignature &scriptSignature,
+    const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+    const char *prepareTag) noexcept {
+  if (!preparedScript)
+    return;
+  try {
+    const std::string key = entryKey(scriptSignature, runtimeSignature, prepareTag);
+    const std::filesystem::path path = entryPath(directory_, key);
+
+    // Concurrent writers (other runtimes, other processes) each use their own
+    // temporary file; the last rename wins.
+    const std::filesystem::path temp = siblingPath(path, ".tmp");
+
+    EntryHeader header{};
+    header.magic = kEntryMagic;
+    header.formatVersion = kEntryFormatVersion;
+    header.payloadSize = preparedScript->size();
+    header.payloadChecksum = checksum(preparedScript->data(), preparedScript->size());
+    header.keySize = static_cast<uint32_t>(key.size());
+    const char padding[kPayloadAlignment] = {};
+    const size_t paddingSize = payloadOffset(key.size()) - sizeof(header) - key.size();
+
+#ifdef _WIN32
+    FILE *out = ::_wfopen(temp.c_str(), L"wb");
+#else
+    FILE *out = std::fopen(temp.c_str(), "wb");
+#endif
+    if (!out)
+      return;
+    bool written = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+        std::fwrite(key.data(), 1, key.size(), out) == key.size() &&
+        std::fwrite(padding, 1, paddingSize, out) == paddingSize &&
+        std::fwrite(preparedScript->data(), 1, preparedScript->size(), out) == preparedScript->size();
+    written = std::fclose(out) == 0 && written;
+
+    std::error_code ec;
+    if (written) {
+      std::filesystem::rename(temp, path, ec);
+      if (ec) {
+        // Windows does not replace a file that is still mapped, but it does
+        // let it be renamed: move the old entry aside and try again.
+        discardEntry(path);
+        ec.clear();
+        std::filesystem::rename(temp, path, ec);
+      }
+    }
+    if (!written || ec) {
+      std::filesystem::remove(temp, ec);
+      return;
+    }
+    // This store wrote the payload it would check.
+    markVerified(verificationId(path, header));
+  } catch (const std::exception &) {
+    return;
+  }
+  if (maxBytes_ != 0)
+    trim();
+}
+
+uint64_t FilePreparedScriptStore::sizeOnDisk() const noexcept {
+  std::error_code ec;
+  uint64_t total = 0;
+  try {
+    for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+      if (it->path().extension() == kEntryExtension) {
+        std::error_code sizeError;
+        uint64_t size = it->file_size(sizeError);
+        if (!sizeError)
+          total += size;
+      }
+    }
+  } catch (const std::exception &) {
+    // Counts the entries seen so far.
+  }
+  return total;
+}
+
+void FilePreparedScriptStore::trim() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    removeStaleFiles(directory_);
+
+    struct Entry {
+      std::filesystem::file_time_type lastUse;
+      uint64_t size;
+      std::filesystem::path path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+      if (it->path().extension() != kEntryExtension)
+        continue;
+      std::error_code entryError;
+      Entry entry{it->last_write_time(entryError), it->file_size(entryError), it->path()};
+      if (entryError)
+        continue;
+      total += entry.size;
+      entries.push_back(std::move(entry));
+    }
+    if (total <= maxBytes_)
+      return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.lastUse < b.lastUse; });
+    for (const Entry &entry : entries) {
+      if (total <= maxBytes_)
+        break;
+      // An entry that is still mapped stays on disk under a stale name until
+      // a later trim, but is no longer loaded.
+      if (discardEntry(entry.path))
+        total -= entry.size;
+    }
+  } catch (const std::exception &) {
+    // The next persist trims again.
+  }
+}
+
+bool FilePreparedScriptStore::isVerified(const std::string &id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return verified_.count(id) != 0;
+}
+
+void FilePreparedScriptStore::markVerified(std::string id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  verified_.insert(std::move(id));
+}
+
+} // namespace v8runtime
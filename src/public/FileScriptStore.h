@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+//
+// File-backed script loading for embedders that do not bring their own.
+//
+// MappedFileBuffer maps a file read-only into memory as a facebook::jsi::Buffer.
+// A bundle loaded this way is never read into the heap or copied: the OS pages
+// it in as V8 reads it and can drop the clean pages again under memory
+// pressure.
+//
+// FilePreparedScriptStore is a PreparedScriptStore that keeps each code cache
+// in its own file in a directory, named after a hash of its full key (source
+// URL, source hash or version, V8's CachedDataVersionTag and the prepare tag)
+// and handed back to V8 as a MappedFileBuffer. Files are written to a
+// temporary name and renamed into place, so a crash mid-write never leaves a
+// partial entry behind; each carries its key, checked on every load, and a
+// checksum of its payload, checked the first time the store loads it so that
+// later loads leave the mapping to be paged in as V8 reads it. An entry that
+// fails a check is deleted so the next run stores it again. With a size
+// limit, the least recently used entries are deleted once the directory grows
+// past it. On Windows an entry that is still mapped cannot be deleted or
+// replaced; it is renamed aside instead, and deleted once it is unmapped.
+//
+// Like V8JsiRuntime.cpp, FileScriptStore.cpp ships as source and is compiled
+// by the consumer.
+
+#pragma once
+
+#include <jsi/jsi.h>
+#include "ScriptStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace v8runtime {
+
+class MappedFileBuffer final : public facebook::jsi::Buffer {
+ public:
+  // Maps the file at path and exposes its bytes from offset on. Returns null
+  // if the file cannot be opened or mapped, or is shorter than offset.
+  static std::shared_ptr<MappedFileBuffer> open(const std::filesystem::path &path, size_t offset = 0) noexcept;
+
+  ~MappedFileBuffer() override;
+
+  MappedFileBuffer(const MappedFileBuffer &) = delete;
+  MappedFileBuffer &operator=(const MappedFileBuffer &) = delete;
+
+  const uint8_t *data() const override {
+    return mapping_ + offset_;
+  }
+  size_t size() const override {
+    return mappingSize_ - offset_;
+  }
+
+ private:
+  MappedFileBuffer(const uint8_t *mapping, size_t mappingSize, size_t offset) noexcept
+      : mapping_(mapping), mappingSize_(mappingSize), offset_(offset) {}
+
+  const uint8_t *mapping_;
+  size_t mappingSize_;
+  size_t offset_;
+};
+
+class FilePreparedScriptStore final : public facebook::jsi::PreparedScriptStore {
+ public:
+  // Stores code caches in directory, which is created if it does not exist.
+  // Once its entries add up to more than maxBytes, the least recently used
+  // ones are deleted; 0 means no limit.
+  explicit FilePreparedScriptStore(std::filesystem::path directory, uint64_t maxBytes = 0);
+
+  std::shared_ptr<const facebook::jsi::Buffer> tryGetPreparedScript(
+      const facebook::jsi::ScriptSignature &scriptSignature,
+      const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag) noexcept override;
+
+  void persistPreparedScript(
+      std::shared_ptr<const facebook::jsi::Buffer> preparedScript,
+      const facebook::jsi::ScriptSignature &scriptSignature,
+      const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag) noexcept override;
+
+  // Total size of the entries in the directory.
+  uint64_t sizeOnDisk() const noexcept;
+
+ private:
+  // Deletes the least recently used entries until the rest fit in maxBytes_.
+  void trim() noexcept;
+
+  bool isVerified(const std::string &id) const;
+  void markVerified(std::string id);
+
+  const std::filesystem::path directory_;
+  const uint64_t maxBytes_;
+  mutable std::mutex mutex_;
+  // Entries whose payload checksum this store has checked or written, by
+  // verificationId.
+  std::unordered_set<std::string> verified_;
+};
+
+} // namespace v8runtime
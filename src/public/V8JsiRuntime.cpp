@@ -7,11 +7,14 @@
 // (see also include/node-api-jsi/NodeApiJsiRuntime.cpp for the same pattern).
 // The consumer compiles it locally; only the C-stable v8_jsi_config_* setters,
 // the v8_create_runtime entry point, and the JsiAbiRuntime C++ wrapper (also
-// compiled in the consumer) cross into v8jsi.dll.
+// compiled in the consumer) cross into v8jsi.dll. The opt-in
+// flags.directRuntime path is the exception: v8_create_direct_runtime is a C
+// export too, but the runtime it returns is a C++ object owned by v8jsi.dll.
 
 #include "V8JsiRuntime.h"
 
 #include "jsi_abi/JsiAbiRuntime.h"
+#include "jsi_abi/V8DirectRuntime.h"
 #include "jsi_abi/v8_jsi_config.h"
 #include "ScriptStore.h"
 
@@ -66,20 +69,27 @@ class V8ScriptCache {
  public:
   static void Create(
       jsi_config config,
-      std::shared_ptr<facebook::jsi::PreparedScriptStore> scriptStore) {
+      std::shared_ptr<facebook::jsi::PreparedScriptStore> scriptStore,
+      std::shared_ptr<PreparedScriptRejectionListener> rejectionListener) {
+    const bool listen = rejectionListener != nullptr;
     v8_jsi_config_set_script_cache(
         config,
-        new V8ScriptCache(std::move(scriptStore)),
+        new V8ScriptCache(std::move(scriptStore), std::move(rejectionListener)),
         &LoadScript,
         &StoreScript,
         &Delete,
         nullptr);
+    if (listen) {
+      v8_jsi_config_set_script_cache_reject_cb(config, &RejectScript);
+    }
   }
 
  private:
-  explicit V8ScriptCache(
-      std::shared_ptr<facebook::jsi::PreparedScriptStore> scriptStore)
-      : scriptStore_(std::move(scriptStore)) {}
+  V8ScriptCache(
+      std::shared_ptr<facebook::jsi::PreparedScriptStore> scriptStore,
+      std::shared_ptr<PreparedScriptRejectionListener> rejectionListener)
+      : scriptStore_(std::move(scriptStore)),
+        rejectionListener_(std::move(rejectionListener)) {}
 
   static void __cdecl LoadScript(
       void *scriptCache,
@@ -137,11 +147,87 @@ class V8ScriptCache {
         cacheTag);
   }
 
+  static void __cdecl RejectScript(
+      void *scriptCache,
+      const char *sourceUrl,
+      uint64_t sourceHash,
+      const char *runtimeName,
+      uint64_t runtimeVersion,
+      const char *cacheTag,
+      int reason) {
+    reinterpret_cast<V8ScriptCache *>(scriptCache)
+        ->rejectionListener_->onPreparedScriptRejected(
+            facebook::jsi::ScriptSignature{sourceUrl, sourceHash},
+            facebook::jsi::JSRuntimeSignature{runtimeName, runtimeVersion},
+            cacheTag,
+            static_cast<PreparedScriptRejectReason>(reason));
+  }
+
   static void __cdecl Delete(void *scriptCache, void * /*deleterData*/) {
     delete reinterpret_cast<V8ScriptCache *>(scriptCache);
   }
 
   std::shared_ptr<facebook::jsi::PreparedScriptStore> scriptStore_;
+  std::shared_ptr<PreparedScriptRejectionListener> rejectionListener_;
+};
+
+// Adapter from the consumer's std::shared_ptr<facebook::jsi::ScriptStore> to
+// the C-callback shape expected by v8_jsi_config_set_script_store. Like
+// V8ScriptCache, it lives entirely in the consumer's CRT; so does each
+// VersionedScript handed to the DLL, which releases it through its vtable.
+class V8ScriptStore {
+ public:
+  static void Create(
+      jsi_config config,
+      std::shared_ptr<facebook::jsi::ScriptStore> scriptStore) {
+    v8_jsi_config_set_script_store(
+        config,
+        new V8ScriptStore(std::move(scriptStore)),
+        &LoadScript,
+        &Delete,
+        nullptr);
+  }
+
+ private:
+  struct VersionedScript : jsi_buffer {
+    explicit VersionedScript(std::shared_ptr<const facebook::jsi::Buffer> buf)
+        : buffer(std::move(buf)) {
+      static const jsi_buffer_vtable bufVt{&Release};
+      vtable = const_cast<jsi_buffer_vtable *>(&bufVt);
+      data = buffer->data();
+      size = buffer->size();
+    }
+
+    static void __cdecl Release(jsi_buffer *self) {
+      delete static_cast<VersionedScript *>(self);
+    }
+
+    std::shared_ptr<const facebook::jsi::Buffer> buffer;
+  };
+
+  explicit V8ScriptStore(std::shared_ptr<facebook::jsi::ScriptStore> scriptStore)
+      : scriptStore_(std::move(scriptStore)) {}
+
+  static jsi_buffer *__cdecl LoadScript(
+      void *scriptStore,
+      const char *sourceUrl,
+      uint64_t *version) {
+    facebook::jsi::VersionedBuffer script =
+        reinterpret_cast<V8ScriptStore *>(scriptStore)
+            ->scriptStore_->getVersionedScript(sourceUrl);
+    if (!script.buffer) {
+      *version = 0;
+      return nullptr;
+    }
+    *version = script.version;
+    return new VersionedScript(std::move(script.buffer));
+  }
+
+  static void __cdecl Delete(void *scriptStore, void * /*deleterData*/) {
+    delete reinterpret_cast<V8ScriptStore *>(scriptStore);
+  }
+
+  std::shared_ptr<facebook::jsi::ScriptStore> scriptStore_;
 };
 
 // Adapter from the consumer's std::shared_ptr<JSITaskRunner> to the C-callback
@@ -236,6 +322,13 @@ void applyArgs(jsi_config cfg, const V8RuntimeArgs &args) {
       cfg, args.flags.ignoreUnhandledPromises);
   v8_jsi_config_enable_gc_api(cfg, args.flags.enableGCApi);
   v8_jsi_config_enable_multi_thread(cfg, args.flags.enableMultiThread);
+  v8_jsi_config_enable_background_code_cache(
+      cfg, args.flags.backgroundCodeCache);
+  v8_jsi_config_enable_warm_code_cache(cfg, args.flags.warmCodeCache);
+  v8_jsi_config_set_warm_code_cache_delay(cfg, args.warmCodeCacheDelayMs);
+  v8_jsi_config_set_compiled_script_cache_size(
+      cfg, args.compiledScriptCacheBytes);
+  v8_jsi_config_enable_lazy_script_source(cfg, args.flags.lazyScriptSource);
   v8_jsi_config_enable_jit_tracing(cfg, args.flags.enableJitTracing);
   v8_jsi_config_enable_message_tracing(cfg, args.flags.enableMessageTracing);
   v8_jsi_config_enable_gc_tracing(cfg, args.flags.enableGCTracing);
@@ -245,7 +338,11 @@ void applyArgs(jsi_config cfg, const V8RuntimeArgs &args) {
   // always_compact, jitless, lite_mode) are NOT set here — they go through the
   // process-level v8_jsi_set_v8_flags in makeV8Runtime (see applyV8Flags).
   if (args.preparedScriptStore) {
-    V8ScriptCache::Create(cfg, args.preparedScriptStore);
+    V8ScriptCache::Create(
+        cfg, args.preparedScriptStore, args.preparedScriptRejectionListener);
+  }
+  if (args.scriptStore) {
+    V8ScriptStore::Create(cfg, args.scriptStore);
   }
   if (args.foreground_task_runner) {
     V8TaskRunner::Create(cfg, args.foreground_task_runner);
@@ -314,6 +411,8 @@ std::unique_ptr<facebook::jsi::Runtime> __cdecl makeV8Runtime(
   // Process-global engine flags must be set before the first runtime triggers
   // V8 init; per-runtime config flows through the configure callback.
   applyV8Flags(args);
+  if (args.flags.directRuntime)
+    return makeV8DirectRuntime(&configureFromArgs, &args);
   return ::jsi::abi::makeJsiAbiRuntime(
       &v8_create_runtime, &configureFromArgs, &args);
 }
@@ -20,7 +20,10 @@
 namespace facebook {
 namespace jsi {
 
+struct JSRuntimeSignature;
 struct PreparedScriptStore;
+struct ScriptSignature;
+struct ScriptStore;
 
 } // namespace jsi
 } // namespace facebook
@@ -37,12 +40,46 @@ struct JSITaskRunner {
   virtual void postTask(std::unique_ptr<JSITask> task) = 0;
 };
 
+// Why V8 rejected a prepared script loaded from a PreparedScriptStore. Values
+// match v8_jsi_code_cache_reject_reason (jsi_abi/v8_jsi_config.h).
+enum class PreparedScriptRejectReason : int {
+  MagicNumberMismatch = 1, // not a V8 code cache
+  VersionMismatch = 2, // made by another V8 version
+  SourceMismatch = 3, // made from another source
+  FlagsMismatch = 5, // made with other V8 flags
+  ChecksumMismatch = 6, // corrupt
+  InvalidHeader = 7,
+  LengthMismatch = 8, // truncated
+  SnapshotMismatch = 9, // made with another startup snapshot
+};
+
+// Told when V8 rejects a prepared script from the PreparedScriptStore. The runtime then compiles the source and
+// persists a fresh prepared script under the same signatures right after onPreparedScriptRejected returns.
+struct PreparedScriptRejectionListener {
+  virtual ~PreparedScriptRejectionListener() = default;
+  virtual void onPreparedScriptRejected(
+      const facebook::jsi::ScriptSignature &scriptSignature,
+      const facebook::jsi::JSRuntimeSignature &runtimeSignature,
+      const char *prepareTag,
+      PreparedScriptRejectReason reason) noexcept = 0;
+};
+
 struct V8RuntimeArgs {
-  // This is only used by the debugger: inspector needs to wake up the js thread for message dispatching
+  // Used by the debugger: inspector needs to wake up the js thread for message dispatching
   // It cannot be done in an asynchronous lambda because V8Inspector internally uses "main thread" handles
+  // jsi::abi::prepareJavaScriptAsync (jsi_abi/AsyncPrepareRuntime.h) also completes on this runner.
   std::shared_ptr<JSITaskRunner> foreground_task_runner; // foreground === js_thread => sequential
   std::shared_ptr<facebook::jsi::PreparedScriptStore> preparedScriptStore;
 
+  // Optional; only used with a preparedScriptStore. A store may implement both interfaces.
+  std::shared_ptr<PreparedScriptRejectionListener> preparedScriptRejectionListener;
+
+  // Optional source of versioned scripts, loaded by URL through
+  // jsi::abi::evaluateJavaScriptFromStore (jsi_abi/ScriptStoreRuntime.h). A
+  // non-zero ScriptVersion_t keys the preparedScriptStore lookup in place of a
+  // hash of the source.
+  std::shared_ptr<facebook::jsi::ScriptStore> scriptStore;
+
   // Optional V8 startup-snapshot blob. When set, the isolate is created from it
   // (Isolate::CreateParams::snapshot_blob) instead of the engine's built-in
   // startup data, so the heap is pre-populated and the embedded script need not
@@ -76,6 +113,14 @@ struct V8RuntimeArgs {
   size_t initial_heap_size_in_bytes{0};
   size_t maximum_heap_size_in_bytes{0};
 
+  // With flags.warmCodeCache, startup also completes this many milliseconds after the first script is prepared.
+  // 0 waits for jsi::abi::notifyStartupComplete. Needs a foreground_task_runner.
+  uint32_t warmCodeCacheDelayMs{0};
+
+  // Scripts prepared in the runtime are kept, up to this many bytes of source, so that preparing the same source
+  // again reuses the compiled script instead of deserializing its code cache. 0 disables the cache.
+  size_t compiledScriptCacheBytes{0};
+
   // Set this to override the target name displayed in the debugger (to distinguish multiple parallel runtimes)
   std::string debuggerRuntimeName;
 
@@ -103,6 +148,25 @@ struct V8RuntimeArgs {
       bool enableMultiThread : 1; // if true, enables the use of v8::Locker for multi-threaded Isolate access
       bool explicitMicrotaskPolicy : 1; // if true, enables the use of v8::MicrotasksPolicy::kExplicit
 
+      // if true, returns a runtime implemented directly on V8 inside v8jsi.dll instead of the
+      // ABI-safe JsiAbiRuntime wrapper. Only valid when the consumer is built against the same
+      // JSI_VERSION and C++ runtime as v8jsi.dll (see jsi_abi/V8DirectRuntime.h).
+      bool directRuntime : 1;
+
+      // if true, a code cache loaded from the PreparedScriptStore is deserialized on a V8 worker
+      // thread, and the JS thread only finalizes the prepared script.
+      bool backgroundCodeCache : 1;
+
+      // if true, the code cache of each script prepared during startup is stored again once startup completes, now
+      // covering the functions startup ran. Startup completes at jsi::abi::notifyStartupComplete
+      // (jsi_abi/StartupCompleteRuntime.h) or after warmCodeCacheDelayMs. Needs a preparedScriptStore.
+      bool warmCodeCache : 1;
+
+      // if true, a versioned script prepared from the scriptStore drops its source once compiled, and the source is
+      // loaded from the store again only if V8 reads it (lazy compilation, Function.prototype.toString, debugger).
+      // The store must keep serving the same version, possibly from a V8 worker thread.
+      bool lazyScriptSource : 1;
+
       // caps the number of worker threads (trade fewer threads for time)
       std::uint8_t thread_pool_size; // by default (0) V8 uses min(N-1,16) where N = number of cores
     } flags;
@@ -1,7 +1,11 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT license.
 #include <gtest/gtest.h>
+#include <jsi/instrumentation.h>
 #include <jsi/jsi.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <thread>
 #include "jsi/test/testlib.h"
 #include "node-api-jsi/ApiLoaders/V8Api.h"
@@ -141,6 +145,206 @@ TEST(Basic, MultiThreadIsolateNodeApi) {
     vec_thr.at(i).join();
   }
 }
+
+// Contention benchmark for NodeApiPendingDeletions: background threads release jsi values while the JS thread keeps
+// draining the pending-deletion list. Run with --gtest_also_run_disabled_tests.
+TEST(Basic, DISABLED_PendingDeletionsContentionNodeApi) {
+  V8Api *v8Api = V8Api::fromLib();
+  V8Api::setCurrent(v8Api);
+
+  jsr_config config{};
+  jsr_runtime runtime{};
+  napi_env env{};
+  v8Api->jsr_create_config(&config);
+  v8Api->jsr_create_runtime(config, &runtime);
+  v8Api->jsr_delete_config(config);
+  v8Api->jsr_runtime_get_node_api_env(runtime, &env);
+
+  std::unique_ptr<facebook::jsi::Runtime> jsiRuntime;
+  {
+    NodeApiEnvScope envScope{env};
+    jsiRuntime = makeNodeApiJsiRuntime(env, v8Api, [runtime]() { V8Api::current()->jsr_delete_runtime(runtime); });
+  }
+  Runtime &rt = *jsiRuntime;
+
+  constexpr size_t valueCount = 160000;
+  for (size_t threadCount : {1, 4, 16}) {
+    std::vector<std::vector<Object>> values(threadCount);
+    for (size_t i = 0; i < valueCount; ++i) {
+      values[i % threadCount].push_back(Object(rt));
+    }
+
+    std::atomic<size_t> runningThreads{threadCount};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> releasingThreads;
+    for (auto &threadValues : values) {
+      releasingThreads.push_back(std::thread([&threadValues, &runningThreads]() {
+        threadValues.clear();
+        --runningThreads;
+      }));
+    }
+
+    // Every runtime call closes a scope, which drains the pending deletions on the JS thread.
+    while (runningThreads > 0) {
+      rt.global();
+    }
+    for (auto &thread : releasingThreads) {
+      thread.join();
+    }
+    rt.global();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    printf(
+        "[ BENCH    ] %zu releasing thread(s): %.1f ns per released value\n",
+        threadCount,
+        std::chrono::duration<double, std::nano>(elapsed).count() / valueCount);
+  }
+}
+
+namespace {
+
+std::unique_ptr<facebook::jsi::Runtime> makeNodeApiRuntime() {
+  V8Api *v8Api = V8Api::fromLib();
+  V8Api::setCurrent(v8Api);
+
+  jsr_config config{};
+  jsr_runtime runtime{};
+  napi_env env{};
+  v8Api->jsr_create_config(&config);
+  v8Api->jsr_create_runtime(config, &runtime);
+  v8Api->jsr_delete_config(config);
+  v8Api->jsr_runtime_get_node_api_env(runtime, &env);
+
+  NodeApiEnvScope envScope{env};
+  return makeNodeApiJsiRuntime(env, v8Api, [runtime]() { V8Api::current()->jsr_delete_runtime(runtime); });
+}
+
+int64_t heapInfoValue(Runtime &rt, const char *key) {
+  auto heapInfo = rt.instrumentation().getHeapInfo(false);
+  auto it = heapInfo.find(key);
+  EXPECT_NE(it, heapInfo.end()) << key;
+  return it != heapInfo.end() ? it->second : 0;
+}
+
+} // namespace
+
+TEST(Basic, PropNameIDCacheCountsHitsAndMissesNodeApi) {
+  auto runtime = makeNodeApiRuntime();
+  Runtime &rt = *runtime;
+
+  int64_t hits = heapInfoValue(rt, "propNameIDCacheHits");
+  int64_t misses = heapInfoValue(rt, "propNameIDCacheMisses");
+  int64_t size = heapInfoValue(rt, "propNameIDCacheSize");
+
+  PropNameID first = PropNameID::forAscii(rt, "cachedName");
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheMisses"), misses + 1);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheHits"), hits);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheSize"), size + 1);
+
+  PropNameID second = PropNameID::forAscii(rt, "cachedName");
+  PropNameID third = PropNameID::forUtf8(rt, "cachedName");
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheMisses"), misses + 1);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheHits"), hits + 2);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheSize"), size + 1);
+  EXPECT_TRUE(PropNameID::compare(rt, first, second));
+  EXPECT_TRUE(PropNameID::compare(rt, first, third));
+}
+
+// The cache keeps at most 4096 names; each name past that evicts the least recently used one.
+TEST(Basic, PropNameIDCacheEvictsAtCapacityNodeApi) {
+  auto runtime = makeNodeApiRuntime();
+  Runtime &rt = *runtime;
+
+  constexpr int64_t capacity = 4096;
+  constexpr int64_t nameCount = capacity + 100;
+  int64_t size = heapInfoValue(rt, "propNameIDCacheSize");
+  int64_t evictions = heapInfoValue(rt, "propNameIDCacheEvictions");
+
+  PropNameID::forAscii(rt, "name0");
+  for (int64_t i = 1; i < nameCount; ++i) {
+    // Keep name0 the most recently used name, so that it is never evicted.
+    PropNameID::forAscii(rt, "name0");
+    PropNameID::forAscii(rt, "name" + std::to_string(i));
+  }
+
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheSize"), capacity);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheEvictions"), evictions + size + nameCount - capacity);
+
+  int64_t misses = heapInfoValue(rt, "propNameIDCacheMisses");
+  PropNameID::forAscii(rt, "name0");
+  PropNameID::forAscii(rt, "name" + std::to_string(nameCount - 1));
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheMisses"), misses);
+  PropNameID::forAscii(rt, "name1");
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheMisses"), misses + 1);
+}
+
+// Names not used for 60 seconds are evicted by the next sweep; names used since are kept.
+TEST(Basic, PropNameIDCacheSweepsOldNamesNodeApi) {
+  auto runtime = makeNodeApiRuntime();
+  Runtime &rt = *runtime;
+
+  for (int i = 0; i < 100; ++i) {
+    PropNameID::forAscii(rt, "old" + std::to_string(i));
+  }
+  int64_t size = heapInfoValue(rt, "propNameIDCacheSize");
+  int64_t evictions = heapInfoValue(rt, "propNameIDCacheEvictions");
+
+  sweepNodeApiJsiPropNameIDCaches(rt, std::chrono::seconds(30));
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheSize"), size);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheEvictions"), evictions);
+
+  // Used after the sweep above, so 31 seconds old at the next one.
+  PropNameID::forAscii(rt, "old0");
+  sweepNodeApiJsiPropNameIDCaches(rt, std::chrono::seconds(61));
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheSize"), 1);
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheEvictions"), evictions + size - 1);
+
+  int64_t misses = heapInfoValue(rt, "propNameIDCacheMisses");
+  PropNameID::forAscii(rt, "old0");
+  PropNameID::forAscii(rt, "old1");
+  EXPECT_EQ(heapInfoValue(rt, "propNameIDCacheMisses"), misses + 1);
+}
+
+// Values created and dropped in rounds reuse the slots of the pointer value pool: after the first round, neither the
+// slabs nor the peak number of live values grow.
+TEST(Basic, PointerValuePoolReusesSlotsNodeApi) {
+  auto runtime = makeNodeApiRuntime();
+  Runtime &rt = *runtime;
+
+  constexpr size_t valueCount = 10000;
+  auto runRound = [&rt]() {
+    std::vector<Object> values;
+    values.reserve(valueCount);
+    for (size_t i = 0; i < valueCount; ++i) {
+      values.push_back(Object(rt));
+    }
+    values.clear();
+    // Closing the scope of a runtime call deletes the dropped values.
+    rt.global();
+  };
+
+  runRound();
+  int64_t allocations = heapInfoValue(rt, "pointerValueAllocations");
+  int64_t live = heapInfoValue(rt, "pointerValuesLive");
+  int64_t peak = heapInfoValue(rt, "pointerValuesPeak");
+  int64_t slabs = heapInfoValue(rt, "pointerValueSlabs");
+  EXPECT_GE(peak, static_cast<int64_t>(valueCount));
+
+  for (int round = 0; round < 10; ++round) {
+    runRound();
+    EXPECT_EQ(heapInfoValue(rt, "pointerValuesLive"), live);
+    EXPECT_EQ(heapInfoValue(rt, "pointerValuesPeak"), peak);
+    EXPECT_EQ(heapInfoValue(rt, "pointerValueSlabs"), slabs);
+  }
+  EXPECT_GE(heapInfoValue(rt, "pointerValueAllocations"), allocations + 10 * static_cast<int64_t>(valueCount));
+
+  // The cached names are destroyed after the runtime drops its reference to the pool, so destroy() must keep the
+  // pool alive until their slots are returned.
+  for (int i = 0; i < 1000; ++i) {
+    PropNameID::forAscii(rt, "name" + std::to_string(i));
+  }
+  runtime.reset();
+}
 #endif
 
 int main(int argc, char **argv) {
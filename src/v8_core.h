@@ -101,6 +101,13 @@ class V8PlatformHolder {
     return is_initialized_ && !is_disposed_;
   }
 
+  /// The platform, or null if it is not initialized. Used to post work to
+  /// V8's worker threads.
+  static v8::Platform* platform() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return platform_.get();
+  }
+
   V8PlatformHolder() = delete;
   V8PlatformHolder(const V8PlatformHolder&) = delete;
   V8PlatformHolder& operator=(const V8PlatformHolder&) = delete;
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+/// \file v8_script_streaming.cpp
+/// \brief Off-thread script compilation and code cache deserialization.
+
+#include "v8_script_streaming.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace v8rt {
+
+//==============================================================================
+// BackgroundScriptJob
+//==============================================================================
+
+class BackgroundScriptJob::WorkerTask final : public v8::Task {
+ public:
+  explicit WorkerTask(BackgroundScriptJob* job) : job_(job) {}
+  void Run() override { job_->run(); }
+
+ private:
+  // The job outlives the task's Run: its destructor waits for it.
+  BackgroundScriptJob* job_;
+};
+
+BackgroundScriptJob::BackgroundScriptJob(
+    std::shared_ptr<TaskRunner> task_runner,
+    std::unique_ptr<TaskRunner::Task> on_done)
+    : task_runner_(std::move(task_runner)), on_done_(std::move(on_done)) {}
+
+void BackgroundScriptJob::post(v8::Platform* platform) {
+  posted_ = true;
+  platform->PostTaskOnWorkerThread(v8::TaskPriority::kUserBlocking,
+                                   std::make_unique<WorkerTask>(this));
+}
+
+void BackgroundScriptJob::run() {
+  runOnWorker();
+  if (on_done_) {
+    task_runner_->postTask(std::move(on_done_));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  done_ = true;
+  done_cv_.notify_all();
+}
+
+void BackgroundScriptJob::wait() {
+  if (!posted_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return done_; });
+}
+
+//==============================================================================
+// ScriptStreamingJob
+//==============================================================================
+
+// Hands an in-memory source to V8 a chunk at a time. V8 takes ownership of
+// each chunk, so every chunk is a copy; only one or two are alive at once.
+class ScriptStreamingJob::SourceStream final
+    : public v8::ScriptCompiler::ExternalSourceStream {
+ public:
+  SourceStream(const char* data, size_t length, std::atomic<bool>* cancelled)
+      : data_(data), length_(length), cancelled_(cancelled) {}
+
+  size_t GetMoreData(const uint8_t** src) override {
+    if (offset_ == length_ || cancelled_->load(std::memory_order_relaxed)) {
+      return 0;
+    }
+    size_t size = std::min(kScriptStreamingChunkSize, length_ - offset_);
+    uint8_t* chunk = new uint8_t[size];
+    std::memcpy(chunk, data_ + offset_, size);
+    offset_ += size;
+    *src = chunk;
+    return size;
+  }
+
+ private:
+  const char* data_;
+  size_t length_;
+  size_t offset_ = 0;
+  std::atomic<bool>* cancelled_;
+};
+
+ScriptStreamingJob::ScriptStreamingJob(
+    std::shared_ptr<TaskRunner> task_runner,
+    std::unique_ptr<TaskRunner::Task> on_parsed,
+    const char* data,
+    size_t length,
+    bool is_ascii)
+    : BackgroundScriptJob(std::move(task_runner), std::move(on_parsed)),
+      source_(std::make_unique<SourceStream>(data, length, &cancelled_),
+              is_ascii ? v8::ScriptCompiler::StreamedSource::ONE_BYTE
+                       : v8::ScriptCompiler::StreamedSource::UTF8) {}
+
+std::unique_ptr<ScriptStreamingJob> ScriptStreamingJob::start(
+    v8::Isolate* isolate,
+    v8::Platform* platform,
+    std::shared_ptr<TaskRunner> task_runner,
+    const char* data,
+    size_t length,
+    bool is_ascii,
+    std::unique_ptr<TaskRunner::Task> on_parsed) {
+  if (!platform || !task_runner) {
+    return nullptr;
+  }
+  std::unique_ptr<ScriptStreamingJob> job(new ScriptStreamingJob(
+      std::move(task_runner), std::move(on_parsed), data, length, is_ascii));
+  job->task_.reset(
+      v8::ScriptCompiler::StartStreaming(isolate, &job->source_));
+  if (!job->task_) {
+    return nullptr;
+  }
+  job->post(platform);
+  return job;
+}
+
+ScriptStreamingJob::~ScriptStreamingJob() {
+  wait();
+}
+
+void ScriptStreamingJob::runOnWorker() {
+  task_->Run();
+}
+
+v8::MaybeLocal<v8::Script> ScriptStreamingJob::finish(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::String> source,
+    const v8::ScriptOrigin& origin) {
+  // on_parsed is posted just before the worker signals; this rarely waits.
+  wait();
+  if (cancelled_.load(std::memory_order_relaxed)) {
+    return {};
+  }
+  return v8::ScriptCompiler::Compile(context, &source_, source, origin);
+}
+
+//==============================================================================
+// CodeCacheConsumeJob
+//==============================================================================
+
+CodeCacheConsumeJob::CodeCacheConsumeJob(
+    std::shared_ptr<TaskRunner> task_runner,
+    std::unique_ptr<TaskRunner::Task> on_done,
+    const uint8_t* data,
+    size_t length)
+    : BackgroundScriptJob(std::move(task_runner), std::move(on_done)),
+      data_(data),
+      length_(length) {}
+
+std::unique_ptr<CodeCacheConsumeJob> CodeCacheConsumeJob::start(
+    v8::Isolate* isolate,
+    v8::Platform* platform,
+    std::shared_ptr<TaskRunner> task_runner,
+    const uint8_t* data,
+    size_t length,
+    std::unique_ptr<TaskRunner::Task> on_done) {
+  if (!platform || (on_done && !task_runner)) {
+    return nullptr;
+  }
+  std::unique_ptr<CodeCacheConsumeJob> job(new CodeCacheConsumeJob(
+      std::move(task_runner), std::move(on_done), data, length));
+  // BufferNotOwned: the deserializer reads the caller's bytes in place.
+  job->task_.reset(v8::ScriptCompiler::StartConsumingCodeCache(
+      isolate,
+      std::make_unique<v8::ScriptCompiler::CachedData>(
+          data, static_cast<int>(length))));
+  if (!job->task_) {
+    return nullptr;
+  }
+  job->post(platform);
+  return job;
+}
+
+CodeCacheConsumeJob::~CodeCacheConsumeJob() {
+  wait();
+}
+
+void CodeCacheConsumeJob::runOnWorker() {
+  task_->Run();
+}
+
+v8::MaybeLocal<v8::Script> CodeCacheConsumeJob::finish(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::String> source,
+    const v8::ScriptOrigin& origin,
+    bool* rejected) {
+  wait();
+  v8::Isolate* isolate = context->GetIsolate();
+  // An isolate that already compiled this script keeps it; the deserialized
+  // functions are merged into it rather than creating a second copy.
+  task_->SourceTextAvailable(isolate, source, origin);
+  if (task_->ShouldMergeWithExistingScript()) {
+    task_->MergeWithExistingScript();
+  }
+
+  // The source takes ownership of both; the cached data only records whether
+  // the cache was rejected.
+  v8::ScriptCompiler::Source script_source(
+      source,
+      origin,
+      new v8::ScriptCompiler::CachedData(data_, static_cast<int>(length_)),
+      task_.release());
+  v8::MaybeLocal<v8::Script> script = v8::ScriptCompiler::Compile(
+      context, &script_source, v8::ScriptCompiler::kConsumeCodeCache);
+  *rejected = script_source.GetCachedData()->rejected;
+  return script;
+}
+
+}  // namespace v8rt
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+/// \file v8_script_streaming.h
+/// \brief Off-thread script compilation and code cache deserialization.
+///
+/// ScriptCompiler::Compile parses and compiles a script on the calling thread,
+/// so preparing a multi-megabyte bundle blocks the JS thread for the whole
+/// parse. V8's script streaming API moves that work to a background thread:
+/// ScriptCompiler::StartStreaming returns a ScriptStreamingTask that pulls the
+/// source through an ExternalSourceStream, parses it and compiles the top
+/// level, and only the final Compile(StreamedSource) step, which finalizes the
+/// script on the isolate, runs on the JS thread.
+///
+/// ScriptStreamingJob runs that task on a platform worker thread for a source
+/// that is already in memory, handing it to V8 in chunks, and posts a task to
+/// the runtime's TaskRunner once the parse is done.
+///
+/// CodeCacheConsumeJob does the same for a warm start: consuming a code cache
+/// with kConsumeCodeCache deserializes it on the JS thread, which for a large
+/// bundle takes tens of milliseconds. ScriptCompiler::StartConsumingCodeCache
+/// moves the deserialization to a worker, and Compile with the resulting
+/// ConsumeCodeCacheTask only finalizes it.
+///
+/// Design principles match v8_core.h: pure V8, no C++ exceptions.
+
+#pragma once
+
+#include "v8.h"
+#include "v8_core.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace v8rt {
+
+/// Smaller sources compile on the JS thread faster than a worker thread can
+/// pick them up.
+constexpr size_t kMinStreamedScriptSize = size_t{64} << 10;
+
+/// Sources are handed to V8's scanner in chunks of this many bytes.
+constexpr size_t kScriptStreamingChunkSize = size_t{256} << 10;
+
+/// Work for one script on a platform worker thread. Subclasses call wait() in
+/// their destructors, before the state the worker uses goes away.
+class BackgroundScriptJob {
+ public:
+  BackgroundScriptJob(const BackgroundScriptJob&) = delete;
+  BackgroundScriptJob& operator=(const BackgroundScriptJob&) = delete;
+
+ protected:
+  /// on_done (if not null) is posted to task_runner once the worker is done.
+  BackgroundScriptJob(std::shared_ptr<TaskRunner> task_runner,
+                      std::unique_ptr<TaskRunner::Task> on_done);
+  virtual ~BackgroundScriptJob() = default;
+
+  /// Posts runOnWorker() to one of platform's worker threads.
+  void post(v8::Platform* platform);
+
+  /// Blocks until the worker is done, if post() was called.
+  void wait();
+
+  virtual void runOnWorker() = 0;
+
+ private:
+  class WorkerTask;
+
+  void run();
+
+  std::shared_ptr<TaskRunner> task_runner_;
+  std::unique_ptr<TaskRunner::Task> on_done_;
+  bool posted_ = false;
+  std::mutex mutex_;
+  std::condition_variable done_cv_;
+  bool done_ = false;
+};
+
+/// A script being parsed on a worker thread.
+class ScriptStreamingJob final : public BackgroundScriptJob {
+ public:
+  /// Starts parsing length bytes of UTF-8 at data (read as one-byte data if
+  /// is_ascii) on one of platform's worker threads, and posts on_parsed to
+  /// task_runner when the worker is done with the source, whether or not it
+  /// parsed. data must stay valid until then; the destructor waits for it.
+  ///
+  /// Returns null if V8 cannot stream the script; compile it synchronously
+  /// instead. Call on the JS thread with the isolate entered.
+  static std::unique_ptr<ScriptStreamingJob> start(
+      v8::Isolate* isolate,
+      v8::Platform* platform,
+      std::shared_ptr<TaskRunner> task_runner,
+      const char* data,
+      size_t length,
+      bool is_ascii,
+      std::unique_ptr<TaskRunner::Task> on_parsed);
+
+  /// Waits for the worker, if it is still running.
+  ~ScriptStreamingJob() override;
+
+  /// Makes the worker stop reading the source. It still posts on_parsed, and
+  /// finish() then fails.
+  void cancel() noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+  /// Finalizes the parsed script. source is the same source as a string. Call
+  /// once, on the JS thread, after on_parsed has run.
+  v8::MaybeLocal<v8::Script> finish(v8::Local<v8::Context> context,
+                                    v8::Local<v8::String> source,
+                                    const v8::ScriptOrigin& origin);
+
+ private:
+  class SourceStream;
+
+  ScriptStreamingJob(std::shared_ptr<TaskRunner> task_runner,
+                     std::unique_ptr<TaskRunner::Task> on_parsed,
+                     const char* data,
+                     size_t length,
+                     bool is_ascii);
+
+  void runOnWorker() override;
+
+  std::atomic<bool> cancelled_{false};
+  v8::ScriptCompiler::StreamedSource source_;
+  std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task_;
+};
+
+/// A code cache being deserialized on a worker thread.
+class CodeCacheConsumeJob final : public BackgroundScriptJob {
+ public:
+  /// Starts deserializing the length-byte code cache at data on one of
+  /// platform's worker threads, and posts on_done (if not null) to
+  /// task_runner when it is done. data must stay valid until finish()
+  /// returns or the job is destroyed.
+  ///
+  /// Returns null if V8 does not deserialize off-thread
+  /// (--no-concurrent-cache-deserialization); consume the cache synchronously
+  /// instead. Call on the JS thread with the isolate entered.
+  static std::unique_ptr<CodeCacheConsumeJob> start(
+      v8::Isolate* isolate,
+      v8::Platform* platform,
+      std::shared_ptr<TaskRunner> task_runner,
+      const uint8_t* data,
+      size_t length,
+      std::unique_ptr<TaskRunner::Task> on_done);
+
+  /// Waits for the worker, if it is still running.
+  ~CodeCacheConsumeJob() override;
+
+  /// Compiles the script from the deserialized cache, waiting for the worker
+  /// if it is still running. source and origin are those the cache was
+  /// created for. Sets *rejected if V8 rejected the cache, in which case it
+  /// compiled the source instead. Call once, on the JS thread.
+  v8::MaybeLocal<v8::Script> finish(v8::Local<v8::Context> context,
+                                    v8::Local<v8::String> source,
+                                    const v8::ScriptOrigin& origin,
+                                    bool* rejected);
+
+ private:
+  CodeCacheConsumeJob(std::shared_ptr<TaskRunner> task_runner,
+                      std::unique_ptr<TaskRunner::Task> on_done,
+                      const uint8_t* data,
+                      size_t length);
+
+  void runOnWorker() override;
+
+  const uint8_t* data_;
+  size_t length_;
+  std::unique_ptr<v8::ScriptCompiler::ConsumeCodeCacheTask> task_;
+};
+
+}  // namespace v8rt
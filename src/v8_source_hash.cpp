@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+/// \file v8_source_hash.cpp
+/// \brief Chunked, optionally parallel rapidhash over script sources.
+///
+/// The chunk hash is adapted from rapidhash by Nicolas De Carli
+/// (https://github.com/Nicoshev/rapidhash, BSD 2-Clause License), itself
+/// based on wyhash by Wang Yi, with the default rapidhash secret.
+
+#include "v8_source_hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace v8rt {
+
+namespace {
+
+constexpr uint64_t kSecret[3] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull};
+
+// Kept from the MurmurHash3 call this replaces.
+constexpr uint64_t kSeed = 31;
+
+// Set in a word if any of its bytes is not ASCII.
+constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+inline uint64_t read64(const uint8_t* p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// Replaces a and b with the low and high halves of their 128-bit product.
+inline void mul128(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = static_cast<__uint128_t>(a) * b;
+  a = static_cast<uint64_t>(product);
+  b = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  a = _umul128(a, b, &b);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+  uint64_t high = __umulh(a, b);
+  a *= b;
+  b = high;
+#else
+  uint64_t a_high = a >> 32, a_low = static_cast<uint32_t>(a);
+  uint64_t b_high = b >> 32, b_low = static_cast<uint32_t>(b);
+  uint64_t high = a_high * b_high;
+  uint64_t mid0 = a_high * b_low;
+  uint64_t mid1 = b_high * a_low;
+  uint64_t low = a_low * b_low;
+  high += (mid0 >> 32) + (mid1 >> 32);
+  uint64_t t = low + (mid0 << 32);
+  high += t < low;
+  low = t + (mid1 << 32);
+  high += low < t;
+  a = low;
+  b = high;
+#endif
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+  mul128(a, b);
+  return a ^ b;
+}
+
+// rapidhash of [p, p + length). Every word read is also ORed into seen, and
+// together the reads cover every byte, so (seen & kHighBits) == 0 iff the
+// bytes are ASCII.
+uint64_t hashChunk(const uint8_t* p,
+                   size_t length,
+                   uint64_t seed,
+                   uint64_t& seen) {
+  seed ^= mix(seed ^ kSecret[0], kSecret[1]) ^ length;
+  uint64_t a, b;
+  if (length <= 16) {
+    if (length >= 4) {
+      // First and last four bytes, then the four after/before them (these
+      // may overlap).
+      const uint8_t* last = p + length - 4;
+      const size_t delta = (length & 24) >> (length >> 3);
+      a = (read32(p) << 32) | read32(last);
+      b = (read32(p + delta) << 32) | read32(last - delta);
+    } else if (length > 0) {
+      a = (uint64_t{p[0]} << 56) | (uint64_t{p[length >> 1]} << 32) |
+          p[length - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+    seen |= a | b;
+  } else {
+    size_t remaining = length;
+    if (remaining > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      uint64_t bits = 0;
+      do {
+        uint64_t w0 = read64(p), w1 = read64(p + 8), w2 = read64(p + 16),
+                 w3 = read64(p + 24), w4 = read64(p + 32),
+                 w5 = read64(p + 40);
+        bits |= w0 | w1 | w2 | w3 | w4 | w5;
+        seed = mix(w0 ^ kSecret[0], w1 ^ seed);
+        see1 = mix(w2 ^ kSecret[1], w3 ^ see1);
+        see2 = mix(w4 ^ kSecret[2], w5 ^ see2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining >= 48);
+      seed ^= see1 ^ see2;
+      seen |= bits;
+    }
+    if (remaining > 16) {
+      uint64_t w0 = read64(p), w1 = read64(p + 8);
+      seen |= w0 | w1;
+      seed = mix(w0 ^ kSecret[2], w1 ^ seed ^ kSecret[1]);
+      if (remaining > 32) {
+        uint64_t w2 = read64(p + 16), w3 = read64(p + 24);
+        seen |= w2 | w3;
+        seed = mix(w2 ^ kSecret[2], w3 ^ seed);
+      }
+    }
+    // The last 16 bytes; p - 16 is still inside the source when the block
+    // loop consumed everything.
+    a = read64(p + remaining - 16);
+    b = read64(p + remaining - 8);
+    seen |= a | b;
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  mul128(a, b);
+  return mix(a ^ kSecret[0] ^ length, b ^ kSecret[1]);
+}
+
+// Chunk hashing shared between the calling thread and worker tasks. Each
+// participant claims chunks until none are left, so a task that starts late
+// finds nothing to do and never touches the source.
+class ChunkJob {
+ public:
+  ChunkJob(const uint8_t* data, size_t length, size_t chunks)
+      : data_(data),
+        length_(length),
+        chunks_(chunks),
+        leaves_(new uint64_t[chunks]) {}
+
+  void run() {
+    uint64_t seen = 0;
+    size_t hashed = 0;
+    for (size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) <
+                   chunks_;) {
+      size_t offset = i * kSourceHashChunkSize;
+      leaves_[i] = hashChunk(data_ + offset,
+                             std::min(kSourceHashChunkSize, length_ - offset),
+                             kSeed,
+                             seen);
+      ++hashed;
+    }
+    if (hashed == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    seen_ |= seen;
+    finished_ += hashed;
+    if (finished_ == chunks_) {
+      all_finished_.notify_all();
+    }
+  }
+
+  // Waits for every chunk to be hashed and returns the combined seen mask.
+  uint64_t wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_finished_.wait(lock, [this] { return finished_ == chunks_; });
+    return seen_;
+  }
+
+  const uint64_t* leaves() const { return leaves_.get(); }
+
+ private:
+  const uint8_t* data_;
+  size_t length_;
+  size_t chunks_;
+  std::unique_ptr<uint64_t[]> leaves_;
+  std::atomic<size_t> next_{0};
+  std::mutex mutex_;
+  std::condition_variable all_finished_;
+  size_t finished_ = 0;
+  uint64_t seen_ = 0;
+};
+
+class ChunkTask final : public v8::Task {
+ public:
+  explicit ChunkTask(std::shared_ptr<ChunkJob> job) : job_(std::move(job)) {}
+  void Run() override { job_->run(); }
+
+ private:
+  std::shared_ptr<ChunkJob> job_;
+};
+
+}  // namespace
+
+bool hashSource(const uint8_t* data,
+                size_t length,
+                uint64_t& hash,
+                v8::Platform* platform) {
+  uint64_t seen = 0;
+  if (length <= kSourceHashChunkSize) {
+    hash = hashChunk(data, length, kSeed, seen);
+    return (seen & kHighBits) == 0;
+  }
+
+  size_t chunks = (length + kSourceHashChunkSize - 1) / kSourceHashChunkSize;
+  auto job = std::make_shared<ChunkJob>(data, length, chunks);
+  if (platform && length >= kParallelSourceHashThreshold) {
+    size_t workers = std::min(
+        static_cast<size_t>(std::max(platform->NumberOfWorkerThreads(), 0)),
+        chunks - 1);
+    for (size_t i = 0; i < workers; ++i) {
+      platform->PostTaskOnWorkerThread(v8::TaskPriority::kUserBlocking,
+                                       std::make_unique<ChunkTask>(job));
+    }
+  }
+  job->run();
+  seen = job->wait();
+
+  uint64_t ignored = 0;
+  hash = hashChunk(reinterpret_cast<const uint8_t*>(job->leaves()),
+                   chunks * sizeof(uint64_t),
+                   kSeed ^ length,
+                   ignored);
+  return (seen & kHighBits) == 0;
+}
+
+}  // namespace v8rt
@@ -0,0 +1,415 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+/// \file v8_string.cpp
+/// \brief simdutf-based UTF-8 transcoding for V8 strings.
+
+#include "v8_string.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "simdutf.h"
+
+namespace v8rt {
+
+namespace {
+
+// measureView result for two-byte strings that are not valid UTF-16.
+constexpr size_t kInvalidUtf16 = SIZE_MAX;
+
+// Exact UTF-8 length of the viewed string, or kInvalidUtf16.
+size_t measureView(const v8::String::ValueView& view) noexcept {
+  if (view.is_one_byte()) {
+    return simdutf::utf8_length_from_latin1(
+        reinterpret_cast<const char*>(view.data8()), view.length());
+  }
+  const char16_t* chars = reinterpret_cast<const char16_t*>(view.data16());
+  if (!simdutf::validate_utf16(chars, view.length())) {
+    return kInvalidUtf16;
+  }
+  return simdutf::utf8_length_from_utf16(chars, view.length());
+}
+
+// Writes the viewed string to out, which holds measureView(view) bytes.
+size_t transcodeUtf8(const v8::String::ValueView& view, char* out) noexcept {
+  if (view.is_one_byte()) {
+    return simdutf::convert_latin1_to_utf8(
+        reinterpret_cast<const char*>(view.data8()), view.length(), out);
+  }
+  return simdutf::convert_valid_utf16_to_utf8(
+      reinterpret_cast<const char16_t*>(view.data16()), view.length(), out);
+}
+
+// Writes str with V8's encoder. Truncated output must end on a character
+// boundary, and lone surrogates need replacing; V8 handles both.
+size_t writeUtf8WithV8(v8::Isolate* isolate,
+                       v8::Local<v8::String> str,
+                       char* buffer,
+                       size_t capacity) noexcept {
+  return str->WriteUtf8V2(isolate,
+                          buffer,
+                          capacity,
+                          v8::String::WriteFlags::kReplaceInvalidUtf8);
+}
+
+// An ASCII source wrapped in place. The embedder's bytes stay alive until V8
+// disposes the string.
+class BorrowedOneByteSource final
+    : public v8::String::ExternalOneByteStringResource {
+ public:
+  BorrowedOneByteSource(const char* data,
+                        size_t length,
+                        SourceReleaseCallback release,
+                        void* release_data) noexcept
+      : data_(data),
+        length_(length),
+        release_(release),
+        release_data_(release_data) {}
+
+  ~BorrowedOneByteSource() override {
+    if (release_) {
+      release_(release_data_);
+    }
+  }
+
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  const char* data_;
+  size_t length_;
+  SourceReleaseCallback release_;
+  void* release_data_;
+};
+
+// A source transcoded into an off-heap buffer that the string owns.
+template <typename Resource, typename Char>
+class OwnedSource final : public Resource {
+ public:
+  OwnedSource(std::unique_ptr<Char[]> data, size_t length) noexcept
+      : data_(std::move(data)), length_(length) {}
+
+  const Char* data() const override { return data_.get(); }
+  size_t length() const override { return length_; }
+
+ private:
+  std::unique_ptr<Char[]> data_;
+  size_t length_;
+};
+
+using OwnedLatin1Source =
+    OwnedSource<v8::String::ExternalOneByteStringResource, char>;
+using OwnedUtf16Source =
+    OwnedSource<v8::String::ExternalStringResource, uint16_t>;
+
+// Transcodes valid UTF-8 into an external Latin-1 or UTF-16 string. Returns
+// an empty handle if utf8 is not valid UTF-8 or V8 rejects the string.
+v8::MaybeLocal<v8::String> newTranscodedSourceString(v8::Isolate* isolate,
+                                                     const char* utf8,
+                                                     size_t length) {
+  if (!simdutf::validate_utf8(utf8, length)) {
+    return {};
+  }
+
+  size_t latin1_length = simdutf::latin1_length_from_utf8(utf8, length);
+  auto latin1 = std::make_unique<char[]>(latin1_length);
+  if (simdutf::convert_utf8_to_latin1(utf8, length, latin1.get()) ==
+      latin1_length) {
+    return v8::String::NewExternalOneByte(
+        isolate, new OwnedLatin1Source(std::move(latin1), latin1_length));
+  }
+  latin1.reset();
+
+  size_t utf16_length = simdutf::utf16_length_from_utf8(utf8, length);
+  auto utf16 = std::make_unique<uint16_t[]>(utf16_length);
+  simdutf::convert_valid_utf8_to_utf16(
+      utf8, length, reinterpret_cast<char16_t*>(utf16.get()));
+  return v8::String::NewExternalTwoByte(
+      isolate, new OwnedUtf16Source(std::move(utf16), utf16_length));
+}
+
+}  // namespace
+
+Utf8Size measureUtf8(v8::Isolate* isolate,
+                     v8::Local<v8::String> str) noexcept {
+  {
+    v8::String::ValueView view(isolate, str);
+    size_t length = measureView(view);
+    if (length != kInvalidUtf16) {
+      return {length, true};
+    }
+  }
+  return {str->Utf8LengthV2(isolate), false};
+}
+
+size_t utf8Length(v8::Isolate* isolate, v8::Local<v8::String> str) noexcept {
+  return measureUtf8(isolate, str).length;
+}
+
+size_t writeUtf8(v8::Isolate* isolate,
+                 v8::Local<v8::String> str,
+                 char* buffer,
+                 size_t capacity) noexcept {
+  {
+    v8::String::ValueView view(isolate, str);
+    size_t chars = view.length();
+    if (view.is_one_byte() && chars <= capacity / 2) {
+      return simdutf::convert_latin1_to_utf8(
+          reinterpret_cast<const char*>(view.data8()), chars, buffer);
+    }
+    if (!view.is_one_byte() && chars <= capacity / 3) {
+      // Validates as it converts; 0 means lone surrogates.
+      size_t written = simdutf::convert_utf16_to_utf8(
+          reinterpret_cast<const char16_t*>(view.data16()), chars, buffer);
+      if (written != 0 || chars == 0) {
+        return written;
+      }
+    } else {
+      size_t length = measureView(view);
+      if (length != kInvalidUtf16 && length <= capacity) {
+        return transcodeUtf8(view, buffer);
+      }
+    }
+  }
+  return writeUtf8WithV8(isolate, str, buffer, capacity);
+}
+
+size_t writeUtf8(v8::Isolate* isolate,
+                 v8::Local<v8::String> str,
+                 char* buffer,
+                 size_t capacity,
+                 const Utf8Size& size) noexcept {
+  if (size.wellFormed && size.length <= capacity) {
+    v8::String::ValueView view(isolate, str);
+    return transcodeUtf8(view, buffer);
+  }
+  return writeUtf8WithV8(isolate, str, buffer, capacity);
+}
+
+std::string toUtf8String(v8::Isolate* isolate, v8::Local<v8::String> str) {
+  std::string result;
+  {
+    v8::String::ValueView view(isolate, str);
+    size_t length = measureView(view);
+    if (length != kInvalidUtf16) {
+      result.resize(length);
+      transcodeUtf8(view, result.data());
+      return result;
+    }
+  }
+  result.resize(str->Utf8LengthV2(isolate));
+  result.resize(str->WriteUtf8V2(isolate,
+                                 result.data(),
+                                 result.size(),
+                                 v8::String::WriteFlags::kReplaceInvalidUtf8));
+  return result;
+}
+
+v8::MaybeLocal<v8::String> newStringFromUtf8(v8::Isolate* isolate,
+                                             const char* data,
+                                             size_t length,
+                                             v8::NewStringType type) noexcept {
+  if (length > static_cast<size_t>(INT_MAX)) {
+    return {};
+  }
+  if (simdutf::validate_ascii(data, length)) {
+    return v8::String::NewFromOneByte(isolate,
+                                      reinterpret_cast<const uint8_t*>(data),
+                                      type,
+                                      static_cast<int>(length));
+  }
+  return v8::String::NewFromUtf8(
+      isolate, data, type, static_cast<int>(length));
+}
+
+bool isAscii(const char* data, size_t length) noexcept {
+  return simdutf::validate_ascii(data, length);
+}
+
+v8::MaybeLocal<v8::String> newExternalSourceString(
+    v8::Isolate* isolate,
+    const char* utf8,
+    size_t length,
+    SourceReleaseCallback release,
+    void* release_data,
+    std::optional<bool> is_ascii) noexcept {
+  if (length > 0 && (is_ascii.has_value()
+                         ? *is_ascii
+                         : simdutf::validate_ascii(utf8, length))) {
+    // V8 disposes the resource (and so releases the bytes) even if it
+    // rejects the string.
+    return v8::String::NewExternalOneByte(
+        isolate,
+        new BorrowedOneByteSource(utf8, length, release, release_data));
+  }
+
+  v8::MaybeLocal<v8::String> result;
+  if (length > 0) {
+    result = newTranscodedSourceString(isolate, utf8, length);
+  }
+  if (result.IsEmpty() && length <= static_cast<size_t>(INT_MAX)) {
+    result = v8::String::NewFromUtf8(
+        isolate, utf8, v8::NewStringType::kNormal, static_cast<int>(length));
+  }
+  if (release) {
+    release(release_data);
+  }
+  return result;
+}
+
+void ReloadedSources::parkAll() noexcept {
+  std::vector<ReloadableSource*> sources;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources.swap(sources_);
+  }
+  // Sources are destroyed on the JS thread too, so none goes away while it is
+  // parked here. A locked one is added back for the next call.
+  std::vector<ReloadableSource*> locked;
+  for (ReloadableSource* source : sources) {
+    if (!source->park()) {
+      locked.push_back(source);
+    }
+  }
+  if (!locked.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.insert(sources_.end(), locked.begin(), locked.end());
+  }
+}
+
+size_t ReloadedSources::size() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sources_.size();
+}
+
+void ReloadedSources::add(ReloadableSource* source) noexcept {
+  bool first;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    first = sources_.empty();
+    sources_.push_back(source);
+  }
+  if (first && schedule_) {
+    schedule_(schedule_data_);
+  }
+}
+
+void ReloadedSources::remove(ReloadableSource* source) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sources_.erase(std::remove(sources_.begin(), sources_.end(), source),
+                 sources_.end());
+}
+
+ReloadableSource::ReloadableSource(
+    const char* data,
+    size_t length,
+    SourceReleaseCallback release,
+    void* release_data,
+    std::unique_ptr<SourceLoader> loader,
+    ReloadedSources* reloaded) noexcept
+    : data_(data),
+      length_(length),
+      release_(release),
+      release_data_(release_data),
+      loader_(std::move(loader)),
+      reloaded_sources_(reloaded) {}
+
+ReloadableSource::~ReloadableSource() {
+  if (reloaded_sources_) {
+    reloaded_sources_->remove(this);
+  }
+  if (data_.load(std::memory_order_relaxed)) {
+    releaseBytes();
+  }
+}
+
+const char* ReloadableSource::data() const {
+  if (const char* data = data_.load(std::memory_order_acquire)) {
+    return data;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (const char* data = data_.load(std::memory_order_relaxed)) {
+    return data;
+  }
+  const char* data = loader_ ? loader_->load(length_) : nullptr;
+  if (data) {
+    reloaded_ = true;
+  } else {
+    blanks_ = std::make_unique<char[]>(length_);
+    std::memset(blanks_.get(), ' ', length_);
+    data = blanks_.get();
+  }
+  data_.store(data, std::memory_order_release);
+  if (reloaded_sources_) {
+    reloaded_sources_->add(const_cast<ReloadableSource*>(this));
+  }
+  return data;
+}
+
+void ReloadableSource::Lock() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++locks_;
+}
+
+void ReloadableSource::Unlock() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --locks_;
+}
+
+bool ReloadableSource::park() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (locks_ > 0) {
+    return false;
+  }
+  if (data_.load(std::memory_order_relaxed)) {
+    data_.store(nullptr, std::memory_order_relaxed);
+    releaseBytes();
+  }
+  return true;
+}
+
+void ReloadableSource::releaseBytes() const noexcept {
+  if (blanks_) {
+    blanks_.reset();
+  } else if (reloaded_) {
+    loader_->unload();
+    reloaded_ = false;
+  } else if (release_) {
+    release_(release_data_);
+    release_ = nullptr;
+  }
+}
+
+v8::MaybeLocal<v8::String> newReloadableSourceString(
+    v8::Isolate* isolate,
+    const char* utf8,
+    size_t length,
+    SourceReleaseCallback release,
+    void* release_data,
+    std::unique_ptr<SourceLoader> loader,
+    ReloadableSource** resource,
+    ReloadedSources* reloaded,
+    std::optional<bool> is_ascii) noexcept {
+  *resource = nullptr;
+  if (length == 0 || !(is_ascii.has_value()
+                           ? *is_ascii
+                           : simdutf::validate_ascii(utf8, length))) {
+    return newExternalSourceString(
+        isolate, utf8, length, release, release_data, false);
+  }
+  auto* source = new ReloadableSource(
+      utf8, length, release, release_data, std::move(loader), reloaded);
+  // As with BorrowedOneByteSource, V8 disposes a rejected resource.
+  v8::MaybeLocal<v8::String> result =
+      v8::String::NewExternalOneByte(isolate, source);
+  if (!result.IsEmpty()) {
+    *resource = source;
+  }
+  return result;
+}
+
+}  // namespace v8rt
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+/// \file v8_string.h
+/// \brief Shared UTF-8 transcoding for V8 strings.
+///
+/// Used by every string conversion in v8jsi.dll:
+/// - jsi_abi_v8.cpp and V8DirectRuntime.cpp (JSI)
+/// - js_native_api_v8.cc (Node-API)
+/// - V8JsiRuntime.cpp (legacy runtime)
+///
+/// V8's own Utf8LengthV2 + WriteUtf8V2 walk the string twice with scalar code.
+/// These helpers read the flat one-byte or two-byte storage once through
+/// v8::String::ValueView and transcode it with simdutf, so the exact UTF-8
+/// length comes from a vectorized pass and the output buffer is sized once.
+/// Strings with lone surrogates (not valid UTF-16) fall back to V8, which
+/// replaces them with U+FFFD.
+///
+/// newExternalSourceString applies the same idea to script sources, so that
+/// multi-megabyte bundles stay off the V8 heap whatever their encoding.
+/// newReloadableSourceString goes further for sources the embedder can load
+/// again: once the script is compiled the runtime drops the bytes, and V8
+/// only brings them back if it reads the source again (lazy compilation of a
+/// function the code cache does not cover, Function.prototype.toString, the
+/// debugger).
+///
+/// Design principles match v8_core.h: pure V8, no C++ exceptions. Callers hold
+/// the isolate and an open HandleScope.
+
+#pragma once
+
+#include "v8.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace v8rt {
+
+/// Size of the UTF-8 encoding of a string, as found by measureUtf8.
+struct Utf8Size {
+  /// Number of bytes in the UTF-8 encoding.
+  size_t length{0};
+  /// False for strings with lone surrogates, which writeUtf8 leaves to V8.
+  bool wellFormed{false};
+};
+
+/// Measures the UTF-8 encoding of str. A caller that sizes a buffer by the
+/// result passes it on to writeUtf8, which then transcodes without measuring
+/// the string again.
+Utf8Size measureUtf8(v8::Isolate* isolate,
+                     v8::Local<v8::String> str) noexcept;
+
+/// Number of bytes in the UTF-8 encoding of str.
+size_t utf8Length(v8::Isolate* isolate, v8::Local<v8::String> str) noexcept;
+
+/// Writes str as UTF-8 to buffer without a terminator and returns the number
+/// of bytes written. If the whole string does not fit in capacity bytes, writes
+/// as many complete characters as fit. Lone surrogates become U+FFFD.
+///
+/// A buffer with room for the longest possible encoding (two bytes per
+/// character of a one-byte string, three per UTF-16 code unit) is filled in a
+/// single pass; a smaller one needs the string measured first.
+size_t writeUtf8(v8::Isolate* isolate,
+                 v8::Local<v8::String> str,
+                 char* buffer,
+                 size_t capacity) noexcept;
+
+/// Like writeUtf8, for a str that measureUtf8 returned size for.
+size_t writeUtf8(v8::Isolate* isolate,
+                 v8::Local<v8::String> str,
+                 char* buffer,
+                 size_t capacity,
+                 const Utf8Size& size) noexcept;
+
+/// str as a UTF-8 std::string, allocated once at its exact length.
+std::string toUtf8String(v8::Isolate* isolate, v8::Local<v8::String> str);
+
+/// Creates a string from UTF-8. ASCII input is copied in as one-byte data,
+/// skipping V8's UTF-8 decoder.
+v8::MaybeLocal<v8::String> newStringFromUtf8(
+    v8::Isolate* isolate,
+    const char* data,
+    size_t length,
+    v8::NewStringType type = v8::NewStringType::kNormal) noexcept;
+
+/// Whether the length bytes at data are all ASCII (vectorized).
+bool isAscii(const char* data, size_t length) noexcept;
+
+/// Releases the bytes handed to newExternalSourceString.
+typedef void (*SourceReleaseCallback)(void* release_data);
+
+/// Creates the string for a UTF-8 script source without putting the source on
+/// the V8 heap. ASCII sources are wrapped in place as external one-byte
+/// strings. Other valid UTF-8 is transcoded once into an off-heap buffer owned
+/// by an external string: Latin-1 when every character fits, UTF-16
+/// otherwise. Invalid UTF-8 goes through V8's decoder, like NewFromUtf8.
+///
+/// release (if not null) runs exactly once: when the string is collected if
+/// it wraps utf8 in place, otherwise before this function returns.
+///
+/// is_ascii lets a caller that has already scanned the source (see
+/// hashSource) skip the ASCII check.
+v8::MaybeLocal<v8::String> newExternalSourceString(
+    v8::Isolate* isolate,
+    const char* utf8,
+    size_t length,
+    SourceReleaseCallback release,
+    void* release_data,
+    std::optional<bool> is_ascii = std::nullopt) noexcept;
+
+/// Loads a script source again after ReloadableSource::park dropped it.
+class SourceLoader {
+ public:
+  virtual ~SourceLoader() = default;
+
+  /// Returns the length bytes of the source, which must be the bytes it was
+  /// compiled from, or null if they cannot be loaded. They stay valid until
+  /// unload(). May run on a V8 worker thread.
+  virtual const char* load(size_t length) noexcept = 0;
+
+  /// Releases the bytes returned by load().
+  virtual void unload() noexcept = 0;
+};
+
+class ReloadableSource;
+
+/// The ReloadableSources of one runtime whose bytes were loaded again since
+/// they were last parked. The runtime parks them again once V8 no longer
+/// needs them, so that a source read once more does not stay resident.
+class ReloadedSources {
+ public:
+  /// Runs, on the thread that loaded the bytes, when a source is added to an
+  /// empty set. The runtime schedules parkAll() from it.
+  typedef void (*ScheduleCallback)(void* data);
+
+  ReloadedSources(ScheduleCallback schedule, void* schedule_data) noexcept
+      : schedule_(schedule), schedule_data_(schedule_data) {}
+
+  /// Parks the sources added since the last call. Sources V8 still holds a
+  /// lock on stay in the set. Call on the JS thread between V8 calls.
+  void parkAll() noexcept;
+
+  /// Number of sources waiting to be parked.
+  size_t size() const noexcept;
+
+ private:
+  friend class ReloadableSource;
+  void add(ReloadableSource* source) noexcept;
+  void remove(ReloadableSource* source) noexcept;
+
+  mutable std::mutex mutex_;
+  std::vector<ReloadableSource*> sources_;
+  ScheduleCallback schedule_;
+  void* schedule_data_;
+};
+
+/// An ASCII source wrapped in place that can drop its bytes and load them
+/// again on demand. V8 does not cache data() for it, and locks it around
+/// uses of the bytes that outlast a data() call.
+class ReloadableSource final
+    : public v8::String::ExternalOneByteStringResource {
+ public:
+  ReloadableSource(const char* data,
+                   size_t length,
+                   SourceReleaseCallback release,
+                   void* release_data,
+                   std::unique_ptr<SourceLoader> loader,
+                   ReloadedSources* reloaded = nullptr) noexcept;
+  ~ReloadableSource() override;
+
+  /// Loads the bytes if they were dropped, and adds the source to the
+  /// ReloadedSources it was created with. V8 cannot handle a missing source,
+  /// so if the loader fails this returns blanks of the same length instead:
+  /// code compiled from them throws a SyntaxError. The next park() drops the
+  /// blanks, and the loader is tried again.
+  const char* data() const override;
+  size_t length() const override { return length_; }
+  bool IsCacheable() const override { return false; }
+  void Lock() const override;
+  void Unlock() const override;
+
+  /// Drops the bytes unless V8 holds a lock on them; returns false if it
+  /// does. Call on the JS thread between V8 calls, once the script that reads
+  /// the source is compiled.
+  bool park() noexcept;
+
+ private:
+  void releaseBytes() const noexcept;
+
+  mutable std::mutex mutex_;
+  mutable std::atomic<const char*> data_;
+  size_t length_;
+  // The bytes the string was created with, until they are first dropped.
+  mutable SourceReleaseCallback release_;
+  void* release_data_;
+  std::unique_ptr<SourceLoader> loader_;
+  // True while data_ came from loader_.
+  mutable bool reloaded_{false};
+  // Stands in for the bytes while the loader fails.
+  mutable std::unique_ptr<char[]> blanks_;
+  ReloadedSources* reloaded_sources_;
+  mutable int locks_{0};
+};
+
+/// Like newExternalSourceString, but an ASCII source is wrapped in a
+/// ReloadableSource, set in *resource, that the caller parks once it has
+/// compiled the script. Other sources are transcoded as usual, *resource is
+/// null and loader is dropped. reloaded (if not null) must outlive the
+/// string.
+v8::MaybeLocal<v8::String> newReloadableSourceString(
+    v8::Isolate* isolate,
+    const char* utf8,
+    size_t length,
+    SourceReleaseCallback release,
+    void* release_data,
+    std::unique_ptr<SourceLoader> loader,
+    ReloadableSource** resource,
+    ReloadedSources* reloaded = nullptr,
+    std::optional<bool> is_ascii = std::nullopt) noexcept;
+
+}  // namespace v8rt
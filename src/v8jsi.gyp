@@ -54,17 +54,25 @@
     'v8jsi_core_sources': [
       '<(v8jsi_root)/src/v8_core.h',
       '<(v8jsi_root)/src/v8_core.cpp',
+      '<(v8jsi_root)/src/v8_source_hash.h',
+      '<(v8jsi_root)/src/v8_source_hash.cpp',
+      '<(v8jsi_root)/src/v8_script_streaming.h',
+      '<(v8jsi_root)/src/v8_script_streaming.cpp',
+      '<(v8jsi_root)/src/v8_string.h',
+      '<(v8jsi_root)/src/v8_string.cpp',
     ],
 
     # Core v8jsi sources. Now there is no legacy V8Runtime class — only
-    # JSI core, V8 instrumentation, MurmurHash, and the public C++ headers
-    # consumers depend on.
+    # JSI core, V8 instrumentation, the opt-in direct runtime
+    # (a C++ jsi::Runtime, so it lives here rather than with the
+    # exception-free ABI sources), and the public C++ headers consumers
+    # depend on.
     'v8jsi_sources': [
       '<(v8jsi_root)/src/v8jsi.cpp',
-      '<(v8jsi_root)/src/MurmurHash.cpp',
-      '<(v8jsi_root)/src/MurmurHash.h',
       '<(v8jsi_root)/src/V8Instrumentation.cpp',
       '<(v8jsi_root)/src/V8Instrumentation.h',
+      '<(v8jsi_root)/src/jsi_abi/V8DirectRuntime.cpp',
+      '<(v8jsi_root)/src/jsi_abi/V8DirectRuntime.h',
       '<(v8jsi_root)/src/jsi/JSIDynamic.h',
       '<(v8jsi_root)/src/jsi/decorator.h',
       '<(v8jsi_root)/src/jsi/instrumentation.h',
@@ -73,6 +81,7 @@
       '<(v8jsi_root)/src/jsi/jsi.h',
       '<(v8jsi_root)/src/jsi/jsilib.h',
       '<(v8jsi_root)/src/jsi/threadsafe.h',
+      '<(v8jsi_root)/src/public/FileScriptStore.h',
       '<(v8jsi_root)/src/public/ScriptStore.h',
       '<(v8jsi_root)/src/public/V8JsiRuntime.h',
     ],
@@ -84,6 +93,18 @@
     # with the default no-exception flags would require solving MSVC DLL
     # symbol export issues (/WHOLEARCHIVE or explicit forwarding).
     'v8jsi_abi_sources': [
+      '<(v8jsi_root)/src/jsi_abi/AbiRuntimeArgs.h',
+      '<(v8jsi_root)/src/jsi_abi/AbiRuntimeInterfaces.h',
+      '<(v8jsi_root)/src/jsi_abi/AsyncPrepareRuntime.h',
+      '<(v8jsi_root)/src/jsi_abi/CompiledScriptCache.h',
+      '<(v8jsi_root)/src/jsi_abi/ExternalMemoryTable.h',
+      '<(v8jsi_root)/src/jsi_abi/IndexedHostObject.h',
+      '<(v8jsi_root)/src/jsi_abi/PreparedCall.h',
+      '<(v8jsi_root)/src/jsi_abi/PropNameInternTable.h',
+      '<(v8jsi_root)/src/jsi_abi/ScriptStoreRuntime.h',
+      '<(v8jsi_root)/src/jsi_abi/SourceHashCache.h',
+      '<(v8jsi_root)/src/jsi_abi/StartupCompleteRuntime.h',
+      '<(v8jsi_root)/src/jsi_abi/StringDataView.h',
       '<(v8jsi_root)/src/jsi_abi/jsi_abi.h',
       '<(v8jsi_root)/src/jsi_abi/jsi_abi_helpers.h',
       '<(v8jsi_root)/src/jsi_abi/jsi_abi_v8.cpp',
@@ -205,6 +226,9 @@
         # Use --without-intl to reduce size from ~69MB to ~33MB
         'tools/v8_gypfiles/v8.gyp:v8_snapshot',
         'tools/v8_gypfiles/v8.gyp:v8_libplatform',
+        # simdutf (vendored with V8) backs the shared string transcoding in
+        # v8_string.cpp.
+        'tools/v8_gypfiles/v8.gyp:simdutf',
         # Generate version_gen.rc before building
         'v8jsi_version_gen',
         # Generate the SourceLink map before linking (feeds /SOURCELINK:).
@@ -377,12 +401,22 @@
         # JSI ABI runtime wrapper for tests
         '<(v8jsi_root)/src/jsi_abi/JsiAbiRuntime.h',
         '<(v8jsi_root)/src/jsi_abi/JsiAbiRuntime.cpp',
+        '<(v8jsi_root)/src/jsi_abi/AbiRuntimeArgs.h',
+        '<(v8jsi_root)/src/jsi_abi/AbiRuntimeInterfaces.h',
+        '<(v8jsi_root)/src/jsi_abi/AsyncPrepareRuntime.h',
+        '<(v8jsi_root)/src/jsi_abi/IndexedHostObject.h',
+        '<(v8jsi_root)/src/jsi_abi/PreparedCall.h',
+        '<(v8jsi_root)/src/jsi_abi/ScriptStoreRuntime.h',
+        '<(v8jsi_root)/src/jsi_abi/StartupCompleteRuntime.h',
+        '<(v8jsi_root)/src/jsi_abi/V8DirectRuntime.h',
         '<(v8jsi_root)/src/jsi_abi/jsi_abi.h',
         '<(v8jsi_root)/src/jsi_abi/jsi_abi_helpers.h',
         '<(v8jsi_root)/src/jsi_abi/v8_jsi_config.h',
         # Consumer-side definition of makeV8Runtime. Ships as source in
         # the NuGet; compiled here to prove the round-trip works end-to-end.
         '<(v8jsi_root)/src/public/V8JsiRuntime.cpp',
+        # Consumer-side file-backed script store, also shipped as source.
+        '<(v8jsi_root)/src/public/FileScriptStore.cpp',
       ],
 
       'conditions': [